@@ -31,6 +31,54 @@ function(compile_shaders TARGET_NAME)
   set(compile_shaders_RETURN ${SHADER_TARGETS} PARENT_SCOPE)
 endfunction()
 
+function(encode_textures TARGET_NAME)
+  set(TEXTURE_SOURCE_FILES ${ARGN})
+  set(TEXTURE_TARGETS)
+
+  foreach(TEXTURE_SOURCE IN LISTS TEXTURE_SOURCE_FILES)
+    cmake_path(ABSOLUTE_PATH TEXTURE_SOURCE NORMALIZE)
+    cmake_path(GET TEXTURE_SOURCE STEM TEXTURE_STEM)
+    foreach(TEXTURE_FORMAT IN ITEMS bc7 bc1)
+      set(TEXTURE_NAME "${TEXTURE_STEM}_${TEXTURE_FORMAT}_ktx2")
+      set(OUTPUT_DIR "${CMAKE_CURRENT_BINARY_DIR}/CMakeFiles/${TEXTURE_NAME}.dir")
+      set(OUTPUT_FILENAME "${OUTPUT_DIR}/${TEXTURE_STEM}.${TEXTURE_FORMAT}.ktx2")
+      add_custom_command(
+          OUTPUT ${OUTPUT_FILENAME}
+          COMMAND texture_encoder "${TEXTURE_SOURCE}" "${OUTPUT_FILENAME}" ${TEXTURE_FORMAT}
+          DEPENDS ${TEXTURE_SOURCE} texture_encoder
+      )
+      add_custom_target(
+          ${TEXTURE_NAME} ALL
+          DEPENDS ${OUTPUT_FILENAME}
+      )
+      set_target_properties(${TEXTURE_NAME} PROPERTIES OUTPUT_NAME ${OUTPUT_FILENAME})
+      list(APPEND TEXTURE_TARGETS ${TEXTURE_NAME})
+    endforeach()
+  endforeach()
+  set(encode_textures_RETURN ${TEXTURE_TARGETS} PARENT_SCOPE)
+endfunction()
+
+function(pack_assets TARGET_NAME)
+  set(INPUT_TARGETS ${ARGN})
+  set(INPUT_FILES)
+  foreach(SOURCE_TARGET IN LISTS INPUT_TARGETS)
+    get_target_property(SOURCE_TARGET_LOCATION ${SOURCE_TARGET} OUTPUT_NAME)
+    list(APPEND INPUT_FILES ${SOURCE_TARGET_LOCATION})
+  endforeach()
+  set(OUTPUT_DIR "${CMAKE_CURRENT_BINARY_DIR}/CMakeFiles/${TARGET_NAME}.dir")
+  set(OUTPUT_FILENAME "${OUTPUT_DIR}/${TARGET_NAME}.pack")
+  add_custom_command(
+      OUTPUT ${OUTPUT_FILENAME}
+      COMMAND asset_packer "${OUTPUT_FILENAME}" ${INPUT_FILES}
+      DEPENDS ${INPUT_FILES} ${INPUT_TARGETS} asset_packer
+  )
+  add_custom_target(
+      ${TARGET_NAME} ALL
+      DEPENDS ${OUTPUT_FILENAME}
+  )
+  set_target_properties(${TARGET_NAME} PROPERTIES OUTPUT_NAME ${OUTPUT_FILENAME})
+endfunction()
+
 function(binary_files_to_object_files TARGET_NAME)
   set(INPUT_TARGETS ${ARGN})
   set(PREPARE_TARGETS)
@@ -61,6 +109,35 @@ function(binary_files_to_object_files TARGET_NAME)
   set(binary_files_to_object_files_RETURN ${PREPARE_TARGETS} PARENT_SCOPE)
 endfunction()
 
+function(embed_registry TARGET_NAME)
+  set(INPUT_TARGETS ${ARGN})
+  set(REGISTRY_ENTRIES)
+  set(INPUT_FILES)
+  foreach(SOURCE_TARGET IN LISTS INPUT_TARGETS)
+    get_target_property(SOURCE_TARGET_LOCATION ${SOURCE_TARGET} OUTPUT_NAME)
+    list(APPEND REGISTRY_ENTRIES "${SOURCE_TARGET}=${SOURCE_TARGET_LOCATION}")
+    list(APPEND INPUT_FILES ${SOURCE_TARGET_LOCATION})
+  endforeach()
+  string(REPLACE ";" "|" REGISTRY_ENTRIES "${REGISTRY_ENTRIES}")
+  set(OUTPUT_DIR "${CMAKE_CURRENT_BINARY_DIR}/generated")
+  set(OUTPUT_FILENAME "${OUTPUT_DIR}/${TARGET_NAME}.hpp")
+  add_custom_command(
+      OUTPUT ${OUTPUT_FILENAME}
+      COMMAND ${CMAKE_COMMAND}
+          "-DREGISTRY_ENTRIES=${REGISTRY_ENTRIES}"
+          "-DREGISTRY_OUTPUT=${OUTPUT_FILENAME}"
+          -P "${CMAKE_CURRENT_SOURCE_DIR}/cmake/embed_registry.cmake"
+      DEPENDS ${INPUT_FILES} ${INPUT_TARGETS}
+          "${CMAKE_CURRENT_SOURCE_DIR}/cmake/embed_registry.cmake"
+      VERBATIM
+  )
+  add_custom_target(
+      ${TARGET_NAME} ALL
+      DEPENDS ${OUTPUT_FILENAME}
+  )
+  set(embed_registry_RETURN ${OUTPUT_DIR} PARENT_SCOPE)
+endfunction()
+
 function (cmake_print_all_variables)
     get_cmake_property(_variableNames VARIABLES)
     list (SORT _variableNames)
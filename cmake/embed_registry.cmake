@@ -0,0 +1,41 @@
+# Writes a header declaring the embedded resource symbols and a constexpr
+# ResourceRegistry over them. Run in script mode with REGISTRY_OUTPUT and
+# REGISTRY_ENTRIES, a "|" separated list of <symbol base>=<file> pairs.
+string(REPLACE "|" ";" REGISTRY_ENTRIES "${REGISTRY_ENTRIES}")
+set(DECLARATIONS "")
+set(RESOURCES "")
+set(RESOURCE_COUNT 0)
+foreach(ENTRY IN LISTS REGISTRY_ENTRIES)
+  string(FIND "${ENTRY}" "=" SEPARATOR)
+  string(SUBSTRING "${ENTRY}" 0 ${SEPARATOR} SYMBOL_BASE)
+  math(EXPR PATH_START "${SEPARATOR} + 1")
+  string(SUBSTRING "${ENTRY}" ${PATH_START} -1 RESOURCE_PATH)
+  cmake_path(GET RESOURCE_PATH FILENAME RESOURCE_NAME)
+  cmake_path(GET RESOURCE_PATH EXTENSION LAST_ONLY RESOURCE_EXTENSION)
+  file(SIZE "${RESOURCE_PATH}" RESOURCE_SIZE)
+  if (RESOURCE_EXTENSION STREQUAL ".spv")
+    set(ELEMENT_TYPE "uint32_t")
+  else()
+    set(ELEMENT_TYPE "std::byte")
+  endif()
+  string(APPEND DECLARATIONS
+      "extern const ${ELEMENT_TYPE} data_start_${SYMBOL_BASE}[];\n")
+  string(APPEND RESOURCES
+      "        { \"${RESOURCE_NAME}\", data_start_${SYMBOL_BASE}, ${RESOURCE_SIZE} },\n")
+  math(EXPR RESOURCE_COUNT "${RESOURCE_COUNT} + 1")
+endforeach()
+file(WRITE "${REGISTRY_OUTPUT}"
+"// Generated by cmake/embed_registry.cmake, do not edit.
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+#include \"resource_registry.hpp\"
+
+${DECLARATIONS}
+inline constexpr ResourceRegistry<${RESOURCE_COUNT}> embeddedResources(
+    std::array<EmbeddedResource, ${RESOURCE_COUNT}>{ {
+${RESOURCES}    } });
+")
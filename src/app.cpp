@@ -14,8 +14,31 @@
 #define GLM_ENABLE_EXPERIMENTAL
 #include "glm/gtx/string_cast.hpp"
 #include "glm/trigonometric.hpp"
+#include "vulkan_app/app/antialiasing.hpp"
+#include "vulkan_app/app/bindless_textures.hpp"
+#include "vulkan_app/app/bounds.hpp"
+#include "vulkan_app/app/bvh.hpp"
+#include "vulkan_app/app/cache_files.hpp"
 #include "vulkan_app/app/data_aggregator.hpp"
+#include "vulkan_app/app/depth_pyramid.hpp"
+#include "vulkan_app/app/descriptor_allocator.hpp"
+#include "vulkan_app/app/descriptor_layout_cache.hpp"
+#include "vulkan_app/app/frame_arena.hpp"
+#include "vulkan_app/app/frame_descriptors.hpp"
 #include "vulkan_app/app/frame_state.hpp"
+#include "vulkan_app/app/frustum_culler.hpp"
+#include "vulkan_app/app/gpu_frame_timer.hpp"
+#include "vulkan_app/app/occlusion_culler.hpp"
+#include "vulkan_app/app/picking.hpp"
+#include "vulkan_app/app/pipeline_description.hpp"
+#include "vulkan_app/app/pipeline_variants.hpp"
+#include "vulkan_app/app/render_queue.hpp"
+#include "vulkan_app/app/resolution_controller.hpp"
+#include "vulkan_app/app/spatial_upscaler.hpp"
+#include "vulkan_app/app/spirv_reflection.hpp"
+#include "vulkan_app/app/texture_cache.hpp"
+#include "vulkan_app/app/texture_streamer.hpp"
+#include "vulkan_app/app/thread_pool.hpp"
 
 // clang-format off
 #define ELPP_STL_LOGGING
@@ -27,7 +50,9 @@
 #include <algorithm>
 #include <array>
 #include <cstddef>
+#include <cstdint>
 #include <cstring>
+#include <exception>
 #include <format>
 #include <ranges>
 #include <string>
@@ -35,25 +60,29 @@
 #include <utility>
 #include <vector>
 
+#include "./assets.hpp"
 #include "./glfw_controller.hpp"
+#include "./shaders.hpp"
 #include "magic_enum.hpp"
 #include "vulkan_app/app/create_buffers.hpp"
 #include "vulkan_app/app/create_funcs.hpp"
 #include "vulkan_app/app/create_pipeline.hpp"
 #include "vulkan_app/app/draw_frame.hpp"
+#include "vulkan_app/app/uniform_buffer_object.hpp"
 #include "vulkan_app/app/vertex.hpp"
 #include "vulkan_app/vki/buffer.hpp"
 #include "vulkan_app/vki/command_pool.hpp"
 #include "vulkan_app/vki/fence.hpp"
-#include "vulkan_app/vki/framebuffer.hpp"
 #include "vulkan_app/vki/graphics_pipeline.hpp"
+#include "vulkan_app/vki/pipeline_cache.hpp"
+#include "vulkan_app/vki/image.hpp"
+#include "vulkan_app/vki/image_view.hpp"
 #include "vulkan_app/vki/instance.hpp"
 #include "vulkan_app/vki/logical_device.hpp"
 #include "vulkan_app/vki/memory.hpp"
 #include "vulkan_app/vki/physical_device.hpp"
 #include "vulkan_app/vki/pipeline_layout.hpp"
 #include "vulkan_app/vki/queue_family.hpp"
-#include "vulkan_app/vki/render_pass.hpp"
 #include "vulkan_app/vki/semaphore.hpp"
 #include "vulkan_app/vki/shader_module.hpp"
 #include "vulkan_app/vki/structs.hpp"
@@ -100,6 +129,27 @@ void processInput(const GLFWControllerWindow &window, FrameState &state,
     state.cameraFront = glm::normalize(direction);
 };
 
+void processPicking(const GLFWControllerWindow &window, const FrameState &state,
+                    const BVH &shapesBVH, const DataAggregator &dataAggregator,
+                    bool &wasMousePressed, el::Logger &logger) {
+    const bool isMousePressed =
+        glfwGetMouseButton(window.getGLFWWindow(), GLFW_MOUSE_BUTTON_LEFT) ==
+        GLFW_PRESS;
+    const bool isClick = isMousePressed && !wasMousePressed;
+    wasMousePressed = isMousePressed;
+    if (!isClick) return;
+    // The cursor is captured by the camera, so picking goes through the
+    // center of the screen.
+    const auto &hit =
+        pickShape(shapesBVH, dataAggregator, state.getCameraRay());
+    if (!hit.has_value()) {
+        logger.info("Picked nothing");
+        return;
+    };
+    logger.info(std::format("Picked shape {} at distance {}",
+                            hit.value().primitiveIndex, hit.value().distance));
+};
+
 static VKAPI_ATTR VkBool32 VKAPI_CALL
 debugCallback(VkDebugUtilsMessageSeverityFlagBitsEXT messageSeverity,
               VkDebugUtilsMessageTypeFlagsEXT messageType,
@@ -133,24 +183,31 @@ void DestroyDebugUtilsMessengerEXT(VkInstance instance,
     }
 }
 
-void run_app() {
+void run_app(const AppOptions &options) {
     DataAggregator dataAggregator;
     Triangle triangle(dataAggregator,
                       { (Vertex){
                             .pos = { 1.0f, 1.0f, 0.0f },
                             .color = { 1.0f, 1.0f, 1.0f },
+                            .texCoord = { 1.0f, 1.0f },
                         },
                         (Vertex){
                             .pos = { -1.0f, 1.0f, 0.0f },
                             .color = { 1.0f, 1.0f, 1.0f },
+                            .texCoord = { 0.0f, 1.0f },
                         },
                         (Vertex){
                             .pos = { 0.0f, -1.0f, 0.0f },
                             .color = { 0.0f, -1.0f, 0.0f },
+                            .texCoord = { 0.5f, 0.0f },
                         } },
                       { 0, 1, 2 });
     Circle circle(dataAggregator, 3, 1000, 1000);
     auto &mainLogger = *el::Loggers::getLogger("main");
+    BVH shapesBVH;
+    shapesBVH.build(dataAggregator.shapeBounds.getAABBs());
+    mainLogger.info(std::format("Built shapes BVH: {} nodes",
+                                shapesBVH.getNodes().size()));
     GLFWController controller;
     mainLogger.info("Created GLFWController");
 
@@ -170,12 +227,16 @@ void run_app() {
     requiredExtensions.push_back(VK_EXT_DEBUG_UTILS_EXTENSION_NAME);
     mainLogger.info("GLFW Required extensions: %v", requiredExtensions);
 
+    std::vector<std::string> layers;
+    if (options.enableValidation) {
+        layers.push_back("VK_LAYER_KHRONOS_validation");
+    };
     vki::VulkanInstance instance({
         .extensions = requiredExtensions,
         .appName = "Hello triangle",
         .appVersion = { 1, 0, 0 },
         .apiVersion = VK_API_VERSION_1_3,
-        .layers = { "VK_LAYER_KHRONOS_validation",  },
+        .layers = layers,
     });
     mainLogger.info("Created vulkan instance");
 
@@ -200,6 +261,17 @@ void run_app() {
                            std::make_tuple(queueCreateInfo));
     mainLogger.info("Created logical device");
     const auto &queue = logicalDevice.getQueue<0>(queueCreateInfo);
+    const auto &memoryProperties = physicalDevice.getMemoryProperties();
+    TextureCache textureCache(TextureCache::defaultDirectory());
+    TextureStreamer textureStreamer(logicalDevice, memoryProperties);
+    const auto &checkTexture = textureStreamer.add(
+        textureCache.resolve(pickTextureSource(
+            physicalDevice,
+            getAssets(),
+            { checkBc7Ktx2Asset, checkBc1Ktx2Asset, checkJpgAsset })));
+    textureStreamer.bindShape(checkTexture, triangle.shapeIndex);
+    mainLogger.info(std::format("Requested texture decoding on {} workers",
+                                ThreadPool::defaultThreadCount()));
     const auto &surfaceDetails = surface.getDetails(physicalDevice);
     mainLogger.info("Got surface details");
 
@@ -260,40 +332,117 @@ void run_app() {
     mainLogger.info("Created swapchain");
 
     const auto &depthFormat = findDepthFormat(physicalDevice);
-    const auto &sampleCount = getMaxUsableSampleCount(physicalDevice);
-    const auto &renderPass = createRenderPass(
-        logicalDevice, swapchainFormat.format, depthFormat, sampleCount);
-    mainLogger.info("Created render pass");
-
-    const auto &descriptorSetLayout = createDescriptorSetLayout(logicalDevice);
-    mainLogger.info("Created descriptor set layout");
-
+    const auto &antialiasing = getAntialiasingSettings(
+        physicalDevice, getRequestedAntialiasingTier());
+    const auto &sampleCount = antialiasing.sampleCount;
+    const auto &resolutionScaling = getRequestedResolutionScaling();
+    ResolutionController resolutionController(resolutionScaling);
+    auto frameGraph = createFrameGraph(
+        logicalDevice, memoryProperties, swapchainFormat.format,
+        resolutionController.getMaxRenderExtent(swapchainExtent), depthFormat,
+        sampleCount);
+    mainLogger.info(std::format(
+        "Antialiasing tier {}: {}x multisampling, sample shading {}",
+        getAntialiasingTierName(antialiasing.tier),
+        static_cast<uint32_t>(sampleCount), antialiasing.minSampleShading));
+    // What each tier's attachments would take at this extent, without
+    // creating their images.
+    for (const auto &tier : magic_enum::enum_values<AntialiasingTier>()) {
+        const auto &tierSampleCount =
+            getAntialiasingSettings(physicalDevice, tier).sampleCount;
+        const auto &memory =
+            describeFrameGraph(
+                swapchainFormat.format,
+                resolutionController.getMaxRenderExtent(swapchainExtent),
+                depthFormat, tierSampleCount)
+                .graph.estimateMemory(logicalDevice, memoryProperties);
+        mainLogger.info(std::format(
+            "Antialiasing tier {} would take {} bytes of attachment memory at "
+            "{}x multisampling, {} lazily allocated, {} unaliased",
+            getAntialiasingTierName(tier), memory.transientSize,
+            static_cast<uint32_t>(tierSampleCount),
+            memory.lazilyAllocatedSize, memory.unaliasedSize));
+    };
+    mainLogger.info(std::format(
+        "Compiled render graph: {} bytes of transient memory, {} lazily "
+        "allocated, {} unaliased",
+        frameGraph.graph.getTransientMemorySize(),
+        frameGraph.graph.getLazilyAllocatedMemorySize(),
+        frameGraph.graph.getUnaliasedMemorySize()));
+    mainLogger.info(std::format(
+        "Rendering at {} to {} of the swapchain extent, within {} ms",
+        resolutionScaling.minScale, resolutionScaling.maxScale,
+        resolutionScaling.frameBudget));
+
+    // Every pipeline variant is built from the same modules, so they share
+    // one layout.
+    DescriptorLayoutCache descriptorLayouts(logicalDevice);
+    auto pipelineLayoutDescription = describePipelineLayout(
+        { reflect_spirv(vertShaderCode.words()),
+          reflect_spirv(fragShaderCode.words()) },
+        maxBindlessTextures);
+    // Set 0 holds a uniform buffer and the sampler, set 1 the bindless
+    // textures. Set 0 is pushed where possible, as its uniform buffer
+    // changes with every frame.
+    pipelineLayoutDescription.sets.at(0).isPushDescriptor =
+        logicalDevice.supportsPushDescriptor();
+    const auto &frameSetDescription = pipelineLayoutDescription.sets.at(0);
+    const auto &textureSetDescription = pipelineLayoutDescription.sets.at(1);
     const auto &pipelineLayout =
-        createPipelineLayout(logicalDevice, descriptorSetLayout);
-    mainLogger.info("Created pipeline layout");
-
-    const auto &pipeline =
-        createGraphicsPipeline(logicalDevice, mainLogger, swapchainExtent,
-                               renderPass, pipelineLayout, sampleCount);
-    mainLogger.info("Created pipeline");
+        descriptorLayouts.getPipelineLayout(pipelineLayoutDescription);
+    mainLogger.info("Created descriptor set and pipeline layouts");
+
+    const auto &pipelineCachePath =
+        cacheDirectory() / "pipelines" /
+        std::format("{:08x}-{:08x}.bin", physicalDevice.properties.vendorID,
+                    physicalDevice.properties.deviceID);
+    vki::PipelineCache pipelineCache(logicalDevice, physicalDevice,
+                                     readCacheFile(pipelineCachePath));
+    PipelineVariants pipelines(logicalDevice, physicalDevice, pipelineLayout,
+                               pipelineCache);
+    const SpatialUpscaler upscaler(
+        logicalDevice, descriptorLayouts, pipelineCache, swapchainFormat.format,
+        frameGraph.graph.getImageView(frameGraph.sceneImage));
+    mainLogger.info("Created upscale pipeline");
+    const DepthPyramid depthPyramid(
+        logicalDevice, memoryProperties, descriptorLayouts, pipelineCache,
+        frameGraph.graph.getImageView(frameGraph.depthImage), sampleCount,
+        resolutionController.getMaxRenderExtent(swapchainExtent));
+    OcclusionCuller occlusionCuller(
+        logicalDevice, memoryProperties, descriptorLayouts, pipelineCache,
+        depthPyramid, static_cast<uint32_t>(dataAggregator.shapes.size()));
+    mainLogger.info("Created occlusion culling pipelines");
+    // Vertex colors only and no sample shading, drawn until the scene
+    // pipeline is ready.
+    const PipelineDescription fallbackDescription = {
+        .colorAttachmentFormat = swapchainFormat.format,
+        .depthAttachmentFormat = depthFormat,
+        .sampleCount = sampleCount,
+        .specialization = { .isTextureSampled = VK_FALSE },
+    };
+    const PipelineDescription sceneDescription = {
+        .colorAttachmentFormat = swapchainFormat.format,
+        .depthAttachmentFormat = depthFormat,
+        .sampleCount = sampleCount,
+        .minSampleShading = antialiasing.minSampleShading,
+    };
+    pipelines.request(fallbackDescription);
+    pipelines.request(sceneDescription);
+    mainLogger.info("Requested pipeline compilation");
+    const DynamicRenderState renderState = {
+        .viewport = { .x = 0.0f,
+                      .y = 0.0f,
+                      .width = static_cast<float>(swapchainExtent.width),
+                      .height = static_cast<float>(swapchainExtent.height),
+                      .minDepth = 0.0f,
+                      .maxDepth = 1.0f },
+        .scissor = { .offset = { .x = 100, .y = 100 },
+                     .extent = swapchainExtent },
+    };
 
     const auto &commandPool = vki::CommandPool(logicalDevice, queueFamily);
     mainLogger.info("Created command pool");
 
-    const auto &memoryProperties = physicalDevice.getMemoryProperties();
-
-    const auto &[multisampleImage, multisampleImageView] =
-        createMultisampleImage(logicalDevice, swapchainFormat.format,
-                               swapchainExtent, sampleCount, memoryProperties,
-                               mainLogger, queue);
-    const auto &[depthImage, depthImageView] =
-        createDepthImage(logicalDevice, commandPool, depthFormat, sampleCount,
-                         memoryProperties, swapchainExtent, mainLogger, queue);
-
-    const auto &framebuffers =
-        createFramebuffers(logicalDevice, swapchain, swapchainExtent,
-                           renderPass, depthImageView, multisampleImageView);
-    mainLogger.info("Created framebuffers");
     const auto &[vertexBuffer, indexBuffer] = createVertexAndIndicesBuffer(
         logicalDevice, memoryProperties, mainLogger, commandPool, queue,
         dataAggregator.getVertices(), dataAggregator.getIndices());
@@ -302,20 +451,50 @@ void run_app() {
         createUniformBuffers(logicalDevice, memoryProperties, mainLogger,
                              swapchain.swapChainImageViews.size());
     mainLogger.info("Created uniform buffers");
+    std::vector<vki::Buffer> instanceBuffers;
+    std::vector<void *> instanceMappedMemory;
+    for (std::size_t i = 0; i < uniformBuffers.size(); i++) {
+        auto [instanceBuffer, mapped] = createMappedBuffer(
+            logicalDevice, memoryProperties,
+            dataAggregator.getInstances().size_bytes(),
+            VK_BUFFER_USAGE_STORAGE_BUFFER_BIT);
+        instanceBuffers.push_back(std::move(instanceBuffer));
+        instanceMappedMemory.push_back(mapped);
+    };
+    mainLogger.info("Created instance buffers");
 
-    const auto &descriptorPool =
-        createDescriptorPool(logicalDevice, uniformBuffers.size());
-    mainLogger.info("Created descriptor pool");
-
-    const auto &[textureImage, textureImageView] = createTextureImage(
-        logicalDevice, commandPool, memoryProperties, mainLogger, queue);
     const auto &textureSampler =
         createTextureSampler(logicalDevice, physicalDevice.getProperties());
 
-    const auto &descriptorSets = createDescriptorSets(
-        logicalDevice, uniformBuffers, descriptorPool, descriptorSetLayout,
-        textureSampler, textureImageView, mainLogger);
-    mainLogger.info("Created descriptor sets");
+    FrameDescriptorSets frameDescriptorSets(
+        logicalDevice, frameSetDescription,
+        descriptorLayouts.getSetLayout(frameSetDescription), pipelineLayout,
+        uniformBuffers.size());
+    std::vector<FrameDescriptors> frameDescriptors;
+    for (std::size_t i = 0; i < uniformBuffers.size(); i++) {
+        frameDescriptors.push_back({
+            .uniformBuffer = { .buffer = uniformBuffers[i].getVkBuffer(),
+                               .offset = 0,
+                               .range = sizeof(UniformBufferObject) },
+            .sampler = { .sampler = textureSampler.getVkSampler() },
+            .instances = { .buffer = instanceBuffers[i].getVkBuffer(),
+                           .offset = 0,
+                           .range = VK_WHOLE_SIZE },
+        });
+    };
+    DescriptorAllocator textureDescriptorAllocator(
+        logicalDevice, textureSetDescription,
+        descriptorLayouts.getSetLayout(textureSetDescription), 1);
+    mainLogger.info("Created descriptor allocators");
+
+    // Slot 0 is the placeholder every shape samples until it is assigned a
+    // texture of its own.
+    BindlessTextures textures(logicalDevice,
+                              textureDescriptorAllocator.allocate());
+    textures.add(createPlaceholderTexture(logicalDevice, commandPool,
+                                          memoryProperties, mainLogger,
+                                          queue));
+    mainLogger.info("Created placeholder texture");
 
     const auto &commandBuffer = commandPool.createCommandBuffer();
     mainLogger.info("Created command buffer");
@@ -324,6 +503,8 @@ void run_app() {
     const auto &renderFinishedSemaphore = vki::Semaphore(logicalDevice);
     const auto &inFlightFence = vki::Fence(logicalDevice, true);
     mainLogger.info("Created semaphores and fences");
+    GpuFrameTimer frameTimer(logicalDevice, physicalDevice,
+                             queueFamily.family.timestamp_valid_bits);
 
     FrameState frameState = {
         .projection = glm::perspective(
@@ -340,18 +521,75 @@ void run_app() {
     frameState.projection[1][1] *= -1;
     const auto &speedConf = 0.000000004f;
     float lastFrame = 0.0f;
+    bool wasMousePressed = false;
+    FrustumCuller frustumCuller;
+    RenderQueue renderQueue;
+    FrameArena frameArena(16 * 1024);
+    uint32_t drawnFrames = 0;
     mainLogger.info("Entering main loop...");
     while (!(window.shouldClose() || shouldClose)) {
         controller.pollEvents();
         processInput(window, frameState, speedConf);
+        if (dataAggregator.areBoundsDirty) {
+            shapesBVH.refit(dataAggregator.shapeBounds);
+            dataAggregator.areBoundsDirty = false;
+        };
+        processPicking(window, frameState, shapesBVH, dataAggregator,
+                       wasMousePressed, mainLogger);
         frameState.timeOfLastFrame = std::chrono::high_resolution_clock::now();
-        drawFrame(logicalDevice, swapchain, swapchainExtent, renderPass,
-                  pipeline, framebuffers, commandBuffer, inFlightFence,
+        const auto &visibleShapes = frustumCuller.cull(
+            dataAggregator.shapeBounds,
+            Frustum::fromMatrix(frameState.projection *
+                                frameState.getViewMatrix()));
+        textureStreamer.updateResidency(dataAggregator, visibleShapes,
+                                        frameState, swapchainExtent);
+        // Changed texture assignments reach the shapes' instance data with
+        // the next recorded frame, which also fills the new images.
+        textureStreamer.update(logicalDevice, memoryProperties, mainLogger,
+                               textures, dataAggregator);
+        const auto *pipeline = pipelines.tryGet(sceneDescription);
+        uint32_t pipelineKey = 0;
+        if (pipeline == nullptr) {
+            pipeline = pipelines.tryGet(fallbackDescription);
+            pipelineKey = 1;
+        };
+        // Frames are skipped until the first pipeline has compiled. Waiting
+        // for it at most a frame's time keeps the loop from spinning while
+        // still handling events.
+        if (pipeline == nullptr) {
+            pipelines.request(fallbackDescription)
+                .wait_for(std::chrono::milliseconds(16));
+            continue;
+        };
+        queueSceneDraws(renderQueue, dataAggregator, visibleShapes,
+                        frameState, pipelineKey);
+        const auto &drawOrder = renderQueue.sort();
+        if (options.beforeDrawFrame) options.beforeDrawFrame();
+        drawFrame(logicalDevice, swapchain, swapchainExtent, *pipeline,
+                  renderState, commandBuffer, frameGraph, frameArena,
+                  upscaler, depthPyramid, occlusionCuller, frameTimer,
+                  resolutionController, inFlightFence,
                   imageAvailableSemaphore, renderFinishedSemaphore,
-                  vertexBuffer, indexBuffer, queue, queue, uniformMappedMemory,
-                  pipelineLayout, descriptorSets, frameState, dataAggregator);
+                  vertexBuffer, indexBuffer, queue, queue,
+                  uniformMappedMemory, instanceMappedMemory, pipelineLayout,
+                  frameDescriptorSets, frameDescriptors, textureStreamer,
+                  textures, frameState, dataAggregator, drawOrder);
+        if (options.afterDrawFrame) options.afterDrawFrame();
+        drawnFrames++;
+        if (options.frameLimit.has_value() &&
+            drawnFrames == options.frameLimit.value()) {
+            break;
+        };
     };
 
     mainLogger.info("Waiting for queued operations to complete...");
     logicalDevice.waitIdle();
+    try {
+        pipelines.mergeCaches();
+        writeFileAtomically(pipelineCachePath, pipelineCache.getData());
+        mainLogger.info("Saved pipeline cache");
+    } catch (const std::exception &error) {
+        mainLogger.warn(
+            std::format("Failed to save pipeline cache: {}", error.what()));
+    };
 };
@@ -1,3 +1,17 @@
 #pragma once
 
-void run_app();
+#include <cstdint>
+#include <functional>
+#include <optional>
+
+// Lets tests drive the main loop.
+struct AppOptions {
+    bool enableValidation = true;
+    // Stops the main loop once this many frames have been drawn.
+    std::optional<uint32_t> frameLimit;
+    // Called right before and after every drawFrame call.
+    std::function<void()> beforeDrawFrame;
+    std::function<void()> afterDrawFrame;
+};
+
+void run_app(const AppOptions &options = {});
@@ -1,6 +1,21 @@
 #include "./assets.hpp"
 
-#include <vector>
+#include <cstdint>
+#include <cstdlib>
+#include <filesystem>
+#include <span>
 
-const std::vector<unsigned char> checkJpgAsset =
-    std::vector<unsigned char>(&data_start_check_jpg, &data_end_check_jpg);
+#include "embedded_resources.hpp"
+#include "vulkan_app/app/asset_pack.hpp"
+
+AssetPack &getAssets() {
+    static AssetPack assets = []() {
+        if (const char *path = std::getenv("VULKAN_APP_ASSET_PACK")) {
+            return AssetPack(std::filesystem::path(path));
+        };
+        const auto &pack = embeddedResources.find("assets.pack").bytes();
+        return AssetPack(std::span<const uint8_t>(
+            reinterpret_cast<const uint8_t *>(pack.data()), pack.size()));
+    }();
+    return assets;
+};
@@ -1,7 +1,14 @@
 #pragma once
 
-#include <vector>
+#include <string_view>
 
-extern unsigned char data_start_check_jpg, data_end_check_jpg;
+#include "vulkan_app/app/asset_pack.hpp"
 
-extern const std::vector<unsigned char> checkJpgAsset;
+// The embedded pack, or the file named by VULKAN_APP_ASSET_PACK when set,
+// mapped instead so assets can be replaced without relinking. Opened on
+// first use.
+AssetPack &getAssets();
+
+constexpr std::string_view checkJpgAsset = "check.jpg";
+constexpr std::string_view checkBc7Ktx2Asset = "check.bc7.ktx2";
+constexpr std::string_view checkBc1Ktx2Asset = "check.bc1.ktx2";
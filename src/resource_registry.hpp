@@ -0,0 +1,60 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <stdexcept>
+#include <string_view>
+
+// A blob linked into the executable. Embedded blobs start on a 16-byte
+// boundary, so they can be viewed as words without copying.
+struct EmbeddedResource {
+    std::string_view name;
+    const void *data;
+    std::size_t size;
+
+    inline std::span<const std::byte> bytes() const {
+        return { static_cast<const std::byte *>(data), size };
+    };
+
+    // For SPIR-V, which is declared as words by the generated registry.
+    inline std::span<const uint32_t> words() const {
+        return { static_cast<const uint32_t *>(data),
+                 size / sizeof(uint32_t) };
+    };
+};
+
+// Name-sorted table of embedded resources, built at compile time by the
+// header that embed_registry generates. Lookups with a constant name are
+// resolved by the compiler, and nothing is copied at startup.
+template <std::size_t N>
+class ResourceRegistry {
+    std::array<EmbeddedResource, N> resources;
+
+public:
+    consteval explicit ResourceRegistry(
+        std::array<EmbeddedResource, N> resources)
+        : resources(resources) {
+        std::ranges::sort(this->resources, {}, &EmbeddedResource::name);
+        for (std::size_t i = 1; i < N; i++) {
+            if (this->resources[i - 1].name == this->resources[i].name) {
+                throw std::logic_error("Duplicate embedded resource name");
+            };
+        };
+    };
+
+    constexpr const EmbeddedResource &find(const std::string_view &name) const {
+        const auto &resource = std::ranges::lower_bound(
+            resources, name, {}, &EmbeddedResource::name);
+        if (resource == resources.end() || resource->name != name) {
+            throw std::out_of_range("No embedded resource with this name");
+        };
+        return *resource;
+    };
+
+    constexpr auto begin() const { return resources.begin(); };
+    constexpr auto end() const { return resources.end(); };
+    constexpr std::size_t size() const { return N; };
+};
@@ -1,9 +1,29 @@
 #pragma once
 
-#include <vector>
+#include <cstdint>
 
-extern char data_start_shader_frag_spv, data_end_shader_frag_spv;
-extern char data_start_shader_vert_spv, data_end_shader_vert_spv;
+#include "embedded_resources.hpp"
+#include "resource_registry.hpp"
 
-extern const std::vector<char> vertShaderCode;
-extern const std::vector<char> fragShaderCode;
+inline constexpr const EmbeddedResource &vertShaderCode =
+    embeddedResources.find("shader.vert.spv");
+inline constexpr const EmbeddedResource &fragShaderCode =
+    embeddedResources.find("shader.frag.spv");
+inline constexpr const EmbeddedResource &upscaleVertShaderCode =
+    embeddedResources.find("upscale.vert.spv");
+inline constexpr const EmbeddedResource &upscaleFragShaderCode =
+    embeddedResources.find("upscale.frag.spv");
+inline constexpr const EmbeddedResource &depthPyramidCompShaderCode =
+    embeddedResources.find("depth_pyramid.comp.spv");
+inline constexpr const EmbeddedResource &depthPyramidMsCompShaderCode =
+    embeddedResources.find("depth_pyramid_ms.comp.spv");
+inline constexpr const EmbeddedResource &cullCompShaderCode =
+    embeddedResources.find("cull.comp.spv");
+
+static_assert(vertShaderCode.size % sizeof(uint32_t) == 0);
+static_assert(fragShaderCode.size % sizeof(uint32_t) == 0);
+static_assert(upscaleVertShaderCode.size % sizeof(uint32_t) == 0);
+static_assert(upscaleFragShaderCode.size % sizeof(uint32_t) == 0);
+static_assert(depthPyramidCompShaderCode.size % sizeof(uint32_t) == 0);
+static_assert(depthPyramidMsCompShaderCode.size % sizeof(uint32_t) == 0);
+static_assert(cullCompShaderCode.size % sizeof(uint32_t) == 0);
@@ -2,11 +2,22 @@
 
 layout(location = 0) in vec3 fragColor;
 layout(location = 1) in vec2 fragTexCoord;
+layout(location = 2) flat in uint fragTextureIndex;
 
-layout(binding = 1) uniform sampler2D texSampler;
+layout(binding = 1) uniform sampler texSampler;
+layout(set = 1, binding = 0) uniform texture2D textures[];
+
+layout(constant_id = 0) const bool SAMPLE_TEXTURE = true;
 
 layout(location = 0) out vec4 outColor;
 
 void main() {
     outColor = vec4(fragColor, 1.0f);
+    if (SAMPLE_TEXTURE) {
+        // Every draw of an indirect multi-draw is its own invocation group
+        // and covers a single shape, so indexing needs no nonuniformEXT.
+        outColor *= texture(
+            sampler2D(textures[fragTextureIndex], texSampler),
+            fragTexCoord);
+    }
 }
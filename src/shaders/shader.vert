@@ -5,15 +5,30 @@ layout(binding = 0) uniform UniformBufferObject {
     mat4 view;
     mat4 proj;
 } ubo;
+
+// InstanceData of every shape, indexed by the instance index that the
+// shape's indirect draw command carries.
+struct Instance {
+    uint textureIndex;
+};
+layout(binding = 2) readonly buffer Instances {
+    Instance instances[];
+};
+
 layout(location = 0) in vec3 inPosition;
 layout(location = 1) in vec3 inColor;
 layout(location = 2) in vec2 inTexCoord;
 
+// Matches VertexColorSource: 0 takes the vertex color, 1 white.
+layout(constant_id = 1) const uint COLOR_SOURCE = 0;
+
 layout(location = 0) out vec3 fragColor;
 layout(location = 1) out vec2 fragTexCoord;
+layout(location = 2) flat out uint fragTextureIndex;
 
 void main() {
     gl_Position = ubo.proj * ubo.view * ubo.model * vec4(inPosition, 1.0);
-    fragColor = inColor;
+    fragColor = COLOR_SOURCE == 0 ? inColor : vec3(1.0);
     fragTexCoord = inTexCoord;
+    fragTextureIndex = instances[gl_InstanceIndex].textureIndex;
 }
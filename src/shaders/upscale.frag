@@ -0,0 +1,122 @@
+#version 450
+#extension GL_EXT_samplerless_texture_functions : require
+
+// Edge-adaptive spatial upscaling after the EASU pass of AMD FidelityFX
+// Super Resolution 1. Twelve texels around the output pixel are weighted
+// by a Lanczos-like kernel that is stretched along the local edge
+// direction, then clamped to the nearest four to avoid ringing.
+
+layout(set = 0, binding = 0) uniform texture2D sceneColor;
+
+// UpscaleConstants of the frame.
+layout(push_constant) uniform Upscale {
+    // Render extent over output extent.
+    vec2 inputScale;
+    // The last texel of the render extent.
+    ivec2 inputMax;
+} upscale;
+
+layout(location = 0) out vec4 outColor;
+
+vec3 fetch(ivec2 texel) {
+    return texelFetch(sceneColor, clamp(texel, ivec2(0), upscale.inputMax), 0)
+        .rgb;
+}
+
+float luma(vec3 color) {
+    return color.b * 0.5 + (color.r * 0.5 + color.g);
+}
+
+// Accumulates the edge direction and length around one of the four
+// texels nearest to the output pixel, from the cross of its neighbours:
+// a above, b left, c itself, d right and e below.
+void analyze(inout vec2 dir, inout float len, float w, float a, float b,
+             float c, float d, float e) {
+    float dirX = d - b;
+    float lenX = max(abs(d - c), abs(c - b));
+    lenX = lenX > 0.0 ? clamp(abs(dirX) / lenX, 0.0, 1.0) : 0.0;
+    float dirY = e - a;
+    float lenY = max(abs(e - c), abs(c - a));
+    lenY = lenY > 0.0 ? clamp(abs(dirY) / lenY, 0.0, 1.0) : 0.0;
+    dir += vec2(dirX, dirY) * w;
+    len += (lenX * lenX + lenY * lenY) * w;
+}
+
+void accumulate(inout vec3 color, inout float weight, vec2 offset, vec2 dir,
+                vec2 len, float lobe, float clip, vec3 texel) {
+    // Rotate into the edge's frame and scale the axes independently.
+    vec2 v = vec2(dot(offset, dir), dot(offset, vec2(-dir.y, dir.x))) * len;
+    float d2 = min(dot(v, v), clip);
+    // Lanczos 2 approximated by (25/16 (2/5 x^2 - 1)^2 - 9/16) and a
+    // window of (lobe x^2 - 1)^2.
+    float base = 2.0 / 5.0 * d2 - 1.0;
+    float window = lobe * d2 - 1.0;
+    float w = (25.0 / 16.0 * base * base - 9.0 / 16.0) * window * window;
+    color += texel * w;
+    weight += w;
+}
+
+void main() {
+    vec2 position = gl_FragCoord.xy * upscale.inputScale - 0.5;
+    ivec2 origin = ivec2(floor(position));
+    vec2 pp = position - floor(position);
+
+    //    b c
+    //  e f g h
+    //  i j k l
+    //    n o
+    vec3 b = fetch(origin + ivec2(0, -1));
+    vec3 c = fetch(origin + ivec2(1, -1));
+    vec3 e = fetch(origin + ivec2(-1, 0));
+    vec3 f = fetch(origin);
+    vec3 g = fetch(origin + ivec2(1, 0));
+    vec3 h = fetch(origin + ivec2(2, 0));
+    vec3 i = fetch(origin + ivec2(-1, 1));
+    vec3 j = fetch(origin + ivec2(0, 1));
+    vec3 k = fetch(origin + ivec2(1, 1));
+    vec3 l = fetch(origin + ivec2(2, 1));
+    vec3 n = fetch(origin + ivec2(0, 2));
+    vec3 o = fetch(origin + ivec2(1, 2));
+    float bL = luma(b), cL = luma(c), eL = luma(e), fL = luma(f);
+    float gL = luma(g), hL = luma(h), iL = luma(i), jL = luma(j);
+    float kL = luma(k), lL = luma(l), nL = luma(n), oL = luma(o);
+
+    // Bilinearly weighted analysis of f, g, j and k.
+    vec2 dir = vec2(0.0);
+    float len = 0.0;
+    analyze(dir, len, (1.0 - pp.x) * (1.0 - pp.y), bL, eL, fL, gL, jL);
+    analyze(dir, len, pp.x * (1.0 - pp.y), cL, fL, gL, hL, kL);
+    analyze(dir, len, (1.0 - pp.x) * pp.y, fL, iL, jL, kL, nL);
+    analyze(dir, len, pp.x * pp.y, gL, jL, kL, lL, oL);
+
+    float dirLength2 = dot(dir, dir);
+    dir = dirLength2 < 1.0 / 32768.0 ? vec2(1.0, 0.0)
+                                     : dir * inversesqrt(dirLength2);
+    len = len * 0.5;
+    len *= len;
+    // Diagonal edges stretch the kernel further along them.
+    float stretch = dot(dir, dir) / max(abs(dir.x), abs(dir.y));
+    vec2 len2 = vec2(1.0 + (stretch - 1.0) * len, 1.0 - 0.5 * len);
+    // Sharper, narrower lobes on strong edges.
+    float lobe = 0.5 + (1.0 / 4.0 - 0.04 - 0.5) * len;
+    float clip = 1.0 / lobe;
+
+    vec3 color = vec3(0.0);
+    float weight = 0.0;
+    accumulate(color, weight, vec2(0.0, -1.0) - pp, dir, len2, lobe, clip, b);
+    accumulate(color, weight, vec2(1.0, -1.0) - pp, dir, len2, lobe, clip, c);
+    accumulate(color, weight, vec2(-1.0, 1.0) - pp, dir, len2, lobe, clip, i);
+    accumulate(color, weight, vec2(0.0, 1.0) - pp, dir, len2, lobe, clip, j);
+    accumulate(color, weight, vec2(0.0, 0.0) - pp, dir, len2, lobe, clip, f);
+    accumulate(color, weight, vec2(-1.0, 0.0) - pp, dir, len2, lobe, clip, e);
+    accumulate(color, weight, vec2(1.0, 1.0) - pp, dir, len2, lobe, clip, k);
+    accumulate(color, weight, vec2(2.0, 1.0) - pp, dir, len2, lobe, clip, l);
+    accumulate(color, weight, vec2(2.0, 0.0) - pp, dir, len2, lobe, clip, h);
+    accumulate(color, weight, vec2(1.0, 0.0) - pp, dir, len2, lobe, clip, g);
+    accumulate(color, weight, vec2(1.0, 2.0) - pp, dir, len2, lobe, clip, o);
+    accumulate(color, weight, vec2(0.0, 2.0) - pp, dir, len2, lobe, clip, n);
+
+    vec3 minimum = min(min(f, g), min(j, k));
+    vec3 maximum = max(max(f, g), max(j, k));
+    outColor = vec4(clamp(color / weight, minimum, maximum), 1.0);
+}
@@ -0,0 +1,76 @@
+#include "./antialiasing.hpp"
+
+#include <vulkan/vulkan_core.h>
+
+#include <array>
+#include <cstdlib>
+#include <format>
+#include <stdexcept>
+#include <string_view>
+
+#include "vulkan_app/vki/physical_device.hpp"
+
+namespace {
+struct TierDefinition {
+    AntialiasingTier tier;
+    std::string_view name;
+    VkSampleCountFlagBits sampleCount;
+    float minSampleShading;
+};
+
+constexpr std::array<TierDefinition, 5> tierDefinitions = { {
+    { AntialiasingTier::OFF, "off", VK_SAMPLE_COUNT_1_BIT, 0.0f },
+    { AntialiasingTier::LOW, "low", VK_SAMPLE_COUNT_2_BIT, 0.0f },
+    { AntialiasingTier::MEDIUM, "medium", VK_SAMPLE_COUNT_4_BIT, 0.0f },
+    { AntialiasingTier::HIGH, "high", VK_SAMPLE_COUNT_8_BIT, 0.0f },
+    { AntialiasingTier::ULTRA, "ultra", VK_SAMPLE_COUNT_8_BIT, 0.3f },
+} };
+
+const TierDefinition &getTierDefinition(const AntialiasingTier &tier) {
+    for (const auto &definition : tierDefinitions) {
+        if (definition.tier == tier) return definition;
+    };
+    throw std::invalid_argument("Unknown antialiasing tier");
+};
+};  // namespace
+
+AntialiasingTier parseAntialiasingTier(const std::string_view &name) {
+    for (const auto &definition : tierDefinitions) {
+        if (definition.name == name) return definition.tier;
+    };
+    throw std::invalid_argument(
+        std::format("Unknown antialiasing tier {}", name));
+};
+
+std::string_view getAntialiasingTierName(const AntialiasingTier &tier) {
+    return getTierDefinition(tier).name;
+};
+
+AntialiasingTier getRequestedAntialiasingTier() {
+    if (const char *name = std::getenv("VULKAN_APP_AA")) {
+        return parseAntialiasingTier(name);
+    };
+    return AntialiasingTier::MEDIUM;
+};
+
+AntialiasingSettings getAntialiasingSettings(
+    const vki::PhysicalDevice &physicalDevice, const AntialiasingTier &tier) {
+    const auto &definition = getTierDefinition(tier);
+    const auto &limits = physicalDevice.properties.limits;
+    const VkSampleCountFlags counts = limits.framebufferColorSampleCounts &
+                                      limits.framebufferDepthSampleCounts &
+                                      limits.sampledImageDepthSampleCounts;
+    // Sample counts are single bits, so halving steps down one count.
+    auto sampleCount = definition.sampleCount;
+    while (sampleCount != VK_SAMPLE_COUNT_1_BIT &&
+           (counts & sampleCount) == 0) {
+        sampleCount = static_cast<VkSampleCountFlagBits>(sampleCount >> 1);
+    };
+    const bool canShadeSamples =
+        sampleCount != VK_SAMPLE_COUNT_1_BIT &&
+        physicalDevice.getFeatures().sampleRateShading == VK_TRUE;
+    return { .tier = tier,
+             .sampleCount = sampleCount,
+             .minSampleShading =
+                 canShadeSamples ? definition.minSampleShading : 0.0f };
+};
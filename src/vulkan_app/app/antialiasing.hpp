@@ -0,0 +1,38 @@
+#pragma once
+
+#include <vulkan/vulkan_core.h>
+
+#include <string_view>
+
+#include "vulkan_app/vki/physical_device.hpp"
+
+// Each tier costs more fill rate and attachment memory than the one
+// before it. Sample shading runs the fragment shader per sample instead of
+// per pixel, which also smooths aliasing inside textures.
+enum class AntialiasingTier {
+    OFF,
+    LOW,
+    MEDIUM,
+    HIGH,
+    ULTRA,
+};
+
+struct AntialiasingSettings {
+    AntialiasingTier tier;
+    VkSampleCountFlagBits sampleCount;
+    // Zero disables sample shading.
+    float minSampleShading;
+};
+
+// Throws on anything but off, low, medium, high or ultra.
+AntialiasingTier parseAntialiasingTier(const std::string_view &name);
+std::string_view getAntialiasingTierName(const AntialiasingTier &tier);
+
+// $VULKAN_APP_AA, or medium if it is unset.
+AntialiasingTier getRequestedAntialiasingTier();
+
+// The tier's sample count is lowered to the highest one the device
+// supports for color and depth attachments and for sampled depth images,
+// and sample shading is dropped without the sampleRateShading feature.
+AntialiasingSettings getAntialiasingSettings(
+    const vki::PhysicalDevice &physicalDevice, const AntialiasingTier &tier);
@@ -0,0 +1,217 @@
+#include "./asset_pack.hpp"
+
+#include <zlib.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <format>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "vulkan_app/app/mapped_file.hpp"
+
+namespace {
+constexpr std::size_t headerSize = 32;
+constexpr std::size_t indexEntrySize = 40;
+
+constexpr uint32_t compressionNone = 0;
+constexpr uint32_t compressionZlib = 1;
+
+template <typename T>
+T readValue(const std::span<const uint8_t> &pack, const std::size_t &offset) {
+    if (offset + sizeof(T) > pack.size()) {
+        throw std::runtime_error("Truncated asset pack");
+    };
+    T value;
+    std::memcpy(&value, pack.data() + offset, sizeof(T));
+    return value;
+};
+
+template <typename T>
+void writeValue(std::vector<uint8_t> &out, const std::size_t &offset,
+                const T &value) {
+    std::memcpy(out.data() + offset, &value, sizeof(T));
+};
+
+std::size_t alignUp(const std::size_t &offset) {
+    return (offset + assetPackAlignment - 1) / assetPackAlignment *
+           assetPackAlignment;
+};
+
+std::vector<uint8_t> compress(const std::vector<uint8_t> &data) {
+    uLongf size = compressBound(data.size());
+    std::vector<uint8_t> out(size);
+    if (compress2(out.data(), &size, data.data(), data.size(),
+                  Z_BEST_COMPRESSION) != Z_OK) {
+        throw std::runtime_error("Failed to compress asset");
+    };
+    out.resize(size);
+    return out;
+};
+};  // namespace
+
+std::vector<uint8_t> write_asset_pack(std::vector<AssetPackInput> assets) {
+    std::sort(assets.begin(), assets.end(),
+              [](const AssetPackInput &a, const AssetPackInput &b) {
+                  return a.name < b.name;
+              });
+    for (std::size_t i = 1; i < assets.size(); i++) {
+        if (assets[i].name == assets[i - 1].name) {
+            throw std::runtime_error("Duplicate asset name " + assets[i].name);
+        };
+    };
+
+    std::vector<std::vector<uint8_t>> stored;
+    std::vector<uint32_t> compressions;
+    for (auto &asset : assets) {
+        auto compressed = compress(asset.data);
+        // Keep the data in place unless zlib saves at least an eighth.
+        if (compressed.size() < asset.data.size() - asset.data.size() / 8) {
+            stored.push_back(std::move(compressed));
+            compressions.push_back(compressionZlib);
+        } else {
+            stored.push_back(asset.data);
+            compressions.push_back(compressionNone);
+        };
+    };
+
+    const std::size_t namesOffset = headerSize + assets.size() * indexEntrySize;
+    std::size_t size = namesOffset;
+    for (const auto &asset : assets) size += asset.name.size();
+    const auto namesSize = static_cast<uint32_t>(size - namesOffset);
+    std::vector<std::size_t> dataOffsets;
+    for (const auto &data : stored) {
+        size = alignUp(size);
+        dataOffsets.push_back(size);
+        size += data.size();
+    };
+
+    std::vector<uint8_t> out(size, 0);
+    std::copy(assetPackIdentifier.begin(), assetPackIdentifier.end(),
+              out.begin());
+    writeValue<uint32_t>(out, 8, static_cast<uint32_t>(assets.size()));
+    writeValue<uint32_t>(out, 12, namesSize);
+    writeValue<uint64_t>(out, 16, headerSize);
+    writeValue<uint64_t>(out, 24, namesOffset);
+    std::size_t nameOffset = 0;
+    for (std::size_t i = 0; i < assets.size(); i++) {
+        const auto &entryOffset = headerSize + i * indexEntrySize;
+        const auto &name = assets[i].name;
+        writeValue<uint64_t>(out, entryOffset, dataOffsets[i]);
+        writeValue<uint64_t>(out, entryOffset + 8, stored[i].size());
+        writeValue<uint64_t>(out, entryOffset + 16, assets[i].data.size());
+        writeValue<uint32_t>(out, entryOffset + 24,
+                             static_cast<uint32_t>(nameOffset));
+        writeValue<uint32_t>(out, entryOffset + 28,
+                             static_cast<uint32_t>(name.size()));
+        writeValue<uint32_t>(out, entryOffset + 32, compressions[i]);
+        std::copy(name.begin(), name.end(),
+                  out.begin() + namesOffset + nameOffset);
+        nameOffset += name.size();
+        std::copy(stored[i].begin(), stored[i].end(),
+                  out.begin() + dataOffsets[i]);
+    };
+    return out;
+};
+
+AssetPack::AssetPack(const std::span<const uint8_t> &pack) {
+    readIndex(pack);
+};
+
+AssetPack::AssetPack(const std::filesystem::path &path)
+    : file(std::make_unique<MappedFile>(path)) {
+    readIndex(file->getBytes());
+};
+
+void AssetPack::readIndex(const std::span<const uint8_t> &pack) {
+    if (pack.size() < headerSize ||
+        !std::equal(assetPackIdentifier.begin(), assetPackIdentifier.end(),
+                    pack.begin())) {
+        throw std::runtime_error("Not an asset pack");
+    };
+    const auto entryCount = readValue<uint32_t>(pack, 8);
+    const auto namesSize = readValue<uint32_t>(pack, 12);
+    const auto indexOffset = readValue<uint64_t>(pack, 16);
+    const auto namesOffset = readValue<uint64_t>(pack, 24);
+    if (namesOffset > pack.size() || namesSize > pack.size() - namesOffset) {
+        throw std::runtime_error("Asset pack names are out of bounds");
+    };
+    const auto &names = pack.subspan(namesOffset, namesSize);
+
+    entries = std::vector<Entry>(entryCount);
+    for (uint32_t i = 0; i < entryCount; i++) {
+        const auto &entryOffset = indexOffset + i * indexEntrySize;
+        const auto dataOffset = readValue<uint64_t>(pack, entryOffset);
+        const auto storedSize = readValue<uint64_t>(pack, entryOffset + 8);
+        const auto nameOffset = readValue<uint32_t>(pack, entryOffset + 24);
+        const auto nameLength = readValue<uint32_t>(pack, entryOffset + 28);
+        const auto compression = readValue<uint32_t>(pack, entryOffset + 32);
+        if (dataOffset > pack.size() ||
+            storedSize > pack.size() - dataOffset ||
+            nameOffset > names.size() ||
+            nameLength > names.size() - nameOffset) {
+            throw std::runtime_error("Asset pack entry is out of bounds");
+        };
+        if (compression != compressionNone &&
+            compression != compressionZlib) {
+            throw std::runtime_error("Unknown asset pack compression");
+        };
+        auto &entry = entries[i];
+        entry.name = std::string_view(
+            reinterpret_cast<const char *>(names.data()) + nameOffset,
+            nameLength);
+        // Lookups binary-search the names, which the writer sorts.
+        if (i > 0 && entries[i - 1].name >= entry.name) {
+            throw std::runtime_error("Asset pack names are not sorted");
+        };
+        entry.stored = pack.subspan(dataOffset, storedSize);
+        entry.size = readValue<uint64_t>(pack, entryOffset + 16);
+        entry.isCompressed = compression == compressionZlib;
+    };
+};
+
+std::optional<std::size_t> AssetPack::find(
+    const std::string_view &name) const {
+    const auto &entry = std::lower_bound(
+        entries.begin(), entries.end(), name,
+        [](const Entry &entry, const std::string_view &name) {
+            return entry.name < name;
+        });
+    if (entry == entries.end() || entry->name != name) return std::nullopt;
+    return entry - entries.begin();
+};
+
+std::span<const uint8_t> AssetPack::get(const std::string_view &name) {
+    const auto &index = find(name);
+    if (!index.has_value()) {
+        throw std::runtime_error(std::format("No asset named {}", name));
+    };
+    return get(index.value());
+};
+
+std::span<const uint8_t> AssetPack::get(const std::size_t &index) {
+    auto &entry = entries.at(index);
+    if (!entry.isCompressed) return entry.stored;
+    std::call_once(entry.decompressed, [&entry]() {
+        std::vector<uint8_t> data(entry.size);
+        uLongf size = data.size();
+        if (uncompress(data.data(), &size, entry.stored.data(),
+                       entry.stored.size()) != Z_OK ||
+            size != data.size()) {
+            throw std::runtime_error(
+                std::format("Failed to decompress asset {}", entry.name));
+        };
+        entry.data = std::move(data);
+    });
+    return entry.data;
+};
@@ -0,0 +1,68 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "vulkan_app/app/mapped_file.hpp"
+
+constexpr std::array<uint8_t, 8> assetPackIdentifier = { 'V', 'K', 'P', 'A',
+                                                         'C', 'K', '1', '\n' };
+
+// Stored entries start at this alignment from the beginning of the pack;
+// the embedded pack and memory mappings are aligned at least as much.
+constexpr std::size_t assetPackAlignment = 16;
+
+struct AssetPackInput {
+    std::string name;
+    std::vector<uint8_t> data;
+};
+
+// Entries are compressed with zlib unless that saves little, as for JPEG
+// or other already compressed data, in which case they are stored as is.
+std::vector<uint8_t> write_asset_pack(std::vector<AssetPackInput> assets);
+
+// Read-only view of a pack built by write_asset_pack. Opening one only reads
+// the index, and throws if it is out of bounds or its names are not sorted;
+// entries are found by binary search over the names and decompressed on
+// first access. Stored entries are returned in place.
+// Entries may be requested from several threads at once, and different
+// entries then decompress in parallel.
+class AssetPack {
+    struct Entry {
+        std::string_view name;
+        std::span<const uint8_t> stored;
+        uint64_t size;
+        bool isCompressed;
+        std::once_flag decompressed;
+        std::vector<uint8_t> data;
+    };
+
+    std::unique_ptr<MappedFile> file;
+    std::vector<Entry> entries;
+
+    void readIndex(const std::span<const uint8_t> &pack);
+
+public:
+    // The bytes must outlive the pack and be aligned to assetPackAlignment.
+    explicit AssetPack(const std::span<const uint8_t> &pack);
+    explicit AssetPack(const std::filesystem::path &path);
+    AssetPack(const AssetPack &other) = delete;
+    AssetPack &operator=(const AssetPack &other) = delete;
+
+    std::optional<std::size_t> find(const std::string_view &name) const;
+    // Throws if the pack has no entry with this name. The returned bytes
+    // live as long as the pack.
+    std::span<const uint8_t> get(const std::string_view &name);
+    std::span<const uint8_t> get(const std::size_t &index);
+
+    inline std::size_t size() const { return entries.size(); };
+};
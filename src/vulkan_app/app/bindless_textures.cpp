@@ -0,0 +1,44 @@
+#include "./bindless_textures.hpp"
+
+#include <vulkan/vulkan_core.h>
+
+#include <cstdint>
+#include <optional>
+#include <stdexcept>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include "vulkan_app/app/create_funcs.hpp"
+#include "vulkan_app/vki/image.hpp"
+#include "vulkan_app/vki/image_view.hpp"
+#include "vulkan_app/vki/logical_device.hpp"
+
+BindlessTextures::BindlessTextures(const vki::LogicalDevice &logicalDevice,
+                                   const VkDescriptorSet &descriptorSet)
+    : logicalDevice{ logicalDevice }, descriptorSet{ descriptorSet } {
+    textures.reserve(maxBindlessTextures);
+};
+
+uint32_t BindlessTextures::add(
+    std::tuple<vki::Image, vki::ImageView> &&texture) {
+    const auto textureIndex = allocateSlot();
+    replace(textureIndex, std::move(texture));
+    return textureIndex;
+};
+
+uint32_t BindlessTextures::allocateSlot() {
+    if (textures.size() == maxBindlessTextures) {
+        throw std::runtime_error("Bindless texture array is full");
+    };
+    textures.emplace_back();
+    return static_cast<uint32_t>(textures.size() - 1);
+};
+
+std::optional<std::tuple<vki::Image, vki::ImageView>>
+BindlessTextures::replace(const uint32_t &textureIndex,
+                          std::tuple<vki::Image, vki::ImageView> &&texture) {
+    writeBindlessTexture(logicalDevice, descriptorSet, textureIndex,
+                         std::get<1>(texture));
+    return std::exchange(textures[textureIndex], std::move(texture));
+};
@@ -0,0 +1,47 @@
+#pragma once
+
+#include <vulkan/vulkan_core.h>
+
+#include <cstdint>
+#include <optional>
+#include <tuple>
+#include <vector>
+
+#include "vulkan_app/vki/image.hpp"
+#include "vulkan_app/vki/image_view.hpp"
+#include "vulkan_app/vki/logical_device.hpp"
+
+constexpr uint32_t maxBindlessTextures = 1024;
+
+// Owns every sampled texture and keeps each one in a fixed slot of the
+// texture array in descriptor set 1, so draws select textures by index
+// instead of rebinding descriptor sets.
+class BindlessTextures {
+    const vki::LogicalDevice &logicalDevice;
+    VkDescriptorSet descriptorSet;
+    std::vector<std::optional<std::tuple<vki::Image, vki::ImageView>>>
+        textures;
+
+public:
+    explicit BindlessTextures(const vki::LogicalDevice &logicalDevice,
+                              const VkDescriptorSet &descriptorSet);
+
+    uint32_t add(std::tuple<vki::Image, vki::ImageView> &&texture);
+    // Takes the next slot without writing its descriptor, so that shapes can
+    // be pointed at it before the device is done with the descriptor set.
+    // The slot must be filled by replace before a frame samples it.
+    uint32_t allocateSlot();
+    // Points the slot at a new image and returns the previous one, which the
+    // caller keeps alive until the device is done with it. The descriptor
+    // set must not be in use by the device.
+    std::optional<std::tuple<vki::Image, vki::ImageView>> replace(
+        const uint32_t &textureIndex,
+        std::tuple<vki::Image, vki::ImageView> &&texture);
+
+    inline const vki::Image &getImage(const uint32_t &textureIndex) const {
+        return std::get<0>(textures[textureIndex].value());
+    };
+
+    inline uint32_t size() const { return textures.size(); };
+    inline VkDescriptorSet getDescriptorSet() const { return descriptorSet; };
+};
@@ -0,0 +1,150 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <limits>
+#include <vector>
+
+#include "glm/ext/matrix_float4x4.hpp"
+#include "glm/ext/vector_float3.hpp"
+#include "glm/ext/vector_float4.hpp"
+#include "glm/common.hpp"
+#include "glm/geometric.hpp"
+
+struct AABB {
+    glm::vec3 min = glm::vec3(std::numeric_limits<float>::max());
+    glm::vec3 max = glm::vec3(std::numeric_limits<float>::lowest());
+
+    inline void expand(const glm::vec3 &point) {
+        min = glm::min(min, point);
+        max = glm::max(max, point);
+    };
+
+    inline void expand(const AABB &other) {
+        min = glm::min(min, other.min);
+        max = glm::max(max, other.max);
+    };
+
+    inline glm::vec3 center() const { return (min + max) * 0.5f; };
+
+    inline glm::vec3 extent() const { return max - min; };
+
+    inline bool isEmpty() const {
+        return min.x > max.x || min.y > max.y || min.z > max.z;
+    };
+
+    inline float surfaceArea() const {
+        if (isEmpty()) return 0.0f;
+        const auto &e = extent();
+        return 2.0f * (e.x * e.y + e.y * e.z + e.z * e.x);
+    };
+};
+
+struct BoundingSphere {
+    glm::vec3 center;
+    float radius;
+};
+
+// Structure-of-arrays storage for per-shape bounds, laid out so the culler
+// can load the same component of consecutive shapes into one SIMD register.
+struct ShapeBounds {
+    std::vector<float> centerX;
+    std::vector<float> centerY;
+    std::vector<float> centerZ;
+    std::vector<float> radius;
+    std::vector<float> minX;
+    std::vector<float> minY;
+    std::vector<float> minZ;
+    std::vector<float> maxX;
+    std::vector<float> maxY;
+    std::vector<float> maxZ;
+
+    inline std::size_t size() const { return radius.size(); };
+
+    inline void push(const BoundingSphere &sphere, const AABB &box) {
+        centerX.push_back(sphere.center.x);
+        centerY.push_back(sphere.center.y);
+        centerZ.push_back(sphere.center.z);
+        radius.push_back(sphere.radius);
+        minX.push_back(box.min.x);
+        minY.push_back(box.min.y);
+        minZ.push_back(box.min.z);
+        maxX.push_back(box.max.x);
+        maxY.push_back(box.max.y);
+        maxZ.push_back(box.max.z);
+    };
+
+    inline void set(const std::size_t &index, const BoundingSphere &sphere,
+                    const AABB &box) {
+        centerX[index] = sphere.center.x;
+        centerY[index] = sphere.center.y;
+        centerZ[index] = sphere.center.z;
+        radius[index] = sphere.radius;
+        minX[index] = box.min.x;
+        minY[index] = box.min.y;
+        minZ[index] = box.min.z;
+        maxX[index] = box.max.x;
+        maxY[index] = box.max.y;
+        maxZ[index] = box.max.z;
+    };
+
+    inline BoundingSphere getSphere(const std::size_t &index) const {
+        return { .center = { centerX[index], centerY[index], centerZ[index] },
+                 .radius = radius[index] };
+    };
+
+    inline AABB getAABB(const std::size_t &index) const {
+        return { .min = { minX[index], minY[index], minZ[index] },
+                 .max = { maxX[index], maxY[index], maxZ[index] } };
+    };
+
+    inline std::vector<AABB> getAABBs() const {
+        std::vector<AABB> boxes;
+        boxes.reserve(size());
+        for (std::size_t i = 0; i < size(); i++) {
+            boxes.push_back(getAABB(i));
+        };
+        return boxes;
+    };
+};
+
+struct Ray {
+    glm::vec3 origin;
+    glm::vec3 direction;
+};
+
+// Planes are stored as (normal, distance) with normals pointing inside, so a
+// point p is inside a plane when dot(normal, p) + distance >= 0.
+struct Frustum {
+    std::array<glm::vec4, 6> planes;
+
+    static Frustum fromMatrix(const glm::mat4 &viewProjection) {
+        const auto &row = [&viewProjection](int i) {
+            return glm::vec4(viewProjection[0][i], viewProjection[1][i],
+                             viewProjection[2][i], viewProjection[3][i]);
+        };
+        Frustum frustum = { .planes = {
+                                row(3) + row(0),
+                                row(3) - row(0),
+                                row(3) + row(1),
+                                row(3) - row(1),
+                                row(3) + row(2),
+                                row(3) - row(2),
+                            } };
+        for (auto &plane : frustum.planes) {
+            plane /= glm::length(glm::vec3(plane));
+        };
+        return frustum;
+    };
+
+    inline bool intersects(const BoundingSphere &sphere) const {
+        for (const auto &plane : planes) {
+            if (glm::dot(glm::vec3(plane), sphere.center) + plane.w <
+                -sphere.radius) {
+                return false;
+            };
+        };
+        return true;
+    };
+};
@@ -0,0 +1,269 @@
+#include "./bvh.hpp"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <future>
+#include <limits>
+#include <optional>
+#include <span>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "glm/common.hpp"
+#include "glm/ext/vector_float3.hpp"
+#include "vulkan_app/app/bounds.hpp"
+
+namespace {
+constexpr unsigned int binCount = 16;
+
+struct SAHBin {
+    AABB bounds;
+    uint32_t count = 0;
+};
+
+struct SAHSplit {
+    int axis = -1;
+    unsigned int bin = 0;
+    float cost = std::numeric_limits<float>::max();
+};
+
+std::optional<float> intersectAABB(const Ray &ray,
+                                   const glm::vec3 &invDirection,
+                                   const AABB &box, const float &maxDistance) {
+    const auto &t1 = (box.min - ray.origin) * invDirection;
+    const auto &t2 = (box.max - ray.origin) * invDirection;
+    const auto &tNear = glm::min(t1, t2);
+    const auto &tFar = glm::max(t1, t2);
+    const float entry = std::max({ tNear.x, tNear.y, tNear.z, 0.0f });
+    const float exit = std::min({ tFar.x, tFar.y, tFar.z, maxDistance });
+    if (entry > exit) return std::nullopt;
+    return entry;
+};
+};  // namespace
+
+void BVH::build(std::span<const AABB> bounds) {
+    nodes.clear();
+    primitiveBounds.assign(bounds.begin(), bounds.end());
+    primitiveIndices.resize(bounds.size());
+    centroids.resize(bounds.size());
+    for (uint32_t i = 0; i < bounds.size(); i++) {
+        primitiveIndices[i] = i;
+        centroids[i] = bounds[i].center();
+    };
+    if (bounds.empty()) return;
+    unsigned int parallelDepth = 0;
+    if (bounds.size() >= parallelBuildThreshold) {
+        parallelDepth = std::bit_width(
+                            std::max(std::thread::hardware_concurrency(), 1u)) -
+                        1;
+    };
+    nodes.reserve(bounds.size() * 2 / maxLeafSize + 1);
+    buildNode(nodes, 0, static_cast<uint32_t>(bounds.size()), 0,
+              parallelDepth);
+};
+
+uint32_t BVH::buildNode(std::vector<BVHNode> &out, const uint32_t &first,
+                        const uint32_t &count, const unsigned int &depth,
+                        const unsigned int &parallelDepth) {
+    AABB nodeBounds;
+    AABB centroidBounds;
+    for (uint32_t i = first; i < first + count; i++) {
+        const auto &primitive = primitiveIndices[i];
+        nodeBounds.expand(primitiveBounds[primitive]);
+        centroidBounds.expand(centroids[primitive]);
+    };
+    const auto nodeIndex = static_cast<uint32_t>(out.size());
+    out.push_back({ .bounds = nodeBounds,
+                    .left = 0,
+                    .right = 0,
+                    .firstPrimitive = first,
+                    .primitiveCount = count });
+    if (count <= maxLeafSize) return nodeIndex;
+
+    const auto &centroidExtent = centroidBounds.extent();
+    SAHSplit best;
+    for (int axis = 0; axis < 3; axis++) {
+        if (depth >= maxSAHDepth || centroidExtent[axis] <= 0.0f) continue;
+        const float scale = binCount / centroidExtent[axis];
+        std::array<SAHBin, binCount> bins;
+        for (uint32_t i = first; i < first + count; i++) {
+            const auto &primitive = primitiveIndices[i];
+            const auto bin = std::min(
+                binCount - 1,
+                static_cast<unsigned int>(
+                    (centroids[primitive][axis] - centroidBounds.min[axis]) *
+                    scale));
+            bins[bin].bounds.expand(primitiveBounds[primitive]);
+            bins[bin].count++;
+        };
+        std::array<float, binCount - 1> leftCost;
+        AABB leftBounds;
+        uint32_t leftCount = 0;
+        for (unsigned int i = 0; i < binCount - 1; i++) {
+            leftBounds.expand(bins[i].bounds);
+            leftCount += bins[i].count;
+            leftCost[i] = leftCount * leftBounds.surfaceArea();
+        };
+        AABB rightBounds;
+        uint32_t rightCount = 0;
+        for (unsigned int i = binCount - 1; i > 0; i--) {
+            rightBounds.expand(bins[i].bounds);
+            rightCount += bins[i].count;
+            const float cost =
+                leftCost[i - 1] + rightCount * rightBounds.surfaceArea();
+            if (cost < best.cost) {
+                best = { .axis = axis, .bin = i, .cost = cost };
+            };
+        };
+    };
+
+    uint32_t middle = first + count / 2;
+    if (best.axis >= 0) {
+        const float leafCost = count * nodeBounds.surfaceArea();
+        if (best.cost >= leafCost && count <= maxLeafSize * 4) {
+            return nodeIndex;
+        };
+        const int axis = best.axis;
+        const float scale = binCount / centroidExtent[axis];
+        const float axisMin = centroidBounds.min[axis];
+        const auto &it = std::partition(
+            primitiveIndices.begin() + first,
+            primitiveIndices.begin() + first + count,
+            [this, axis, scale, axisMin, &best](const uint32_t &primitive) {
+                const auto bin = std::min(
+                    binCount - 1,
+                    static_cast<unsigned int>(
+                        (centroids[primitive][axis] - axisMin) * scale));
+                return bin < best.bin;
+            });
+        middle = static_cast<uint32_t>(it - primitiveIndices.begin());
+    };
+    if (middle == first || middle == first + count) {
+        middle = first + count / 2;
+    };
+
+    const uint32_t leftCount = middle - first;
+    const uint32_t rightCount = count - leftCount;
+    uint32_t left;
+    uint32_t right;
+    if (parallelDepth > 0 && count >= parallelBuildThreshold) {
+        std::vector<BVHNode> rightNodes;
+        rightNodes.reserve(rightCount * 2 / maxLeafSize + 1);
+        auto rightTask = std::async(
+            std::launch::async,
+            [this, &rightNodes, middle, rightCount, depth, parallelDepth]() {
+                buildNode(rightNodes, middle, rightCount, depth + 1,
+                          parallelDepth - 1);
+            });
+        left = buildNode(out, first, leftCount, depth + 1, parallelDepth - 1);
+        rightTask.get();
+        right = static_cast<uint32_t>(out.size());
+        for (auto &node : rightNodes) {
+            if (!node.isLeaf()) {
+                node.left += right;
+                node.right += right;
+            };
+            out.push_back(node);
+        };
+    } else {
+        left = buildNode(out, first, leftCount, depth + 1, parallelDepth);
+        right = buildNode(out, middle, rightCount, depth + 1, parallelDepth);
+    };
+    out[nodeIndex].left = left;
+    out[nodeIndex].right = right;
+    out[nodeIndex].primitiveCount = 0;
+    return nodeIndex;
+};
+
+void BVH::refit(const ShapeBounds &bounds) {
+    if (bounds.size() != primitiveBounds.size()) {
+        build(bounds.getAABBs());
+        return;
+    };
+    for (uint32_t i = 0; i < bounds.size(); i++) {
+        primitiveBounds[i] = bounds.getAABB(i);
+        centroids[i] = primitiveBounds[i].center();
+    };
+    // Children are always stored after their parent, so a reverse sweep
+    // visits every node after both of its children.
+    for (auto it = nodes.rbegin(); it != nodes.rend(); it++) {
+        auto &node = *it;
+        node.bounds = AABB();
+        if (node.isLeaf()) {
+            for (uint32_t i = node.firstPrimitive;
+                 i < node.firstPrimitive + node.primitiveCount; i++) {
+                node.bounds.expand(primitiveBounds[primitiveIndices[i]]);
+            };
+        } else {
+            node.bounds.expand(nodes[node.left].bounds);
+            node.bounds.expand(nodes[node.right].bounds);
+        };
+    };
+};
+
+std::optional<BVHRayHit> BVH::intersectRay(const Ray &ray) const {
+    return intersectRay(ray, nullptr);
+};
+
+std::optional<BVHRayHit> BVH::intersectRay(
+    const Ray &ray, const BVHPrimitiveIntersector &intersector) const {
+    if (nodes.empty()) return std::nullopt;
+    const auto &invDirection = 1.0f / ray.direction;
+    std::optional<BVHRayHit> closest;
+    float closestDistance = std::numeric_limits<float>::max();
+    const auto &rootEntry =
+        intersectAABB(ray, invDirection, nodes[0].bounds, closestDistance);
+    if (!rootEntry.has_value()) return std::nullopt;
+    std::array<std::pair<uint32_t, float>, traversalStackSize> stack;
+    std::size_t stackSize = 0;
+    stack[stackSize++] = { 0, rootEntry.value() };
+    while (stackSize > 0) {
+        const auto [nodeIndex, entry] = stack[--stackSize];
+        if (entry > closestDistance) continue;
+        const auto &node = nodes[nodeIndex];
+        if (node.isLeaf()) {
+            for (uint32_t i = node.firstPrimitive;
+                 i < node.firstPrimitive + node.primitiveCount; i++) {
+                const auto &primitive = primitiveIndices[i];
+                auto distance =
+                    intersectAABB(ray, invDirection,
+                                  primitiveBounds[primitive], closestDistance);
+                if (!distance.has_value()) continue;
+                if (intersector) {
+                    distance = intersector(primitive);
+                };
+                if (distance.has_value() &&
+                    distance.value() < closestDistance) {
+                    closestDistance = distance.value();
+                    closest = { .primitiveIndex = primitive,
+                                .distance = closestDistance };
+                };
+            };
+            continue;
+        };
+        const auto &leftEntry = intersectAABB(
+            ray, invDirection, nodes[node.left].bounds, closestDistance);
+        const auto &rightEntry = intersectAABB(
+            ray, invDirection, nodes[node.right].bounds, closestDistance);
+        if (leftEntry.has_value() && rightEntry.has_value()) {
+            // Push the farther child first so the nearer one is visited
+            // first and can shrink closestDistance for its sibling.
+            if (leftEntry.value() <= rightEntry.value()) {
+                stack[stackSize++] = { node.right, rightEntry.value() };
+                stack[stackSize++] = { node.left, leftEntry.value() };
+            } else {
+                stack[stackSize++] = { node.left, leftEntry.value() };
+                stack[stackSize++] = { node.right, rightEntry.value() };
+            };
+        } else if (leftEntry.has_value()) {
+            stack[stackSize++] = { node.left, leftEntry.value() };
+        } else if (rightEntry.has_value()) {
+            stack[stackSize++] = { node.right, rightEntry.value() };
+        };
+    };
+    return closest;
+};
@@ -0,0 +1,59 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <optional>
+#include <span>
+#include <vector>
+
+#include "vulkan_app/app/bounds.hpp"
+
+struct BVHNode {
+    AABB bounds;
+    uint32_t left;
+    uint32_t right;
+    uint32_t firstPrimitive;
+    uint32_t primitiveCount;
+
+    inline bool isLeaf() const { return primitiveCount != 0; };
+};
+
+struct BVHRayHit {
+    uint32_t primitiveIndex;
+    float distance;
+};
+
+// Returns the distance along the ray to the primitive, or nothing on a miss.
+using BVHPrimitiveIntersector =
+    std::function<std::optional<float>(uint32_t primitiveIndex)>;
+
+class BVH {
+    std::vector<BVHNode> nodes;
+    std::vector<uint32_t> primitiveIndices;
+    std::vector<AABB> primitiveBounds;
+    std::vector<glm::vec3> centroids;
+
+    uint32_t buildNode(std::vector<BVHNode> &out, const uint32_t &first,
+                       const uint32_t &count, const unsigned int &depth,
+                       const unsigned int &parallelDepth);
+
+public:
+    static constexpr uint32_t maxLeafSize = 4;
+    static constexpr uint32_t parallelBuildThreshold = 4096;
+    // Nodes this deep are split at the median instead of by the SAH, so
+    // with fewer than 2^32 primitives no path from the root is longer than
+    // this plus 30 nodes, and traversal fits a fixed stack.
+    static constexpr unsigned int maxSAHDepth = 32;
+    static constexpr std::size_t traversalStackSize = 64;
+
+    void build(std::span<const AABB> bounds);
+    // Rebuilds instead if the number of shapes changed.
+    void refit(const ShapeBounds &bounds);
+    std::optional<BVHRayHit> intersectRay(const Ray &ray) const;
+    std::optional<BVHRayHit> intersectRay(
+        const Ray &ray, const BVHPrimitiveIntersector &intersector) const;
+
+    inline std::span<const BVHNode> getNodes() const { return nodes; };
+    inline bool isEmpty() const { return nodes.empty(); };
+};
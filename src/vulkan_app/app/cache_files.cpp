@@ -0,0 +1,103 @@
+#include "./cache_files.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#if defined(_WIN32)
+#include <windows.h>
+
+#include <atomic>
+#include <format>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <cerrno>
+#endif
+
+std::filesystem::path cacheDirectory() {
+    if (const char *cacheHome = std::getenv("XDG_CACHE_HOME")) {
+        return std::filesystem::path(cacheHome) / "vulkan-graphics";
+    };
+    if (const char *home = std::getenv("HOME")) {
+        return std::filesystem::path(home) / ".cache" / "vulkan-graphics";
+    };
+    return std::filesystem::temp_directory_path() / "vulkan-graphics";
+};
+
+std::vector<uint8_t> readCacheFile(const std::filesystem::path &path) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file) return {};
+    return std::vector<uint8_t>(std::istreambuf_iterator<char>(file), {});
+};
+
+#if defined(_WIN32)
+void writeFileAtomically(const std::filesystem::path &path,
+                         const std::span<const uint8_t> &data) {
+    std::filesystem::create_directories(path.parent_path());
+    // Unique per process and call, so concurrent writers never share one.
+    static std::atomic<uint32_t> writeCount = 0;
+    auto temporaryPath = path;
+    temporaryPath += std::format(".{}-{}.tmp", GetCurrentProcessId(),
+                                 writeCount++);
+    HANDLE file = CreateFileW(temporaryPath.c_str(), GENERIC_WRITE, 0,
+                              nullptr, CREATE_NEW, FILE_ATTRIBUTE_NORMAL,
+                              nullptr);
+    if (file == INVALID_HANDLE_VALUE) {
+        throw std::runtime_error("Failed to create " + temporaryPath.string());
+    };
+    DWORD written = 0;
+    const bool isWritten =
+        WriteFile(file, data.data(), static_cast<DWORD>(data.size()),
+                  &written, nullptr) &&
+        written == data.size() && FlushFileBuffers(file);
+    CloseHandle(file);
+    if (!isWritten ||
+        !MoveFileExW(temporaryPath.c_str(), path.c_str(),
+                     MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH)) {
+        DeleteFileW(temporaryPath.c_str());
+        throw std::runtime_error("Failed to write " + path.string());
+    };
+};
+#else
+void writeFileAtomically(const std::filesystem::path &path,
+                         const std::span<const uint8_t> &data) {
+    std::filesystem::create_directories(path.parent_path());
+    // mkstemp picks a name no other writer is using.
+    std::string temporaryPath = path.string() + ".XXXXXX";
+    const int descriptor = mkstemp(temporaryPath.data());
+    if (descriptor < 0) {
+        throw std::runtime_error("Failed to create " + temporaryPath);
+    };
+    std::size_t written = 0;
+    while (written < data.size()) {
+        const auto &result = write(descriptor, data.data() + written,
+                                   data.size() - written);
+        if (result < 0 && errno == EINTR) continue;
+        if (result <= 0) break;
+        written += static_cast<std::size_t>(result);
+    };
+    // The contents reach the disk before the rename does, so a crash
+    // leaves either the old file or the whole new one.
+    const bool isWritten = written == data.size() && fsync(descriptor) == 0;
+    close(descriptor);
+    if (!isWritten || rename(temporaryPath.c_str(), path.c_str()) != 0) {
+        unlink(temporaryPath.c_str());
+        throw std::runtime_error("Failed to write " + path.string());
+    };
+    // Makes the rename itself durable.
+    const int directory = open(path.parent_path().c_str(), O_RDONLY);
+    if (directory >= 0) {
+        fsync(directory);
+        close(directory);
+    };
+};
+#endif
@@ -0,0 +1,19 @@
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <span>
+#include <vector>
+
+// Per-user cache root: $XDG_CACHE_HOME, ~/.cache or the temporary
+// directory, each with a vulkan-graphics subdirectory.
+std::filesystem::path cacheDirectory();
+
+// Returns no bytes when the file is missing or unreadable.
+std::vector<uint8_t> readCacheFile(const std::filesystem::path &path);
+
+// Writes a uniquely named file next to the destination, flushes it to disk
+// and renames it into place, so readers never see a partially written file
+// and concurrent writers never write into the same one.
+void writeFileAtomically(const std::filesystem::path &path,
+                         const std::span<const uint8_t> &data);
@@ -18,12 +18,10 @@
 #include "vulkan_app/vki/buffer.hpp"
 #include "vulkan_app/vki/command_buffer.hpp"
 #include "vulkan_app/vki/command_pool.hpp"
-#include "vulkan_app/vki/framebuffer.hpp"
 #include "vulkan_app/vki/graphics_pipeline.hpp"
 #include "vulkan_app/vki/memory.hpp"
 #include "vulkan_app/vki/pipeline_layout.hpp"
 #include "vulkan_app/vki/queue.hpp"
-#include "vulkan_app/vki/render_pass.hpp"
 #include "vulkan_app/vki/shader_module.hpp"
 #include "vulkan_app/vki/structs.hpp"
 #include "vulkan_app/vki/swapchain.hpp"
@@ -138,6 +136,64 @@ vki::Buffer createStagingBuffer(
     return stagingBuffer;
 };
 
+std::tuple<vki::Buffer, void *> createMappedStagingBuffer(
+    const vki::LogicalDevice &logicalDevice,
+    const VkPhysicalDeviceMemoryProperties &memoryProperties,
+    const std::size_t &size) {
+    return createMappedBuffer(logicalDevice, memoryProperties, size,
+                              VK_BUFFER_USAGE_TRANSFER_SRC_BIT);
+};
+
+std::tuple<vki::Buffer, void *> createMappedBuffer(
+    const vki::LogicalDevice &logicalDevice,
+    const VkPhysicalDeviceMemoryProperties &memoryProperties,
+    const std::size_t &size, const VkBufferUsageFlags &usage) {
+    VkBufferCreateInfo bufferCreateInfo = {
+        .sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO,
+        .size = size,
+        .usage = usage,
+        .sharingMode = VK_SHARING_MODE_EXCLUSIVE,
+    };
+    auto buffer = vki::Buffer(logicalDevice, bufferCreateInfo);
+    const auto &memoryRequirements = buffer.getMemoryRequirements();
+    VkMemoryAllocateInfo allocInfo = {
+        .sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO,
+        .allocationSize = memoryRequirements.size,
+        .memoryTypeIndex = vki::utils::findMemoryType(
+            memoryRequirements.memoryTypeBits, memoryProperties,
+            VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT |
+                VK_MEMORY_PROPERTY_HOST_COHERENT_BIT),
+    };
+    auto memory = vki::Memory(logicalDevice, allocInfo);
+    void *mapped;
+    memory.mapMemory(allocInfo.allocationSize, &mapped);
+    buffer.bindMemory(std::move(memory));
+    return { std::move(buffer), mapped };
+};
+
+vki::Buffer createDeviceLocalBuffer(
+    const vki::LogicalDevice &logicalDevice,
+    const VkPhysicalDeviceMemoryProperties &memoryProperties,
+    const std::size_t &size, const VkBufferUsageFlags &usage) {
+    VkBufferCreateInfo bufferCreateInfo = {
+        .sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO,
+        .size = size,
+        .usage = usage,
+        .sharingMode = VK_SHARING_MODE_EXCLUSIVE,
+    };
+    auto buffer = vki::Buffer(logicalDevice, bufferCreateInfo);
+    const auto &memoryRequirements = buffer.getMemoryRequirements();
+    VkMemoryAllocateInfo allocInfo = {
+        .sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO,
+        .allocationSize = memoryRequirements.size,
+        .memoryTypeIndex = vki::utils::findMemoryType(
+            memoryRequirements.memoryTypeBits, memoryProperties,
+            VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT),
+    };
+    buffer.bindMemory(vki::Memory(logicalDevice, allocInfo));
+    return buffer;
+};
+
 std::tuple<vki::Buffer, vki::Buffer> createVertexAndIndicesBuffer(
     const vki::LogicalDevice &logicalDevice,
     const VkPhysicalDeviceMemoryProperties &memoryProperties,
@@ -164,8 +220,8 @@ std::tuple<vki::Buffer, vki::Buffer> createVertexAndIndicesBuffer(
         logicalDevice, memoryProperties, logger, indexStagingBuffer,
         commandBuffer, graphicsQueue, indicesSize);
     commandBuffer.end();
-    graphicsQueue.submit({ vki::SubmitInfo((vki::SubmitInfoInputData){
-                             .commandBuffers = { &commandBuffer } }) },
+    graphicsQueue.submit(vki::SubmitInfo((vki::SubmitInfoInputData){
+                             .commandBuffers = { &commandBuffer } }),
                          std::nullopt);
     graphicsQueue.waitIdle();
     return { std::move(vertexBuffer), std::move(indicesBuffer) };
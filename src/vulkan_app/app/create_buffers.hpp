@@ -17,6 +17,25 @@ vki::Buffer createStagingBuffer(
     const vki::LogicalDevice &logicalDevice,
     const VkPhysicalDeviceMemoryProperties &memoryProperties,
     el::Logger &logger, const std::size_t &size, void *data);
+
+// The buffer stays mapped for its whole lifetime so producers can write
+// into it directly, including from worker threads.
+std::tuple<vki::Buffer, void *> createMappedStagingBuffer(
+    const vki::LogicalDevice &logicalDevice,
+    const VkPhysicalDeviceMemoryProperties &memoryProperties,
+    const std::size_t &size);
+
+// Host-visible and coherent, mapped for the buffer's whole lifetime.
+std::tuple<vki::Buffer, void *> createMappedBuffer(
+    const vki::LogicalDevice &logicalDevice,
+    const VkPhysicalDeviceMemoryProperties &memoryProperties,
+    const std::size_t &size, const VkBufferUsageFlags &usage);
+
+vki::Buffer createDeviceLocalBuffer(
+    const vki::LogicalDevice &logicalDevice,
+    const VkPhysicalDeviceMemoryProperties &memoryProperties,
+    const std::size_t &size, const VkBufferUsageFlags &usage);
+
 std::tuple<vki::Buffer, vki::Buffer> createVertexAndIndicesBuffer(
     const vki::LogicalDevice &logicalDevice,
     const VkPhysicalDeviceMemoryProperties &memoryProperties,
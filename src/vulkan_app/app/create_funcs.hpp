@@ -4,24 +4,27 @@
 
 #include <cstddef>
 #include <cstdint>
+#include <optional>
+#include <span>
+#include <string_view>
 #include <tuple>
 #include <unordered_set>
 #include <vector>
 
 #include "easylogging++.h"
 #include "glfw_controller.hpp"
+#include "vulkan_app/app/asset_pack.hpp"
+#include "vulkan_app/app/texture_upload.hpp"
 #include "vulkan_app/vki/buffer.hpp"
 #include "vulkan_app/vki/command_pool.hpp"
 #include "vulkan_app/vki/descriptor_pool.hpp"
 #include "vulkan_app/vki/descriptor_set_layout.hpp"
-#include "vulkan_app/vki/framebuffer.hpp"
 #include "vulkan_app/vki/graphics_pipeline.hpp"
 #include "vulkan_app/vki/image.hpp"
 #include "vulkan_app/vki/image_view.hpp"
 #include "vulkan_app/vki/pipeline_layout.hpp"
 #include "vulkan_app/vki/queue.hpp"
 #include "vulkan_app/vki/queue_family.hpp"
-#include "vulkan_app/vki/render_pass.hpp"
 #include "vulkan_app/vki/sampler.hpp"
 #include "vulkan_app/vki/surface.hpp"
 #include "vulkan_app/vki/swapchain.hpp"
@@ -34,31 +37,11 @@ VkExtent2D chooseSwapExtent(const VkSurfaceCapabilitiesKHR &capabilities,
 vki::PresentMode choosePresentMode(
     const std::unordered_set<vki::PresentMode> &presentModes);
 
-std::vector<VkDescriptorSet> createDescriptorSets(
-    const vki::LogicalDevice &logicalDevice,
-    const std::vector<vki::Buffer> &uniformBuffers,
-    const vki::DescriptorPool &descriptorPool,
-    const vki::DescriptorSetLayout &descriptorSetLayout,
-    const vki::Sampler &textureSampler, const vki::ImageView &textureImageView,
-    el::Logger &logger);
-
-vki::DescriptorPool createDescriptorPool(
-    const vki::LogicalDevice &logicalDevice,
-    const uint32_t &uniformBuffersCount);
-
-vki::RenderPass createRenderPass(const vki::LogicalDevice &logicalDevice,
-                                 const VkFormat &swapchainFormat,
-                                 const VkFormat &depthFormat,
-                                 const VkSampleCountFlagBits &sampleCount);
-
-vki::DescriptorSetLayout createDescriptorSetLayout(
-    const vki::LogicalDevice &logicalDevice);
-
-std::vector<vki::Framebuffer> createFramebuffers(
-    const vki::LogicalDevice &logicalDevice, const vki::Swapchain &swapchain,
-    const VkExtent2D &swapchainExtent, const vki::RenderPass &renderPass,
-    const vki::ImageView &depthImageView,
-    const vki::ImageView &multisampleImageView);
+// Writes the image into the given slot of the bindless texture array.
+void writeBindlessTexture(const vki::LogicalDevice &logicalDevice,
+                          const VkDescriptorSet &descriptorSet,
+                          const uint32_t &textureIndex,
+                          const vki::ImageView &textureImageView);
 
 vki::PhysicalDevice pickPhysicalDevice(const vki::VulkanInstance &instance,
                                        const vki::Surface &surface,
@@ -72,27 +55,53 @@ vki::Sampler createTextureSampler(
     const vki::LogicalDevice &logicalDevice,
     const VkPhysicalDeviceProperties &deviceProperties);
 
+// Creates the image and view of a texture without filling it, for uploads
+// recorded into a frame's command buffer.
+std::tuple<vki::Image, vki::ImageView> createEmptyTextureImage(
+    const vki::LogicalDevice &logicalDevice,
+    const VkPhysicalDeviceMemoryProperties &memoryProperties,
+    const TextureUpload &upload);
+
+// Copies the staged levels into an image fresh from createEmptyTextureImage,
+// generates any levels the upload lacks, and leaves every level ready for
+// fragment shaders.
+void recordTextureUpload(const vki::CommandBuffer &commandBuffer,
+                         const vki::Image &image,
+                         const vki::Buffer &stagingBuffer,
+                         const TextureUpload &upload);
+
+// Fills an image fresh from createEmptyTextureImage that replaces a
+// texture's previous image. Levels are numbered from the texture's finest:
+// the image starts at level and the previous one at previousLevel. The
+// levels they share are copied on the device, so only the finer ones, if
+// any, come from the staging buffer. The previous image is left as a
+// transfer source.
+void recordTextureLevelChange(const vki::CommandBuffer &commandBuffer,
+                              const vki::Image &previousImage,
+                              const uint32_t &previousLevel,
+                              const vki::Image &image, const uint32_t &level,
+                              const std::optional<vki::Buffer> &stagingBuffer,
+                              const TextureUpload &upload);
+
+// Uploads and waits for the queue to go idle.
 std::tuple<vki::Image, vki::ImageView> createTextureImage(
     const vki::LogicalDevice &logicalDevice,
     const vki::CommandPool &commandPool,
     const VkPhysicalDeviceMemoryProperties &memoryProperties,
-    el::Logger &logger, const vki::GraphicsQueueMixin &queue);
+    el::Logger &logger, const vki::GraphicsQueueMixin &queue,
+    const vki::Buffer &stagingBuffer, const TextureUpload &upload);
 
-std::tuple<vki::Image, vki::ImageView> createDepthImage(
+std::tuple<vki::Image, vki::ImageView> createPlaceholderTexture(
     const vki::LogicalDevice &logicalDevice,
-    const vki::CommandPool &commandPool, const VkFormat &depthFormat,
-    const VkSampleCountFlagBits &sampleCount,
+    const vki::CommandPool &commandPool,
     const VkPhysicalDeviceMemoryProperties &memoryProperties,
-    const VkExtent2D &swapchainExtent, el::Logger &logger,
-    const vki::GraphicsQueueMixin &queue);
+    el::Logger &logger, const vki::GraphicsQueueMixin &queue);
 
 VkFormat findDepthFormat(const vki::PhysicalDevice &physicalDevice);
 
-VkSampleCountFlagBits getMaxUsableSampleCount(
-    const vki::PhysicalDevice &physicalDevice);
-
-std::tuple<vki::Image, vki::ImageView> createMultisampleImage(
-    const vki::LogicalDevice &logicalDevice, const VkFormat &swapchainFormat,
-    const VkExtent2D &swapchainExtent, const VkSampleCountFlagBits &sampleCount,
-    const VkPhysicalDeviceMemoryProperties &memoryProperties,
-    el::Logger &logger, const vki::GraphicsQueueMixin &queue);
+// Returns the first candidate asset the device can sample from: KTX2
+// sources need their block format to be supported, JPEG and PNG always
+// decode to RGBA8. Candidates after the chosen one are never decompressed.
+std::span<const uint8_t> pickTextureSource(
+    const vki::PhysicalDevice &physicalDevice, AssetPack &assets,
+    const std::vector<std::string_view> &candidates);
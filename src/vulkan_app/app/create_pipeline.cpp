@@ -2,50 +2,60 @@
 
 #include <vulkan/vulkan_core.h>
 
-#include "easylogging++.h"
-#include "shaders.hpp"
+#include <array>
+#include <cstdint>
+#include <string_view>
+
+#include "embedded_resources.hpp"
+#include "vulkan_app/app/pipeline_description.hpp"
 #include "vulkan_app/app/vertex.hpp"
-#include "vulkan_app/vki/descriptor_set_layout.hpp"
+#include "vulkan_app/vki/compute_pipeline.hpp"
 #include "vulkan_app/vki/graphics_pipeline.hpp"
 #include "vulkan_app/vki/logical_device.hpp"
+#include "vulkan_app/vki/pipeline_cache.hpp"
 #include "vulkan_app/vki/pipeline_layout.hpp"
-#include "vulkan_app/vki/render_pass.hpp"
 #include "vulkan_app/vki/shader_module.hpp"
 
-vki::PipelineLayout createPipelineLayout(
-    const vki::LogicalDevice &logicalDevice,
-    const vki::DescriptorSetLayout &descriptorSetLayout) {
-    const auto &setLayout = descriptorSetLayout.getVkDescriptorSetLayout();
-    VkPipelineLayoutCreateInfo pipelineLayoutCreateInfo = {
-        .sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO,
-        .setLayoutCount = 1,
-        .pSetLayouts = &setLayout
-    };
-    return vki::PipelineLayout(logicalDevice, pipelineLayoutCreateInfo);
-};
-
 vki::GraphicsPipeline createGraphicsPipeline(
-    const vki::LogicalDevice &logicalDevice, el::Logger &logger,
-    VkExtent2D swapchainExtent, const vki::RenderPass &renderPass,
+    const vki::LogicalDevice &logicalDevice,
+    const PipelineDescription &description,
     const vki::PipelineLayout &pipelineLayout,
-    const VkSampleCountFlagBits& sampleCount) {
-    auto vertShader = vki::ShaderModule(logicalDevice, vertShaderCode);
-    auto fragmentShader = vki::ShaderModule(logicalDevice, fragShaderCode);
-    auto bindingDescription = Vertex::getBindingDescription();
-    auto attributeDescriptions = Vertex::getAttributeDescriptions();
+    const vki::PipelineCache &pipelineCache) {
+    auto vertShader = vki::ShaderModule(
+        logicalDevice,
+        embeddedResources.find(description.vertexShader).words());
+    auto fragmentShader = vki::ShaderModule(
+        logicalDevice,
+        embeddedResources.find(description.fragmentShader).words());
+    const auto &bindingDescription = Vertex::getBindingDescription();
+    const auto &attributeDescriptions = Vertex::getAttributeDescriptions();
     VkPipelineVertexInputStateCreateInfo vertexInputCreateInfo = {
         .sType = VK_STRUCTURE_TYPE_PIPELINE_VERTEX_INPUT_STATE_CREATE_INFO,
         .vertexBindingDescriptionCount = 1,
         .pVertexBindingDescriptions = &bindingDescription,
-        .vertexAttributeDescriptionCount = attributeDescriptions.size(),
+        .vertexAttributeDescriptionCount =
+            static_cast<uint32_t>(attributeDescriptions.size()),
         .pVertexAttributeDescriptions = attributeDescriptions.data()
     };
+    if (!description.hasVertexInput) {
+        vertexInputCreateInfo.vertexBindingDescriptionCount = 0;
+        vertexInputCreateInfo.vertexAttributeDescriptionCount = 0;
+    };
+
+    const auto &specializationEntries = ShaderSpecialization::getMapEntries();
+    VkSpecializationInfo specializationInfo = {
+        .mapEntryCount = static_cast<uint32_t>(specializationEntries.size()),
+        .pMapEntries = specializationEntries.data(),
+        .dataSize = sizeof(ShaderSpecialization),
+        .pData = &description.specialization,
+    };
 
     VkPipelineShaderStageCreateInfo vertexShaderCreateInfo = {
         .sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO,
         .stage = VK_SHADER_STAGE_VERTEX_BIT,
         .module = vertShader.getVkShaderModule(),
         .pName = "main",
+        .pSpecializationInfo = &specializationInfo,
     };
 
     VkPipelineShaderStageCreateInfo fragmentShaderCreateInfo = {
@@ -53,6 +63,7 @@ vki::GraphicsPipeline createGraphicsPipeline(
         .stage = VK_SHADER_STAGE_FRAGMENT_BIT,
         .module = fragmentShader.getVkShaderModule(),
         .pName = "main",
+        .pSpecializationInfo = &specializationInfo,
     };
 
     VkPipelineShaderStageCreateInfo shaderStages[] = {
@@ -61,52 +72,45 @@ vki::GraphicsPipeline createGraphicsPipeline(
 
     VkPipelineInputAssemblyStateCreateInfo pipelineInputAssemblyCreateInfo = {
         .sType = VK_STRUCTURE_TYPE_PIPELINE_INPUT_ASSEMBLY_STATE_CREATE_INFO,
-        .topology = VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST,
+        .topology = description.topology,
         .primitiveRestartEnable = VK_FALSE,
     };
 
-    VkViewport viewport = {
-        .x = 0.0f,
-        .y = 0.0f,
-        .width = static_cast<float>(swapchainExtent.width),
-        .height = static_cast<float>(swapchainExtent.height),
-        .minDepth = 0.0f,
-        .maxDepth = 1.0f,
-    };
-
-    VkRect2D scissor = { .offset = { .x = 100, .y = 100 },
-                         .extent = swapchainExtent };
+    // Viewport and scissor are dynamic, only their count is baked.
     VkPipelineViewportStateCreateInfo viewportCreateInfo = {
         .sType = VK_STRUCTURE_TYPE_PIPELINE_VIEWPORT_STATE_CREATE_INFO,
         .viewportCount = 1,
-        .pViewports = &viewport,
         .scissorCount = 1,
-        .pScissors = &scissor,
     };
 
     VkPipelineRasterizationStateCreateInfo rasterizer = {
         .sType = VK_STRUCTURE_TYPE_PIPELINE_RASTERIZATION_STATE_CREATE_INFO,
         .depthClampEnable = VK_FALSE,
         .rasterizerDiscardEnable = VK_FALSE,
-        .polygonMode = VK_POLYGON_MODE_FILL,
-        .cullMode = VK_CULL_MODE_NONE,
-        .frontFace = VK_FRONT_FACE_COUNTER_CLOCKWISE,
+        .polygonMode = description.polygonMode,
+        .frontFace = description.frontFace,
         .depthBiasEnable = VK_FALSE,
         .lineWidth = 1.0f,
     };
 
     VkPipelineMultisampleStateCreateInfo multisample = {
         .sType = VK_STRUCTURE_TYPE_PIPELINE_MULTISAMPLE_STATE_CREATE_INFO,
-        .rasterizationSamples = sampleCount,
-        .sampleShadingEnable = VK_TRUE,
-        .minSampleShading = 0.3f,
+        .rasterizationSamples = description.sampleCount,
+        .sampleShadingEnable = description.minSampleShading > 0.0f,
+        .minSampleShading = description.minSampleShading,
         .pSampleMask = nullptr,
         .alphaToCoverageEnable = VK_FALSE,
         .alphaToOneEnable = VK_FALSE,
     };
 
     VkPipelineColorBlendAttachmentState colorBlendAttachment = {
-        .blendEnable = VK_FALSE,
+        .blendEnable = description.isBlendEnabled,
+        .srcColorBlendFactor = VK_BLEND_FACTOR_SRC_ALPHA,
+        .dstColorBlendFactor = VK_BLEND_FACTOR_ONE_MINUS_SRC_ALPHA,
+        .colorBlendOp = VK_BLEND_OP_ADD,
+        .srcAlphaBlendFactor = VK_BLEND_FACTOR_ONE,
+        .dstAlphaBlendFactor = VK_BLEND_FACTOR_ONE_MINUS_SRC_ALPHA,
+        .alphaBlendOp = VK_BLEND_OP_ADD,
         .colorWriteMask = VK_COLOR_COMPONENT_R_BIT | VK_COLOR_COMPONENT_G_BIT |
                           VK_COLOR_COMPONENT_B_BIT | VK_COLOR_COMPONENT_A_BIT
     };
@@ -120,9 +124,7 @@ vki::GraphicsPipeline createGraphicsPipeline(
 
     VkPipelineDepthStencilStateCreateInfo depthStencilCreateInfo = {
         .sType = VK_STRUCTURE_TYPE_PIPELINE_DEPTH_STENCIL_STATE_CREATE_INFO,
-        .depthTestEnable = VK_TRUE,
-        .depthWriteEnable = VK_TRUE,
-        .depthCompareOp = VK_COMPARE_OP_LESS,
+        .depthCompareOp = description.depthCompareOp,
         .depthBoundsTestEnable = VK_FALSE,
         .minDepthBounds = 0,
         .maxDepthBounds = 1.0f,
@@ -131,8 +133,27 @@ vki::GraphicsPipeline createGraphicsPipeline(
         .back = {}
     };
 
+    // Core in Vulkan 1.3, which device selection requires.
+    std::array dynamicStates = { VK_DYNAMIC_STATE_VIEWPORT,
+                                 VK_DYNAMIC_STATE_SCISSOR,
+                                 VK_DYNAMIC_STATE_CULL_MODE,
+                                 VK_DYNAMIC_STATE_DEPTH_TEST_ENABLE,
+                                 VK_DYNAMIC_STATE_DEPTH_WRITE_ENABLE };
+    VkPipelineDynamicStateCreateInfo dynamicState = {
+        .sType = VK_STRUCTURE_TYPE_PIPELINE_DYNAMIC_STATE_CREATE_INFO,
+        .dynamicStateCount = static_cast<uint32_t>(dynamicStates.size()),
+        .pDynamicStates = dynamicStates.data(),
+    };
+
+    VkPipelineRenderingCreateInfo renderingCreateInfo = {
+        .sType = VK_STRUCTURE_TYPE_PIPELINE_RENDERING_CREATE_INFO,
+        .colorAttachmentCount = 1,
+        .pColorAttachmentFormats = &description.colorAttachmentFormat,
+        .depthAttachmentFormat = description.depthAttachmentFormat,
+    };
     VkGraphicsPipelineCreateInfo pipelineInfo = {
         .sType = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO,
+        .pNext = &renderingCreateInfo,
         .stageCount = 2,
         .pStages = shaderStages,
         .pVertexInputState = &vertexInputCreateInfo,
@@ -142,9 +163,26 @@ vki::GraphicsPipeline createGraphicsPipeline(
         .pMultisampleState = &multisample,
         .pDepthStencilState = &depthStencilCreateInfo,
         .pColorBlendState = &colorBlending,
+        .pDynamicState = &dynamicState,
+        .layout = pipelineLayout.getVkPipelineLayout(),
+    };
+    return vki::GraphicsPipeline(logicalDevice, pipelineInfo, pipelineCache);
+};
+
+vki::ComputePipeline createComputePipeline(
+    const vki::LogicalDevice &logicalDevice, const std::string_view &shader,
+    const vki::PipelineLayout &pipelineLayout,
+    const vki::PipelineCache &pipelineCache) {
+    auto shaderModule = vki::ShaderModule(
+        logicalDevice, embeddedResources.find(shader).words());
+    VkComputePipelineCreateInfo createInfo = {
+        .sType = VK_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO,
+        .stage = { .sType =
+                       VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO,
+                   .stage = VK_SHADER_STAGE_COMPUTE_BIT,
+                   .module = shaderModule.getVkShaderModule(),
+                   .pName = "main" },
         .layout = pipelineLayout.getVkPipelineLayout(),
-        .renderPass = renderPass.getVkRenderPass(),
-        .subpass = 0,
     };
-    return vki::GraphicsPipeline(logicalDevice, pipelineInfo);
+    return vki::ComputePipeline(logicalDevice, createInfo, pipelineCache);
 };
@@ -2,19 +2,23 @@
 
 #include <vulkan/vulkan_core.h>
 
-#include "easylogging++.h"
-#include "vulkan_app/vki/descriptor_set_layout.hpp"
+#include <string_view>
+
+#include "vulkan_app/app/pipeline_description.hpp"
+#include "vulkan_app/vki/compute_pipeline.hpp"
 #include "vulkan_app/vki/graphics_pipeline.hpp"
 #include "vulkan_app/vki/logical_device.hpp"
+#include "vulkan_app/vki/pipeline_cache.hpp"
 #include "vulkan_app/vki/pipeline_layout.hpp"
-#include "vulkan_app/vki/render_pass.hpp"
 
-vki::PipelineLayout createPipelineLayout(
+vki::GraphicsPipeline createGraphicsPipeline(
     const vki::LogicalDevice &logicalDevice,
-    const vki::DescriptorSetLayout &descriptorSetLayout);
+    const PipelineDescription &description,
+    const vki::PipelineLayout &pipelineLayout,
+    const vki::PipelineCache &pipelineCache);
 
-vki::GraphicsPipeline createGraphicsPipeline(
-    const vki::LogicalDevice &logicalDevice, el::Logger &logger,
-    VkExtent2D swapchainExtent, const vki::RenderPass &renderPass,
+// shader names a SPIR-V module in the embedded resource registry.
+vki::ComputePipeline createComputePipeline(
+    const vki::LogicalDevice &logicalDevice, const std::string_view &shader,
     const vki::PipelineLayout &pipelineLayout,
-    const VkSampleCountFlagBits &sampleCount);
+    const vki::PipelineCache &pipelineCache);
@@ -2,6 +2,7 @@
 
 #include <math.h>
 
+#include <algorithm>
 #include <array>
 #include <cassert>
 #include <cmath>
@@ -11,6 +12,8 @@
 #include <span>
 #include <vector>
 
+#include "vulkan_app/app/bounds.hpp"
+#include "vulkan_app/app/instance_data.hpp"
 #include "vulkan_app/app/vertex.hpp"
 struct ShapeData {
     uint32_t vertexOffset;
@@ -26,6 +29,11 @@ public:
     std::vector<Vertex> vertexArray;
     std::vector<uint32_t> indexArray;
     std::vector<ShapeData> shapes;
+    std::vector<InstanceData> instances;
+    ShapeBounds shapeBounds;
+    // Set when a shape's bounds are updated, until the structures built
+    // over them are refit.
+    bool areBoundsDirty = false;
 
     inline const std::span<const Vertex> getVertices() const {
         return vertexArray;
@@ -38,6 +46,53 @@ public:
     inline const std::span<const ShapeData> getObjectsOffsets() const {
         return shapes;
     };
+
+    inline const std::span<const InstanceData> getInstances() const {
+        return instances;
+    };
+
+    inline AABB computeShapeBounds(const ShapeData &shape) const {
+        AABB bounds;
+        for (uint32_t i = 0; i < shape.indexCount; i++) {
+            const auto &vertexIndex =
+                shape.vertexOffset + indexArray[shape.indexOffset + i];
+            bounds.expand(vertexArray[vertexIndex].pos);
+        };
+        return bounds;
+    };
+
+    inline BoundingSphere computeShapeSphere(const ShapeData &shape,
+                                             const AABB &bounds) const {
+        const auto &center = bounds.center();
+        float radiusSquared = 0.0f;
+        for (uint32_t i = 0; i < shape.indexCount; i++) {
+            const auto &vertexIndex =
+                shape.vertexOffset + indexArray[shape.indexOffset + i];
+            const auto &offset = vertexArray[vertexIndex].pos - center;
+            radiusSquared = std::max(radiusSquared, glm::dot(offset, offset));
+        };
+        return { .center = center, .radius = std::sqrt(radiusSquared) };
+    };
+
+    inline uint32_t addShape(const ShapeData &shape) {
+        const auto &bounds = computeShapeBounds(shape);
+        shapes.push_back(shape);
+        instances.push_back({ .textureIndex = 0 });
+        shapeBounds.push(computeShapeSphere(shape, bounds), bounds);
+        return shapes.size() - 1;
+    };
+
+    inline void updateShapeBounds(const uint32_t &shapeIndex) {
+        const auto &shape = shapes[shapeIndex];
+        const auto &bounds = computeShapeBounds(shape);
+        shapeBounds.set(shapeIndex, computeShapeSphere(shape, bounds), bounds);
+        areBoundsDirty = true;
+    };
+
+    inline void setShapeTexture(const uint32_t &shapeIndex,
+                                const uint32_t &textureIndex) {
+        instances[shapeIndex].textureIndex = textureIndex;
+    };
 };
 
 struct Triangle {
@@ -45,6 +100,7 @@ struct Triangle {
     std::array<uint32_t, 3> indices;
     uint32_t vertexOffset;
     uint32_t indexOffset;
+    uint32_t shapeIndex;
     explicit Triangle(DataAggregator &aggregator,
                       const std::array<Vertex, 3> &vertices,
                       const std::array<uint32_t, 3> &indices)
@@ -56,10 +112,11 @@ struct Triangle {
         };
         vertexOffset = aggregator.vertexArray.size() - 3;
         indexOffset = aggregator.indexArray.size() - 3;
-        aggregator.shapes.push_back((ShapeData){ .vertexOffset = vertexOffset,
-                                                 .indexOffset = indexOffset,
-                                                 .vertexCount = 3,
-                                                 .indexCount = 3 });
+        shapeIndex = aggregator.addShape((ShapeData){
+            .vertexOffset = vertexOffset,
+            .indexOffset = indexOffset,
+            .vertexCount = 3,
+            .indexCount = 3 });
     };
 
     void sync(DataAggregator &aggregator) const {
@@ -67,6 +124,7 @@ struct Triangle {
                sizeof(vertices[0]) * vertices.size());
         memcpy(&aggregator.indexArray[indexOffset], indices.data(),
                sizeof(indices[0]) * indices.size());
+        aggregator.updateShapeBounds(shapeIndex);
     };
 };
 
@@ -76,6 +134,7 @@ struct Circle {
     uint32_t vertexOffset;
     uint32_t indexOffset;
     uint32_t vertexCount;
+    uint32_t shapeIndex;
     explicit Circle(DataAggregator &aggregator, const float radius,
                     const uint32_t rings, const uint32_t segments) {
         assert(rings > 1);
@@ -117,7 +176,7 @@ struct Circle {
                        .subspan(vertexOffset, verticeIndex + 1);
         indices = std::span(aggregator.indexArray)
                       .subspan(indexOffset, verticeIndex * 6);
-        aggregator.shapes.push_back((ShapeData){
+        shapeIndex = aggregator.addShape((ShapeData){
             .vertexOffset = vertexOffset,
             .indexOffset = indexOffset,
             .vertexCount = verticeIndex + 1,
@@ -129,5 +188,6 @@ struct Circle {
                sizeof(vertices[0]) * vertices.size());
         memcpy(&aggregator.indexArray[indexOffset], indices.data(),
                sizeof(indices[0]) * indices.size());
+        aggregator.updateShapeBounds(shapeIndex);
     };
 };
@@ -0,0 +1,224 @@
+#include "./depth_pyramid.hpp"
+
+#include <vulkan/vulkan_core.h>
+
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <utility>
+
+#include "shaders.hpp"
+#include "vulkan_app/app/create_pipeline.hpp"
+#include "vulkan_app/app/descriptor_allocator.hpp"
+#include "vulkan_app/app/descriptor_layout_cache.hpp"
+#include "vulkan_app/app/spirv_reflection.hpp"
+#include "vulkan_app/vki/command_buffer.hpp"
+#include "vulkan_app/vki/compute_pipeline.hpp"
+#include "vulkan_app/vki/image.hpp"
+#include "vulkan_app/vki/image_view.hpp"
+#include "vulkan_app/vki/logical_device.hpp"
+#include "vulkan_app/vki/memory.hpp"
+#include "vulkan_app/vki/pipeline_cache.hpp"
+#include "vulkan_app/vki/pipeline_layout.hpp"
+#include "vulkan_app/vki/utils.hpp"
+
+namespace {
+constexpr VkFormat pyramidFormat = VK_FORMAT_R32_SFLOAT;
+constexpr uint32_t groupSize = 8;
+
+VkExtent2D getLevelExtent(const VkExtent2D &extent, const uint32_t &level) {
+    return { .width = std::max(1u, extent.width >> level),
+             .height = std::max(1u, extent.height >> level) };
+};
+
+vki::Image createPyramidImage(
+    const vki::LogicalDevice &logicalDevice,
+    const VkPhysicalDeviceMemoryProperties &memoryProperties,
+    const VkExtent2D &extent, const uint32_t &levelCount) {
+    VkImageCreateInfo createInfo = {
+        .sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO,
+        .imageType = VK_IMAGE_TYPE_2D,
+        .format = pyramidFormat,
+        .extent = { .width = extent.width,
+                    .height = extent.height,
+                    .depth = 1 },
+        .mipLevels = levelCount,
+        .arrayLayers = 1,
+        .samples = VK_SAMPLE_COUNT_1_BIT,
+        .tiling = VK_IMAGE_TILING_OPTIMAL,
+        .usage = VK_IMAGE_USAGE_STORAGE_BIT | VK_IMAGE_USAGE_SAMPLED_BIT,
+        .sharingMode = VK_SHARING_MODE_EXCLUSIVE,
+        .initialLayout = VK_IMAGE_LAYOUT_UNDEFINED,
+    };
+    vki::Image image(logicalDevice, createInfo);
+    const auto &requirements = image.getMemoryRequirements();
+    VkMemoryAllocateInfo allocInfo = {
+        .sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO,
+        .allocationSize = requirements.size,
+        .memoryTypeIndex = vki::utils::findMemoryType(
+            requirements.memoryTypeBits, memoryProperties,
+            VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT),
+    };
+    image.bindMemory(vki::Memory(logicalDevice, allocInfo));
+    return image;
+};
+
+vki::ImageView createLevelView(const vki::LogicalDevice &logicalDevice,
+                               const vki::Image &image,
+                               const uint32_t &baseLevel,
+                               const uint32_t &levelCount) {
+    VkImageViewCreateInfo createInfo = {
+        .sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO,
+        .image = image.getVkImage(),
+        .viewType = VK_IMAGE_VIEW_TYPE_2D,
+        .format = pyramidFormat,
+        .subresourceRange = { .aspectMask = VK_IMAGE_ASPECT_COLOR_BIT,
+                              .baseMipLevel = baseLevel,
+                              .levelCount = levelCount,
+                              .baseArrayLayer = 0,
+                              .layerCount = 1 },
+    };
+    return vki::ImageView(logicalDevice, createInfo);
+};
+};  // namespace
+
+DepthPyramid::DepthPyramid(
+    const vki::LogicalDevice &logicalDevice,
+    const VkPhysicalDeviceMemoryProperties &memoryProperties,
+    DescriptorLayoutCache &descriptorLayouts,
+    const vki::PipelineCache &pipelineCache, const vki::ImageView &depth,
+    const VkSampleCountFlagBits &depthSamples,
+    const VkExtent2D &maxRenderExtent)
+    : extent{ .width = std::bit_floor(maxRenderExtent.width),
+              .height = std::bit_floor(maxRenderExtent.height) },
+      levelCount{ static_cast<uint32_t>(
+          std::bit_width(std::max(extent.width, extent.height))) },
+      image{ createPyramidImage(logicalDevice, memoryProperties, extent,
+                                levelCount) },
+      view{ createLevelView(logicalDevice, image, 0, levelCount) },
+      layoutDescription{ describePipelineLayout(
+          { reflect_spirv(depthPyramidCompShaderCode.words()) }, 0) },
+      pipelineLayout{ descriptorLayouts.getPipelineLayout(layoutDescription) },
+      descriptorAllocator{
+          logicalDevice, layoutDescription.sets.at(0),
+          descriptorLayouts.getSetLayout(layoutDescription.sets.at(0)),
+          levelCount },
+      firstLevelPipeline{ createComputePipeline(
+          logicalDevice,
+          depthSamples == VK_SAMPLE_COUNT_1_BIT
+              ? depthPyramidCompShaderCode.name
+              : depthPyramidMsCompShaderCode.name,
+          pipelineLayout, pipelineCache) },
+      pipeline{ createComputePipeline(logicalDevice,
+                                      depthPyramidCompShaderCode.name,
+                                      pipelineLayout, pipelineCache) } {
+    levelViews.reserve(levelCount);
+    for (uint32_t level = 0; level < levelCount; level++) {
+        levelViews.push_back(createLevelView(logicalDevice, image, level, 1));
+    };
+    for (uint32_t level = 0; level < levelCount; level++) {
+        levelSets.push_back(descriptorAllocator.allocate());
+        // The depth image is read in its own layout, the levels in general.
+        VkDescriptorImageInfo sourceInfo = {
+            .imageView = depth.getVkImageView(),
+            .imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+        };
+        if (level > 0) {
+            sourceInfo.imageView = levelViews[level - 1].getVkImageView();
+            sourceInfo.imageLayout = VK_IMAGE_LAYOUT_GENERAL;
+        };
+        const VkDescriptorImageInfo destinationInfo = {
+            .imageView = levelViews[level].getVkImageView(),
+            .imageLayout = VK_IMAGE_LAYOUT_GENERAL,
+        };
+        logicalDevice.updateWriteDescriptorSets({
+            {
+                .sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET,
+                .dstSet = levelSets.back(),
+                .dstBinding = 0,
+                .dstArrayElement = 0,
+                .descriptorCount = 1,
+                .descriptorType = VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE,
+                .pImageInfo = &sourceInfo,
+            },
+            {
+                .sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET,
+                .dstSet = levelSets.back(),
+                .dstBinding = 1,
+                .dstArrayElement = 0,
+                .descriptorCount = 1,
+                .descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_IMAGE,
+                .pImageInfo = &destinationInfo,
+            },
+        });
+    };
+};
+
+const vki::ImageView &DepthPyramid::getImageView() const { return view; };
+
+void DepthPyramid::record(const vki::CommandBuffer &commandBuffer,
+                          const VkExtent2D &renderExtent) const {
+    // The last frame's levels are rewritten entirely, once the culling
+    // that sampled them is done.
+    const VkImageMemoryBarrier2 discardBarrier = {
+        .sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER_2,
+        .srcStageMask = VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT,
+        .srcAccessMask = VK_ACCESS_2_NONE,
+        .dstStageMask = VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT,
+        .dstAccessMask = VK_ACCESS_2_SHADER_STORAGE_WRITE_BIT,
+        .oldLayout = VK_IMAGE_LAYOUT_UNDEFINED,
+        .newLayout = VK_IMAGE_LAYOUT_GENERAL,
+        .srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+        .dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+        .image = image.getVkImage(),
+        .subresourceRange = { .aspectMask = VK_IMAGE_ASPECT_COLOR_BIT,
+                              .baseMipLevel = 0,
+                              .levelCount = VK_REMAINING_MIP_LEVELS,
+                              .baseArrayLayer = 0,
+                              .layerCount = 1 },
+    };
+    commandBuffer.pipelineBarrier({
+        .sType = VK_STRUCTURE_TYPE_DEPENDENCY_INFO,
+        .imageMemoryBarrierCount = 1,
+        .pImageMemoryBarriers = &discardBarrier,
+    });
+    const VkMemoryBarrier2 levelBarrier = {
+        .sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER_2,
+        .srcStageMask = VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT,
+        .srcAccessMask = VK_ACCESS_2_SHADER_STORAGE_WRITE_BIT,
+        .dstStageMask = VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT,
+        .dstAccessMask = VK_ACCESS_2_SHADER_SAMPLED_READ_BIT,
+    };
+    for (uint32_t level = 0; level < levelCount; level++) {
+        if (level == 0) {
+            commandBuffer.bindPipeline(firstLevelPipeline);
+        } else {
+            commandBuffer.memoryBarrier(levelBarrier);
+        };
+        if (level == 1) commandBuffer.bindPipeline(pipeline);
+        commandBuffer.bindDescriptorSet({
+            .bindPointType = vki::PipelineBindPointType::COMPUTE,
+            .pipelineLayout = pipelineLayout,
+            .firstSet = 0,
+            .descriptorSets = { levelSets[level] },
+            .dynamicOffsets = {},
+        });
+        const auto &sourceExtent = level == 0
+                                       ? renderExtent
+                                       : getLevelExtent(extent, level - 1);
+        const DepthPyramidConstants constants = {
+            .sourceSize = { static_cast<int32_t>(sourceExtent.width),
+                            static_cast<int32_t>(sourceExtent.height) },
+        };
+        commandBuffer.pushConstants(
+            pipelineLayout, DepthPyramidConstants::stageFlags, 0,
+            std::as_bytes(std::span(&constants, 1)));
+        const auto &levelExtent = getLevelExtent(extent, level);
+        commandBuffer.dispatch(
+            (levelExtent.width + groupSize - 1) / groupSize,
+            (levelExtent.height + groupSize - 1) / groupSize, 1);
+    };
+    commandBuffer.memoryBarrier(levelBarrier);
+};
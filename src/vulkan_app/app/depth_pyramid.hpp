@@ -0,0 +1,66 @@
+#pragma once
+
+#include <vulkan/vulkan_core.h>
+
+#include <cstdint>
+#include <vector>
+
+#include "glm/vec2.hpp"
+#include "vulkan_app/app/descriptor_allocator.hpp"
+#include "vulkan_app/app/descriptor_layout_cache.hpp"
+#include "vulkan_app/vki/command_buffer.hpp"
+#include "vulkan_app/vki/compute_pipeline.hpp"
+#include "vulkan_app/vki/image.hpp"
+#include "vulkan_app/vki/image_view.hpp"
+#include "vulkan_app/vki/logical_device.hpp"
+#include "vulkan_app/vki/pipeline_cache.hpp"
+#include "vulkan_app/vki/pipeline_layout.hpp"
+
+// Matches the push_constant block in depth_pyramid.comp and
+// depth_pyramid_ms.comp.
+struct DepthPyramidConstants {
+    glm::ivec2 sourceSize;
+
+    static constexpr VkShaderStageFlags stageFlags =
+        VK_SHADER_STAGE_COMPUTE_BIT;
+};
+
+// A mip chain of the farthest depth beneath each texel, rebuilt from the
+// scene depth image every frame. The base level is the largest power of
+// two within the largest render extent and covers the current render
+// extent, so no level is less than half the size of its source. The image
+// stays in the general layout, written one level at a time and sampled as
+// a whole.
+class DepthPyramid {
+    VkExtent2D extent;
+    uint32_t levelCount;
+    vki::Image image;
+    vki::ImageView view;
+    std::vector<vki::ImageView> levelViews;
+    PipelineLayoutDescription layoutDescription;
+    const vki::PipelineLayout &pipelineLayout;
+    DescriptorAllocator descriptorAllocator;
+    // One per level, reading the level below it or the depth image.
+    std::vector<VkDescriptorSet> levelSets;
+    // Reads the depth image, which may be multisampled.
+    vki::ComputePipeline firstLevelPipeline;
+    vki::ComputePipeline pipeline;
+
+public:
+    explicit DepthPyramid(
+        const vki::LogicalDevice &logicalDevice,
+        const VkPhysicalDeviceMemoryProperties &memoryProperties,
+        DescriptorLayoutCache &descriptorLayouts,
+        const vki::PipelineCache &pipelineCache, const vki::ImageView &depth,
+        const VkSampleCountFlagBits &depthSamples,
+        const VkExtent2D &maxRenderExtent);
+    DepthPyramid(const DepthPyramid &other) = delete;
+    DepthPyramid &operator=(const DepthPyramid &other) = delete;
+
+    // All levels, to be sampled in the general layout.
+    const vki::ImageView &getImageView() const;
+    // Records outside of rendering, after the depth image has become
+    // readable by compute shaders. Leaves the pyramid readable by them.
+    void record(const vki::CommandBuffer &commandBuffer,
+                const VkExtent2D &renderExtent) const;
+};
@@ -0,0 +1,53 @@
+#include "./descriptor_allocator.hpp"
+
+#include <vulkan/vulkan_core.h>
+
+#include <cstdint>
+#include <memory>
+#include <stdexcept>
+
+#include "vulkan_app/app/descriptor_layout_cache.hpp"
+#include "vulkan_app/vki/descriptor_pool.hpp"
+#include "vulkan_app/vki/descriptor_set_layout.hpp"
+#include "vulkan_app/vki/logical_device.hpp"
+
+DescriptorAllocator::DescriptorAllocator(
+    const vki::LogicalDevice &logicalDevice,
+    const DescriptorSetLayoutDescription &description,
+    const vki::DescriptorSetLayout &setLayout, const uint32_t &setsPerPool)
+    : logicalDevice{ logicalDevice },
+      setLayout{ setLayout.getVkDescriptorSetLayout() },
+      poolSizes{ description.getPoolSizes(setsPerPool) },
+      poolFlags{ 0 },
+      setsPerPool{ setsPerPool },
+      currentPool{ 0 } {
+    if (description.isUpdateAfterBind()) {
+        poolFlags |= VK_DESCRIPTOR_POOL_CREATE_UPDATE_AFTER_BIND_BIT;
+    };
+};
+
+VkDescriptorSet DescriptorAllocator::allocate() {
+    for (; currentPool < pools.size(); currentPool++) {
+        const auto &descriptorSet = pools[currentPool]->tryAllocate(setLayout);
+        if (descriptorSet.has_value()) return descriptorSet.value();
+    };
+    VkDescriptorPoolCreateInfo createInfo = {
+        .sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO,
+        .flags = poolFlags,
+        .maxSets = setsPerPool,
+        .poolSizeCount = static_cast<uint32_t>(poolSizes.size()),
+        .pPoolSizes = poolSizes.data(),
+    };
+    pools.push_back(
+        std::make_unique<vki::DescriptorPool>(logicalDevice, createInfo));
+    const auto &descriptorSet = pools.back()->tryAllocate(setLayout);
+    if (!descriptorSet.has_value()) {
+        throw std::runtime_error("Descriptor set does not fit a new pool");
+    };
+    return descriptorSet.value();
+};
+
+void DescriptorAllocator::reset() {
+    for (const auto &pool : pools) pool->reset();
+    currentPool = 0;
+};
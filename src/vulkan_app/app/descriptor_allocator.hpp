@@ -0,0 +1,78 @@
+#pragma once
+
+#include <vulkan/vulkan_core.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+#include "vulkan_app/app/descriptor_layout_cache.hpp"
+#include "vulkan_app/vki/descriptor_pool.hpp"
+#include "vulkan_app/vki/descriptor_set_layout.hpp"
+#include "vulkan_app/vki/descriptor_update_template.hpp"
+#include "vulkan_app/vki/logical_device.hpp"
+
+// Allocates sets of one layout from a chain of pools, each sized for
+// exactly setsPerPool of them. A new pool is added whenever the current
+// ones run out, so allocation only fails if the device is out of memory.
+// For per-frame sets, reset() frees everything at once and keeps the pools
+// for the next frame.
+class DescriptorAllocator {
+    const vki::LogicalDevice &logicalDevice;
+    VkDescriptorSetLayout setLayout;
+    std::vector<VkDescriptorPoolSize> poolSizes;
+    VkDescriptorPoolCreateFlags poolFlags;
+    uint32_t setsPerPool;
+    std::vector<std::unique_ptr<vki::DescriptorPool>> pools;
+    // Pools before this one are full.
+    std::size_t currentPool;
+
+public:
+    explicit DescriptorAllocator(
+        const vki::LogicalDevice &logicalDevice,
+        const DescriptorSetLayoutDescription &description,
+        const vki::DescriptorSetLayout &setLayout,
+        const uint32_t &setsPerPool);
+    DescriptorAllocator(const DescriptorAllocator &other) = delete;
+    DescriptorAllocator &operator=(const DescriptorAllocator &other) = delete;
+
+    VkDescriptorSet allocate();
+    // Sets allocated so far become invalid and must no longer be in use by
+    // the device.
+    void reset();
+
+    inline std::size_t getPoolCount() const { return pools.size(); };
+};
+
+// Sets whose descriptors never change after they are written, looked up by
+// their contents. Contents is laid out for the update template and needs
+// equality and a hash; a miss allocates a set and writes it with one
+// template update.
+template <typename Contents, typename Hash>
+class DescriptorSetCache {
+    DescriptorAllocator &allocator;
+    const vki::DescriptorUpdateTemplate &updateTemplate;
+    std::unordered_map<Contents, VkDescriptorSet, Hash> sets;
+
+public:
+    explicit DescriptorSetCache(
+        DescriptorAllocator &allocator,
+        const vki::DescriptorUpdateTemplate &updateTemplate)
+        : allocator{ allocator }, updateTemplate{ updateTemplate } {};
+
+    inline std::size_t size() const { return sets.size(); };
+    inline bool contains(const Contents &contents) const {
+        return sets.contains(contents);
+    };
+
+    VkDescriptorSet get(const Contents &contents) {
+        const auto &[entry, isInserted] = sets.try_emplace(contents);
+        if (isInserted) {
+            entry->second = allocator.allocate();
+            updateTemplate.update(entry->second, &entry->first);
+        };
+        return entry->second;
+    };
+};
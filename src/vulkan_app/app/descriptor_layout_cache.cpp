@@ -0,0 +1,201 @@
+#include "./descriptor_layout_cache.hpp"
+
+#include <vulkan/vulkan_core.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <format>
+#include <map>
+#include <memory>
+#include <stdexcept>
+#include <vector>
+
+#include "vulkan_app/app/fnv1a.hpp"
+#include "vulkan_app/app/spirv_reflection.hpp"
+#include "vulkan_app/vki/descriptor_set_layout.hpp"
+#include "vulkan_app/vki/logical_device.hpp"
+#include "vulkan_app/vki/pipeline_layout.hpp"
+
+namespace {
+uint64_t hashSetLayout(uint64_t hash,
+                       const DescriptorSetLayoutDescription &description) {
+    hash =
+        fnv1aValue(hash, static_cast<uint64_t>(description.bindings.size()));
+    for (const auto &binding : description.bindings) {
+        hash = fnv1aValue(hash, binding.binding);
+        hash = fnv1aValue(hash, binding.descriptorType);
+        hash = fnv1aValue(hash, binding.descriptorCount);
+        hash = fnv1aValue(hash, binding.stageFlags);
+        hash = fnv1aValue(hash, binding.bindingFlags);
+    };
+    return fnv1aValue(hash, description.isPushDescriptor);
+};
+};  // namespace
+
+uint64_t DescriptorSetLayoutDescription::hash() const {
+    return hashSetLayout(fnvOffsetBasis, *this);
+};
+
+bool DescriptorSetLayoutDescription::isUpdateAfterBind() const {
+    return std::ranges::any_of(
+        bindings, [](const DescriptorBindingDescription &binding) {
+            return (binding.bindingFlags &
+                    VK_DESCRIPTOR_BINDING_UPDATE_AFTER_BIND_BIT) != 0;
+        });
+};
+
+std::vector<VkDescriptorPoolSize> DescriptorSetLayoutDescription::getPoolSizes(
+    const uint32_t &setCount) const {
+    std::map<VkDescriptorType, uint32_t> counts;
+    for (const auto &binding : bindings) {
+        counts[binding.descriptorType] += binding.descriptorCount * setCount;
+    };
+    std::vector<VkDescriptorPoolSize> poolSizes;
+    for (const auto &[type, count] : counts) {
+        poolSizes.push_back({ .type = type, .descriptorCount = count });
+    };
+    return poolSizes;
+};
+
+bool PipelineLayoutDescription::operator==(
+    const PipelineLayoutDescription &other) const {
+    return sets == other.sets &&
+           std::ranges::equal(
+               pushConstantRanges, other.pushConstantRanges,
+               [](const VkPushConstantRange &a, const VkPushConstantRange &b) {
+                   return a.stageFlags == b.stageFlags &&
+                          a.offset == b.offset && a.size == b.size;
+               });
+};
+
+uint64_t PipelineLayoutDescription::hash() const {
+    uint64_t hash = fnvOffsetBasis;
+    hash = fnv1aValue(hash, static_cast<uint64_t>(sets.size()));
+    for (const auto &set : sets) hash = hashSetLayout(hash, set);
+    for (const auto &range : pushConstantRanges) {
+        hash = fnv1aValue(hash, range.stageFlags);
+        hash = fnv1aValue(hash, range.offset);
+        hash = fnv1aValue(hash, range.size);
+    };
+    return hash;
+};
+
+PipelineLayoutDescription describePipelineLayout(
+    const std::vector<SpirvReflection> &stages,
+    const uint32_t &runtimeArraySize) {
+    PipelineLayoutDescription description;
+    for (const auto &stage : stages) {
+        for (const auto &binding : stage.bindings) {
+            if (binding.set >= description.sets.size()) {
+                description.sets.resize(binding.set + 1);
+            };
+            const auto isRuntimeArray = binding.descriptorCount == 0;
+            const DescriptorBindingDescription merged = {
+                .binding = binding.binding,
+                .descriptorType = binding.descriptorType,
+                .descriptorCount = isRuntimeArray ? runtimeArraySize
+                                                  : binding.descriptorCount,
+                .stageFlags = static_cast<VkShaderStageFlags>(stage.stage),
+                .bindingFlags =
+                    isRuntimeArray
+                        ? static_cast<VkDescriptorBindingFlags>(
+                              VK_DESCRIPTOR_BINDING_PARTIALLY_BOUND_BIT |
+                              VK_DESCRIPTOR_BINDING_UPDATE_AFTER_BIND_BIT)
+                        : 0,
+            };
+            auto &bindings = description.sets[binding.set].bindings;
+            const auto &existing = std::ranges::find(
+                bindings, binding.binding,
+                &DescriptorBindingDescription::binding);
+            if (existing == bindings.end()) {
+                bindings.push_back(merged);
+            } else if (existing->descriptorType != merged.descriptorType ||
+                       existing->descriptorCount != merged.descriptorCount) {
+                throw std::runtime_error(std::format(
+                    "Shader stages disagree on set {} binding {}",
+                    binding.set, binding.binding));
+            } else {
+                existing->stageFlags |= merged.stageFlags;
+            };
+        };
+        if (stage.pushConstantSize != 0) {
+            description.pushConstantRanges.push_back({
+                .stageFlags = static_cast<VkShaderStageFlags>(stage.stage),
+                .offset = stage.pushConstantOffset,
+                .size = stage.pushConstantSize,
+            });
+        };
+    };
+    for (auto &set : description.sets) {
+        std::ranges::sort(set.bindings, {},
+                          &DescriptorBindingDescription::binding);
+    };
+    return description;
+};
+
+DescriptorLayoutCache::DescriptorLayoutCache(
+    const vki::LogicalDevice &logicalDevice)
+    : logicalDevice{ logicalDevice } {};
+
+const vki::DescriptorSetLayout &DescriptorLayoutCache::getSetLayout(
+    const DescriptorSetLayoutDescription &description) {
+    auto &setLayout = setLayouts[description];
+    if (setLayout) return *setLayout;
+
+    std::vector<VkDescriptorSetLayoutBinding> bindings;
+    std::vector<VkDescriptorBindingFlags> bindingFlags;
+    for (const auto &binding : description.bindings) {
+        bindings.push_back({
+            .binding = binding.binding,
+            .descriptorType = binding.descriptorType,
+            .descriptorCount = binding.descriptorCount,
+            .stageFlags = binding.stageFlags,
+        });
+        bindingFlags.push_back(binding.bindingFlags);
+    };
+    VkDescriptorSetLayoutBindingFlagsCreateInfo bindingFlagsCreateInfo = {
+        .sType =
+            VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_BINDING_FLAGS_CREATE_INFO,
+        .bindingCount = static_cast<uint32_t>(bindingFlags.size()),
+        .pBindingFlags = bindingFlags.data()
+    };
+    VkDescriptorSetLayoutCreateFlags flags = 0;
+    if (description.isUpdateAfterBind()) {
+        flags |= VK_DESCRIPTOR_SET_LAYOUT_CREATE_UPDATE_AFTER_BIND_POOL_BIT;
+    };
+    if (description.isPushDescriptor) {
+        flags |= VK_DESCRIPTOR_SET_LAYOUT_CREATE_PUSH_DESCRIPTOR_BIT_KHR;
+    };
+    VkDescriptorSetLayoutCreateInfo createInfo = {
+        .sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO,
+        .pNext = &bindingFlagsCreateInfo,
+        .flags = flags,
+        .bindingCount = static_cast<uint32_t>(bindings.size()),
+        .pBindings = bindings.data()
+    };
+    setLayout =
+        std::make_unique<vki::DescriptorSetLayout>(logicalDevice, createInfo);
+    return *setLayout;
+};
+
+const vki::PipelineLayout &DescriptorLayoutCache::getPipelineLayout(
+    const PipelineLayoutDescription &description) {
+    auto &pipelineLayout = pipelineLayouts[description];
+    if (pipelineLayout) return *pipelineLayout;
+
+    std::vector<VkDescriptorSetLayout> vkSetLayouts;
+    for (const auto &set : description.sets) {
+        vkSetLayouts.push_back(getSetLayout(set).getVkDescriptorSetLayout());
+    };
+    VkPipelineLayoutCreateInfo createInfo = {
+        .sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO,
+        .setLayoutCount = static_cast<uint32_t>(vkSetLayouts.size()),
+        .pSetLayouts = vkSetLayouts.data(),
+        .pushConstantRangeCount =
+            static_cast<uint32_t>(description.pushConstantRanges.size()),
+        .pPushConstantRanges = description.pushConstantRanges.data()
+    };
+    pipelineLayout =
+        std::make_unique<vki::PipelineLayout>(logicalDevice, createInfo);
+    return *pipelineLayout;
+};
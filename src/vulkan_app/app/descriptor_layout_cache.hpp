@@ -0,0 +1,101 @@
+#pragma once
+
+#include <vulkan/vulkan_core.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+#include "vulkan_app/app/spirv_reflection.hpp"
+#include "vulkan_app/vki/descriptor_set_layout.hpp"
+#include "vulkan_app/vki/logical_device.hpp"
+#include "vulkan_app/vki/pipeline_layout.hpp"
+
+struct DescriptorBindingDescription {
+    uint32_t binding;
+    VkDescriptorType descriptorType;
+    uint32_t descriptorCount;
+    VkShaderStageFlags stageFlags;
+    VkDescriptorBindingFlags bindingFlags;
+
+    bool operator==(const DescriptorBindingDescription &other) const =
+        default;
+};
+
+// The binding signature of a descriptor set layout. Sets allocated with
+// one layout can be bound to every pipeline whose signature is equal.
+struct DescriptorSetLayoutDescription {
+    // Sorted by binding number.
+    std::vector<DescriptorBindingDescription> bindings;
+    // Written into command buffers with VK_KHR_push_descriptor instead of
+    // being allocated.
+    bool isPushDescriptor = false;
+
+    bool operator==(const DescriptorSetLayoutDescription &other) const =
+        default;
+
+    uint64_t hash() const;
+    bool isUpdateAfterBind() const;
+    // Exactly the descriptors that setCount sets of this layout take.
+    std::vector<VkDescriptorPoolSize> getPoolSizes(
+        const uint32_t &setCount) const;
+};
+
+struct DescriptorSetLayoutDescriptionHash {
+    inline std::size_t operator()(
+        const DescriptorSetLayoutDescription &description) const {
+        return static_cast<std::size_t>(description.hash());
+    };
+};
+
+struct PipelineLayoutDescription {
+    // Indexed by set number. Set numbers the shaders skip are empty.
+    std::vector<DescriptorSetLayoutDescription> sets;
+    std::vector<VkPushConstantRange> pushConstantRanges;
+
+    bool operator==(const PipelineLayoutDescription &other) const;
+
+    uint64_t hash() const;
+};
+
+struct PipelineLayoutDescriptionHash {
+    inline std::size_t operator()(
+        const PipelineLayoutDescription &description) const {
+        return static_cast<std::size_t>(description.hash());
+    };
+};
+
+// Merges the interfaces of a pipeline's stages. Runtime arrays get
+// runtimeArraySize descriptors and may be partially bound and updated
+// while bound. Throws if two stages declare one binding differently.
+PipelineLayoutDescription describePipelineLayout(
+    const std::vector<SpirvReflection> &stages,
+    const uint32_t &runtimeArraySize);
+
+// Creates each distinct set and pipeline layout once. Pipelines built from
+// shaders with the same interface share layouts, and so descriptor sets.
+class DescriptorLayoutCache {
+    const vki::LogicalDevice &logicalDevice;
+    std::unordered_map<DescriptorSetLayoutDescription,
+                       std::unique_ptr<vki::DescriptorSetLayout>,
+                       DescriptorSetLayoutDescriptionHash>
+        setLayouts;
+    std::unordered_map<PipelineLayoutDescription,
+                       std::unique_ptr<vki::PipelineLayout>,
+                       PipelineLayoutDescriptionHash>
+        pipelineLayouts;
+
+public:
+    explicit DescriptorLayoutCache(const vki::LogicalDevice &logicalDevice);
+    DescriptorLayoutCache(const DescriptorLayoutCache &other) = delete;
+    DescriptorLayoutCache &operator=(const DescriptorLayoutCache &other) =
+        delete;
+
+    // References stay valid as long as the cache.
+    const vki::DescriptorSetLayout &getSetLayout(
+        const DescriptorSetLayoutDescription &description);
+    const vki::PipelineLayout &getPipelineLayout(
+        const PipelineLayoutDescription &description);
+};
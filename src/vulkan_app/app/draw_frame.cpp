@@ -2,12 +2,26 @@
 
 #include <vulkan/vulkan_core.h>
 
+#include <cstddef>
 #include <cstdint>
 #include <cstring>
+#include <span>
 #include <vector>
 
+#include "vulkan_app/app/bindless_textures.hpp"
 #include "vulkan_app/app/data_aggregator.hpp"
+#include "vulkan_app/app/depth_pyramid.hpp"
+#include "vulkan_app/app/frame_arena.hpp"
+#include "vulkan_app/app/frame_descriptors.hpp"
 #include "vulkan_app/app/frame_state.hpp"
+#include "vulkan_app/app/gpu_frame_timer.hpp"
+#include "vulkan_app/app/instance_data.hpp"
+#include "vulkan_app/app/occlusion_culler.hpp"
+#include "vulkan_app/app/pipeline_description.hpp"
+#include "vulkan_app/app/render_graph.hpp"
+#include "vulkan_app/app/resolution_controller.hpp"
+#include "vulkan_app/app/spatial_upscaler.hpp"
+#include "vulkan_app/app/texture_streamer.hpp"
 
 #define GLM_ENABLE_EXPERIMENTAL
 #include "glm/ext/matrix_transform.hpp"
@@ -16,12 +30,12 @@
 #include "vulkan_app/vki/buffer.hpp"
 #include "vulkan_app/vki/command_buffer.hpp"
 #include "vulkan_app/vki/fence.hpp"
-#include "vulkan_app/vki/framebuffer.hpp"
 #include "vulkan_app/vki/graphics_pipeline.hpp"
+#include "vulkan_app/vki/image.hpp"
+#include "vulkan_app/vki/image_view.hpp"
 #include "vulkan_app/vki/logical_device.hpp"
 #include "vulkan_app/vki/pipeline_layout.hpp"
 #include "vulkan_app/vki/queue.hpp"
-#include "vulkan_app/vki/render_pass.hpp"
 #include "vulkan_app/vki/semaphore.hpp"
 #include "vulkan_app/vki/structs.hpp"
 #include "vulkan_app/vki/swapchain.hpp"
@@ -33,22 +47,179 @@ void updateFrameUniformBuffer(void *bufferMappedMemory,
                    { 0.0f, 1.0f, 0.0f, 0.0f },
                    { 0.0f, 0.0f, 1.0f, 0.0f },
                    { 0.0f, 0.0f, 0.0f, 1.0f } },
-        .view = glm::lookAt(frameState.cameraPos,
-                            frameState.cameraPos + frameState.cameraFront,
-                            frameState.cameraUp),
+        .view = frameState.getViewMatrix(),
         .proj = frameState.projection,
     };
     memcpy(bufferMappedMemory, &ubo, sizeof(ubo));
 };
 
+FrameGraph describeFrameGraph(const VkFormat &swapchainFormat,
+                              const VkExtent2D &maxRenderExtent,
+                              const VkFormat &depthFormat,
+                              const VkSampleCountFlagBits &sampleCount) {
+    FrameGraph frameGraph;
+    auto &graph = frameGraph.graph;
+    // Acquired images are waited for at the color output stage, and
+    // presenting waits on a semaphore signalled after all commands.
+    frameGraph.swapchainImage = graph.importImage({
+        .aspectMask = VK_IMAGE_ASPECT_COLOR_BIT,
+        .initialState = { .stageMask =
+                              VK_PIPELINE_STAGE_2_COLOR_ATTACHMENT_OUTPUT_BIT,
+                          .accessMask = VK_ACCESS_2_NONE,
+                          .layout = VK_IMAGE_LAYOUT_UNDEFINED },
+        .finalState = { .stageMask = VK_PIPELINE_STAGE_2_NONE,
+                        .accessMask = VK_ACCESS_2_NONE,
+                        .layout = VK_IMAGE_LAYOUT_PRESENT_SRC_KHR },
+    });
+    frameGraph.sceneImage = graph.createImage({
+        .format = swapchainFormat,
+        .extent = maxRenderExtent,
+        .samples = VK_SAMPLE_COUNT_1_BIT,
+        .aspectMask = VK_IMAGE_ASPECT_COLOR_BIT,
+    });
+    frameGraph.depthImage = graph.createImage({
+        .format = depthFormat,
+        .extent = maxRenderExtent,
+        .samples = sampleCount,
+        .aspectMask = VK_IMAGE_ASPECT_DEPTH_BIT,
+    });
+    frameGraph.colorImage = frameGraph.sceneImage;
+    if (sampleCount != VK_SAMPLE_COUNT_1_BIT) {
+        frameGraph.colorImage = graph.createImage({
+            .format = swapchainFormat,
+            .extent = maxRenderExtent,
+            .samples = sampleCount,
+            .aspectMask = VK_IMAGE_ASPECT_COLOR_BIT,
+        });
+    };
+    frameGraph.earlyScenePass = graph.addPass({
+        .name = "scene early",
+        .images = { { .image = frameGraph.colorImage,
+                      .access = ImageAccess::COLOR_ATTACHMENT,
+                      .isCleared = true },
+                    { .image = frameGraph.depthImage,
+                      .access = ImageAccess::DEPTH_ATTACHMENT,
+                      .isCleared = true } },
+    });
+    frameGraph.pyramidPass = graph.addPass({
+        .name = "depth pyramid",
+        .images = { { .image = frameGraph.depthImage,
+                      .access = ImageAccess::COMPUTE_SAMPLED } },
+    });
+    RenderGraphPass latePass = {
+        .name = "scene late",
+        .images = { { .image = frameGraph.colorImage,
+                      .access = ImageAccess::COLOR_ATTACHMENT },
+                    { .image = frameGraph.depthImage,
+                      .access = ImageAccess::DEPTH_ATTACHMENT } },
+    };
+    if (frameGraph.colorImage != frameGraph.sceneImage) {
+        latePass.images.push_back(
+            { .image = frameGraph.sceneImage,
+              .access = ImageAccess::RESOLVE_ATTACHMENT });
+    };
+    frameGraph.lateScenePass = graph.addPass(latePass);
+    frameGraph.upscalePass = graph.addPass({
+        .name = "upscale",
+        .images = { { .image = frameGraph.sceneImage,
+                      .access = ImageAccess::SAMPLED },
+                    { .image = frameGraph.swapchainImage,
+                      .access = ImageAccess::COLOR_ATTACHMENT } },
+    });
+    return frameGraph;
+};
+
+FrameGraph createFrameGraph(
+    const vki::LogicalDevice &logicalDevice,
+    const VkPhysicalDeviceMemoryProperties &memoryProperties,
+    const VkFormat &swapchainFormat, const VkExtent2D &maxRenderExtent,
+    const VkFormat &depthFormat, const VkSampleCountFlagBits &sampleCount) {
+    auto frameGraph = describeFrameGraph(swapchainFormat, maxRenderExtent,
+                                         depthFormat, sampleCount);
+    frameGraph.graph.compile(logicalDevice, memoryProperties);
+    return frameGraph;
+};
+
+// Scales the viewport and scissor from the swapchain to the render extent.
+DynamicRenderState scaleRenderState(const DynamicRenderState &renderState,
+                                    const VkExtent2D &swapchainExtent,
+                                    const VkExtent2D &renderExtent) {
+    const auto &scaleX = static_cast<float>(renderExtent.width) /
+                         static_cast<float>(swapchainExtent.width);
+    const auto &scaleY = static_cast<float>(renderExtent.height) /
+                         static_cast<float>(swapchainExtent.height);
+    auto scaled = renderState;
+    scaled.viewport.x *= scaleX;
+    scaled.viewport.y *= scaleY;
+    scaled.viewport.width *= scaleX;
+    scaled.viewport.height *= scaleY;
+    scaled.scissor.offset = {
+        .x = static_cast<int32_t>(renderState.scissor.offset.x * scaleX),
+        .y = static_cast<int32_t>(renderState.scissor.offset.y * scaleY)
+    };
+    scaled.scissor.extent = {
+        .width = static_cast<uint32_t>(renderState.scissor.extent.width *
+                                       scaleX),
+        .height = static_cast<uint32_t>(renderState.scissor.extent.height *
+                                        scaleY)
+    };
+    return scaled;
+};
+
+// Rendering into the scene images for one of the scene passes. The scene
+// images are sized for the largest render extent, and only the current one
+// is drawn into and upscaled.
+vki::RenderingInfo createSceneRenderingInfo(const FrameGraph &frameGraph,
+                                            const uint32_t &pass,
+                                            const VkExtent2D &renderExtent) {
+    VkClearValue clearColor = { .color = { .float32 = { 0.0f, 0.0f, 0.0f,
+                                                        1.0f } } };
+    VkClearValue clearDepth = { .depthStencil = { 1.0f, 0 } };
+    const auto &graph = frameGraph.graph;
+    const auto colorOps = graph.getAttachmentOps(pass, frameGraph.colorImage);
+    const auto depthOps = graph.getAttachmentOps(pass, frameGraph.depthImage);
+    vki::RenderingAttachment colorAttachment = {
+        .imageView = graph.getImageView(frameGraph.colorImage),
+        .layout = colorOps.layout,
+        .loadOp = colorOps.loadOp,
+        .storeOp = colorOps.storeOp,
+        .clearValue = clearColor,
+    };
+    // Both phases draw into the multisampled image, and the late one
+    // resolves everything.
+    if (pass == frameGraph.lateScenePass &&
+        frameGraph.colorImage != frameGraph.sceneImage) {
+        colorAttachment.resolveImageView =
+            graph.getImageView(frameGraph.sceneImage);
+        colorAttachment.resolveLayout =
+            graph.getAttachmentOps(pass, frameGraph.sceneImage).layout;
+    };
+    return {
+        .renderArea = { .offset = { 0, 0 }, .extent = renderExtent },
+        .colorAttachments = { colorAttachment },
+        .depthAttachment = vki::RenderingAttachment{
+            .imageView = graph.getImageView(frameGraph.depthImage),
+            .layout = depthOps.layout,
+            .loadOp = depthOps.loadOp,
+            .storeOp = depthOps.storeOp,
+            .clearValue = clearDepth,
+        },
+    };
+};
+
 void recordCommandBuffer(
-    const vki::Framebuffer &framebuffer, const vki::Swapchain &swapchain,
-    const VkExtent2D &swapchainExtent, const vki::RenderPass &renderPass,
+    const vki::ImageView &swapchainImageView,
+    const VkExtent2D &swapchainExtent, const VkExtent2D &renderExtent,
     const vki::GraphicsPipeline &pipeline,
-    const vki::CommandBuffer &commandBuffer, const vki::Buffer &vertexBuffer,
+    const DynamicRenderState &renderState,
+    const vki::CommandBuffer &commandBuffer, const FrameGraph &frameGraph,
+    FrameArena &frameArena, const SpatialUpscaler &upscaler,
+    const DepthPyramid &depthPyramid, OcclusionCuller &occlusionCuller,
+    GpuFrameTimer &frameTimer, const vki::Buffer &vertexBuffer,
     const vki::Buffer &indexBuffer, const vki::PipelineLayout &pipelineLayout,
-    const VkDescriptorSet &descriptorSet,
-    const DataAggregator &dataAggregator) {
+    FrameDescriptorSets &frameDescriptorSets,
+    const FrameDescriptors &frameDescriptors,
+    TextureStreamer &textureStreamer, BindlessTextures &bindlessTextures) {
     commandBuffer.record([&]() {
         //vkCmdUpdateBuffer(commandBuffer.getVkCommandBuffer(),
         //                  vertexBuffer.getVkBuffer(), 0,
@@ -60,81 +231,145 @@ void recordCommandBuffer(
         //                  sizeof(dataAggregator.indexArray[0]) *
         //                      dataAggregator.indexArray.size(),
         //                  dataAggregator.indexArray.data());
-        VkClearValue clearColor = { .color = { .float32 = { 0.0f, 0.0f, 0.0f,
-                                                            1.0f } } };
-        VkClearValue clearDepth = { .depthStencil = { 1.0f, 0 } };
-        vki::RenderPassBeginInfo renderPassBeginInfo = {
-            .renderPass = renderPass,
-            .framebuffer = framebuffer,
-            .clearValues = { clearColor, clearDepth },
-            .renderArea = { .offset = { 0, 0 }, .extent = swapchainExtent }
+        const auto &graph = frameGraph.graph;
+        const auto outputOps = graph.getAttachmentOps(
+            frameGraph.upscalePass, frameGraph.swapchainImage);
+        const vki::RenderingInfo upscaleRenderingInfo = {
+            .renderArea = { .offset = { 0, 0 }, .extent = swapchainExtent },
+            .colorAttachments = { {
+                .imageView = swapchainImageView,
+                .layout = outputOps.layout,
+                .loadOp = outputOps.loadOp,
+                .storeOp = outputOps.storeOp,
+            } },
         };
-        commandBuffer.withRenderPass(
-            renderPassBeginInfo, vki::SubpassContentsType::INLINE, [&]() {
-                commandBuffer.bindPipeline(
-                    pipeline, vki::PipelineBindPointType::GRAPHICS);
-                commandBuffer.bindVertexBuffers({
-                    .firstBinding = 0,
-                    .bindingCount = 1,
-                    .buffers = { vertexBuffer },
-                    .offsets = { 0 },
-                });
-                commandBuffer.bindIndexBuffer({
-                    .buffer = indexBuffer,
-                    .offset = 0,
-                    .type = VK_INDEX_TYPE_UINT32,
-                });
-                commandBuffer.bindDescriptorSet({
-                    .bindPointType = vki::PipelineBindPointType::GRAPHICS,
-                    .pipelineLayout = pipelineLayout,
-                    .firstSet = 0,
-                    .descriptorSets = { descriptorSet },
-                    .dynamicOffsets = {},
+        const auto &sceneState =
+            scaleRenderState(renderState, swapchainExtent, renderExtent);
+        // Graphics state outlives rendering and is untouched by the compute
+        // work between the scene passes, so the late pass draws with what
+        // the early pass bound.
+        bool isSceneStateBound = false;
+        const auto &bindSceneState = [&]() {
+            commandBuffer.bindPipeline(pipeline,
+                                       vki::PipelineBindPointType::GRAPHICS);
+            commandBuffer.setViewport(sceneState.viewport);
+            commandBuffer.setScissor(sceneState.scissor);
+            commandBuffer.setCullMode(sceneState.cullMode);
+            commandBuffer.setDepthTestEnable(sceneState.isDepthTestEnabled);
+            commandBuffer.setDepthWriteEnable(sceneState.isDepthWriteEnabled);
+            commandBuffer.bindVertexBuffers({
+                .firstBinding = 0,
+                .bindingCount = 1,
+                .buffers = { vertexBuffer },
+                .offsets = { 0 },
+            });
+            commandBuffer.bindIndexBuffer({
+                .buffer = indexBuffer,
+                .offset = 0,
+                .type = VK_INDEX_TYPE_UINT32,
+            });
+            frameDescriptorSets.bind(commandBuffer, frameDescriptors);
+            commandBuffer.bindDescriptorSet({
+                .bindPointType = vki::PipelineBindPointType::GRAPHICS,
+                .pipelineLayout = pipelineLayout,
+                .firstSet = 1,
+                .descriptorSets = { bindlessTextures.getDescriptorSet() },
+                .dynamicOffsets = {},
+            });
+        };
+        const auto &recordScene = [&](const uint32_t &pass,
+                                      const CullPhase &phase) {
+            commandBuffer.withRendering(
+                createSceneRenderingInfo(frameGraph, pass, renderExtent),
+                [&]() {
+                    if (!isSceneStateBound) {
+                        bindSceneState();
+                        isSceneStateBound = true;
+                    };
+                    occlusionCuller.draw(commandBuffer, phase);
                 });
-                for (const auto &shapeData : dataAggregator.shapes) {
-                    commandBuffer.drawIndexed({
-                        .indexCount = shapeData.indexCount,
-                        .instanceCount = 1,
-                        .firstIndex = shapeData.indexOffset,
-                        .vertexOffset = static_cast<int32_t>(shapeData.vertexOffset),
-                        .firstInstance = 0,
-                    });
-                };
+        };
+        const auto &recordEarlyScene = [&]() {
+            recordScene(frameGraph.earlyScenePass, CullPhase::EARLY);
+        };
+        const auto &recordPyramid = [&]() {
+            depthPyramid.record(commandBuffer, renderExtent);
+            occlusionCuller.recordLate(commandBuffer);
+        };
+        const auto &recordLateScene = [&]() {
+            recordScene(frameGraph.lateScenePass, CullPhase::LATE);
+        };
+        const auto &recordUpscale = [&]() {
+            commandBuffer.withRendering(upscaleRenderingInfo, [&]() {
+                upscaler.record(commandBuffer, renderExtent,
+                                swapchainExtent);
             });
+        };
+        textureStreamer.recordUploads(commandBuffer, bindlessTextures);
+        frameTimer.begin(commandBuffer);
+        occlusionCuller.recordEarly(commandBuffer);
+        graph.execute(commandBuffer, frameArena, recordEarlyScene,
+                      recordPyramid, recordLateScene, recordUpscale);
+        frameTimer.end(commandBuffer);
     });
 };
 
 void drawFrame(
     const vki::LogicalDevice &logicalDevice, const vki::Swapchain &swapchain,
-    const VkExtent2D &swapchainExtent, const vki::RenderPass &renderPass,
-    const vki::GraphicsPipeline &pipeline,
-    const std::vector<vki::Framebuffer> &framebuffers,
-    const vki::CommandBuffer &commandBuffer, const vki::Fence &inFlightFence,
+    const VkExtent2D &swapchainExtent, const vki::GraphicsPipeline &pipeline,
+    const DynamicRenderState &renderState,
+    const vki::CommandBuffer &commandBuffer, FrameGraph &frameGraph,
+    FrameArena &frameArena, const SpatialUpscaler &upscaler,
+    const DepthPyramid &depthPyramid, OcclusionCuller &occlusionCuller,
+    GpuFrameTimer &frameTimer, ResolutionController &resolutionController,
+    const vki::Fence &inFlightFence,
     const vki::Semaphore &imageAvailableSemaphore,
     const vki::Semaphore &renderFinishedSemaphore,
     const vki::Buffer &vertexBuffer, const vki::Buffer &indexBuffer,
     const vki::GraphicsQueueMixin &graphicsQueue,
     const vki::PresentQueueMixin &presentQueue,
     const std::vector<void *> &uniformMapped,
+    const std::vector<void *> &instanceMapped,
     const vki::PipelineLayout &pipelineLayout,
-    const std::vector<VkDescriptorSet> &descriptorSets,
-    const FrameState &frameState, const DataAggregator &dataAggregator) {
+    FrameDescriptorSets &frameDescriptorSets,
+    const std::vector<FrameDescriptors> &frameDescriptors,
+    TextureStreamer &textureStreamer, BindlessTextures &bindlessTextures,
+    const FrameState &frameState, const DataAggregator &dataAggregator,
+    const std::span<const uint32_t> &drawOrder) {
     inFlightFence.waitAndReset();
+    frameArena.reset();
+    frameDescriptorSets.reset();
+    if (const auto &frameTime = frameTimer.read()) {
+        resolutionController.update(*frameTime);
+    };
+    occlusionCuller.update(
+        dataAggregator, drawOrder,
+        frameState.projection * frameState.getViewMatrix());
 
     uint32_t imageIndex =
         swapchain.acquireNextImageKHR(imageAvailableSemaphore);
+    frameGraph.graph.setImportedImage(
+        frameGraph.swapchainImage,
+        vki::ImageRef(swapchain.swapChainImages[imageIndex]));
     commandBuffer.reset();
-    recordCommandBuffer(framebuffers[imageIndex], swapchain, swapchainExtent,
-                        renderPass, pipeline, commandBuffer, vertexBuffer,
-                        indexBuffer, pipelineLayout, descriptorSets[imageIndex],
-                        dataAggregator);
+    recordCommandBuffer(swapchain.swapChainImageViews[imageIndex],
+                        swapchainExtent,
+                        resolutionController.getRenderExtent(swapchainExtent),
+                        pipeline, renderState, commandBuffer, frameGraph,
+                        frameArena, upscaler, depthPyramid, occlusionCuller,
+                        frameTimer, vertexBuffer, indexBuffer, pipelineLayout,
+                        frameDescriptorSets, frameDescriptors[imageIndex],
+                        textureStreamer, bindlessTextures);
     updateFrameUniformBuffer(uniformMapped[imageIndex], frameState);
+    const auto &instances = dataAggregator.getInstances();
+    memcpy(instanceMapped[imageIndex], instances.data(),
+           instances.size_bytes());
     const vki::SubmitInfo submitInfo(
         { .waitSemaphores = { &imageAvailableSemaphore },
           .signalSemaphores = { &renderFinishedSemaphore },
           .commandBuffers = { &commandBuffer },
           .waitStages = { VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT } });
-    graphicsQueue.submit({ submitInfo }, &inFlightFence);
+    graphicsQueue.submit(submitInfo, &inFlightFence);
 
     vki::PresentInfo presentInfo(
         { .waitSemaphores = { &renderFinishedSemaphore },
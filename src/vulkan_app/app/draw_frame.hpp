@@ -2,37 +2,93 @@
 
 #include <vulkan/vulkan_core.h>
 
+#include <cstdint>
+#include <span>
 #include <vector>
 
+#include "vulkan_app/app/bindless_textures.hpp"
 #include "vulkan_app/app/data_aggregator.hpp"
+#include "vulkan_app/app/depth_pyramid.hpp"
+#include "vulkan_app/app/frame_arena.hpp"
+#include "vulkan_app/app/frame_descriptors.hpp"
 #include "vulkan_app/app/frame_state.hpp"
+#include "vulkan_app/app/gpu_frame_timer.hpp"
+#include "vulkan_app/app/occlusion_culler.hpp"
+#include "vulkan_app/app/pipeline_description.hpp"
+#include "vulkan_app/app/render_graph.hpp"
+#include "vulkan_app/app/resolution_controller.hpp"
+#include "vulkan_app/app/spatial_upscaler.hpp"
+#include "vulkan_app/app/texture_streamer.hpp"
 #include "vulkan_app/vki/buffer.hpp"
 #include "vulkan_app/vki/command_buffer.hpp"
 #include "vulkan_app/vki/fence.hpp"
-#include "vulkan_app/vki/framebuffer.hpp"
 #include "vulkan_app/vki/graphics_pipeline.hpp"
 #include "vulkan_app/vki/logical_device.hpp"
 #include "vulkan_app/vki/pipeline_layout.hpp"
 #include "vulkan_app/vki/queue.hpp"
-#include "vulkan_app/vki/render_pass.hpp"
 #include "vulkan_app/vki/semaphore.hpp"
 #include "vulkan_app/vki/swapchain.hpp"
 
+// The graph of a frame's passes, and the handles of what drawFrame
+// records into them.
+struct FrameGraph {
+    RenderGraph graph;
+    uint32_t swapchainImage;
+    // The scene image itself when rendering without multisampling.
+    uint32_t colorImage;
+    // Single-sampled scene color, which the upscale pass samples.
+    uint32_t sceneImage;
+    uint32_t depthImage;
+    uint32_t earlyScenePass;
+    uint32_t pyramidPass;
+    uint32_t lateScenePass;
+    uint32_t upscalePass;
+};
+
+// The scene is drawn into transient multisampled color and depth images
+// in two phases around building the depth pyramid, and resolved into the
+// scene image, which is upscaled into the swapchain image and presented.
+// With a single sample it is drawn into the scene image directly. The
+// scene images are sized for the largest render extent; each frame draws
+// into as much of them as its own extent covers.
+FrameGraph createFrameGraph(
+    const vki::LogicalDevice &logicalDevice,
+    const VkPhysicalDeviceMemoryProperties &memoryProperties,
+    const VkFormat &swapchainFormat, const VkExtent2D &maxRenderExtent,
+    const VkFormat &depthFormat, const VkSampleCountFlagBits &sampleCount);
+// The same graph, not yet compiled.
+FrameGraph describeFrameGraph(const VkFormat &swapchainFormat,
+                              const VkExtent2D &maxRenderExtent,
+                              const VkFormat &depthFormat,
+                              const VkSampleCountFlagBits &sampleCount);
+
 void drawFrame(const vki::LogicalDevice &logicalDevice,
                const vki::Swapchain &swapchain,
                const VkExtent2D &swapchainExtent,
-               const vki::RenderPass &renderPass,
                const vki::GraphicsPipeline &pipeline,
-               const std::vector<vki::Framebuffer> &framebuffers,
+               const DynamicRenderState &renderState,
                const vki::CommandBuffer &commandBuffer,
+               FrameGraph &frameGraph,
+               FrameArena &frameArena,
+               const SpatialUpscaler &upscaler,
+               const DepthPyramid &depthPyramid,
+               OcclusionCuller &occlusionCuller,
+               GpuFrameTimer &frameTimer,
+               ResolutionController &resolutionController,
                const vki::Fence &inFlightFence,
                const vki::Semaphore &imageAvailableSemaphore,
                const vki::Semaphore &renderFinishedSemaphore,
-               const vki::Buffer &vertexBuffer, const vki::Buffer &indexBuffer,
+               const vki::Buffer &vertexBuffer,
+               const vki::Buffer &indexBuffer,
                const vki::GraphicsQueueMixin &graphicsQueue,
                const vki::PresentQueueMixin &presentQueue,
                const std::vector<void *> &uniformMapped,
+               const std::vector<void *> &instanceMapped,
                const vki::PipelineLayout &pipelineLayout,
-               const std::vector<VkDescriptorSet> &descriptorSets,
+               FrameDescriptorSets &frameDescriptorSets,
+               const std::vector<FrameDescriptors> &frameDescriptors,
+               TextureStreamer &textureStreamer,
+               BindlessTextures &bindlessTextures,
                const FrameState &frameState,
-               const DataAggregator& aggregator);
+               const DataAggregator &aggregator,
+               const std::span<const uint32_t> &drawOrder);
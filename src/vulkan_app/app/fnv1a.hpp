@@ -0,0 +1,36 @@
+#pragma once
+
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+constexpr uint64_t fnvOffsetBasis = 14695981039346656037ull;
+constexpr uint64_t fnvPrime = 1099511628211ull;
+
+// Stable across runs and platforms, unlike std::hash.
+template <typename T>
+constexpr uint64_t fnv1a(uint64_t hash, const T &bytes) {
+    for (const auto &byte : bytes) {
+        hash = (hash ^ static_cast<uint8_t>(byte)) * fnvPrime;
+    };
+    return hash;
+};
+
+// Hashes an integral, enum or floating point value byte by byte, lowest
+// byte first, so the result does not depend on the host's endianness.
+template <typename T>
+    requires std::is_arithmetic_v<T> || std::is_enum_v<T>
+constexpr uint64_t fnv1aValue(uint64_t hash, const T &value) {
+    uint64_t bits;
+    if constexpr (std::is_floating_point_v<T>) {
+        bits = std::bit_cast<
+            std::conditional_t<sizeof(T) == 8, uint64_t, uint32_t>>(value);
+    } else {
+        bits = static_cast<uint64_t>(value);
+    };
+    for (std::size_t i = 0; i < sizeof(T); i++) {
+        hash = (hash ^ ((bits >> (i * 8)) & 0xFF)) * fnvPrime;
+    };
+    return hash;
+};
@@ -0,0 +1,32 @@
+#include "./frame_arena.hpp"
+
+#include <cstddef>
+#include <memory>
+
+FrameArena::FrameArena(const std::size_t &capacity)
+    : block{ std::make_unique_for_overwrite<std::byte[]>(capacity) },
+      capacity{ capacity } {};
+
+void *FrameArena::allocateBytes(const std::size_t &size,
+                                const std::size_t &alignment) {
+    const std::size_t offset = (used + alignment - 1) & ~(alignment - 1);
+    if (offset + size <= capacity) {
+        used = offset + size;
+        return block.get() + offset;
+    };
+    overflow.push_back(std::make_unique_for_overwrite<std::byte[]>(size));
+    overflowSize += size;
+    return overflow.back().get();
+};
+
+void FrameArena::reset() {
+    if (!overflow.empty()) {
+        // Room for the overflow blocks' padding as well.
+        capacity = used + overflowSize +
+                   overflow.size() * __STDCPP_DEFAULT_NEW_ALIGNMENT__;
+        block = std::make_unique_for_overwrite<std::byte[]>(capacity);
+        overflow.clear();
+        overflowSize = 0;
+    };
+    used = 0;
+};
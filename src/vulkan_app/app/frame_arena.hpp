@@ -0,0 +1,42 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <span>
+#include <type_traits>
+#include <vector>
+
+// Bump allocation for arrays that are only needed while a frame is
+// recorded, all reclaimed at once by reset. A frame that outgrows the block
+// is served from separate overflow blocks, which the next reset replaces
+// with one block large enough for that frame, so frames stop allocating
+// once the block has grown to fit them.
+class FrameArena {
+    std::unique_ptr<std::byte[]> block;
+    std::size_t capacity;
+    std::size_t used = 0;
+    std::vector<std::unique_ptr<std::byte[]>> overflow;
+    std::size_t overflowSize = 0;
+
+    void *allocateBytes(const std::size_t &size,
+                        const std::size_t &alignment);
+
+public:
+    explicit FrameArena(const std::size_t &capacity);
+    FrameArena(const FrameArena &other) = delete;
+    FrameArena &operator=(const FrameArena &other) = delete;
+
+    // Invalidates everything allocated since the last reset.
+    void reset();
+
+    template <typename T>
+    std::span<T> allocate(const std::size_t &count) {
+        static_assert(std::is_trivially_destructible_v<T>,
+                      "Arena arrays are never destroyed");
+        static_assert(alignof(T) <= __STDCPP_DEFAULT_NEW_ALIGNMENT__);
+        auto *items =
+            static_cast<T *>(allocateBytes(sizeof(T) * count, alignof(T)));
+        std::uninitialized_default_construct_n(items, count);
+        return { items, count };
+    };
+};
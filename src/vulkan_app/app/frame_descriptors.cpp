@@ -0,0 +1,82 @@
+#include "./frame_descriptors.hpp"
+
+#include <cstdint>
+#include <memory>
+
+#include "vulkan_app/app/descriptor_allocator.hpp"
+#include "vulkan_app/app/descriptor_layout_cache.hpp"
+#include "vulkan_app/app/fnv1a.hpp"
+#include "vulkan_app/vki/command_buffer.hpp"
+#include "vulkan_app/vki/descriptor_set_layout.hpp"
+#include "vulkan_app/vki/descriptor_update_template.hpp"
+#include "vulkan_app/vki/logical_device.hpp"
+#include "vulkan_app/vki/pipeline_layout.hpp"
+
+bool FrameDescriptors::operator==(const FrameDescriptors &other) const {
+    return uniformBuffer.buffer == other.uniformBuffer.buffer &&
+           uniformBuffer.offset == other.uniformBuffer.offset &&
+           uniformBuffer.range == other.uniformBuffer.range &&
+           sampler.sampler == other.sampler.sampler &&
+           instances.buffer == other.instances.buffer &&
+           instances.offset == other.instances.offset &&
+           instances.range == other.instances.range;
+};
+
+uint64_t FrameDescriptors::hash() const {
+    uint64_t hash = fnv1aValue(
+        fnvOffsetBasis, reinterpret_cast<uint64_t>(uniformBuffer.buffer));
+    hash = fnv1aValue(hash, uniformBuffer.offset);
+    hash = fnv1aValue(hash, uniformBuffer.range);
+    hash = fnv1aValue(hash, reinterpret_cast<uint64_t>(sampler.sampler));
+    hash = fnv1aValue(hash, reinterpret_cast<uint64_t>(instances.buffer));
+    hash = fnv1aValue(hash, instances.offset);
+    return fnv1aValue(hash, instances.range);
+};
+
+FrameDescriptorSets::FrameDescriptorSets(
+    const vki::LogicalDevice &logicalDevice,
+    const DescriptorSetLayoutDescription &description,
+    const vki::DescriptorSetLayout &setLayout,
+    const vki::PipelineLayout &pipelineLayout, const uint32_t &setCount)
+    : pipelineLayout{ pipelineLayout }, setCount{ setCount } {
+    const auto &entries = FrameDescriptors::getTemplateEntries();
+    if (description.isPushDescriptor) {
+        updateTemplate = std::make_unique<vki::DescriptorUpdateTemplate>(
+            logicalDevice, setLayout, entries, pipelineLayout, 0);
+        return;
+    };
+    updateTemplate = std::make_unique<vki::DescriptorUpdateTemplate>(
+        logicalDevice, setLayout, entries);
+    allocator = std::make_unique<DescriptorAllocator>(
+        logicalDevice, description, setLayout, setCount);
+    cache = std::make_unique<FrameDescriptorSetCache>(*allocator,
+                                                      *updateTemplate);
+    frameAllocator = std::make_unique<DescriptorAllocator>(
+        logicalDevice, description, setLayout, setCount);
+};
+
+void FrameDescriptorSets::reset() {
+    if (frameAllocator) frameAllocator->reset();
+};
+
+void FrameDescriptorSets::bind(const vki::CommandBuffer &commandBuffer,
+                               const FrameDescriptors &descriptors) {
+    if (!cache) {
+        updateTemplate->push(commandBuffer, &descriptors);
+        return;
+    };
+    VkDescriptorSet descriptorSet;
+    if (cache->size() < setCount || cache->contains(descriptors)) {
+        descriptorSet = cache->get(descriptors);
+    } else {
+        descriptorSet = frameAllocator->allocate();
+        updateTemplate->update(descriptorSet, &descriptors);
+    };
+    commandBuffer.bindDescriptorSet({
+        .bindPointType = vki::PipelineBindPointType::GRAPHICS,
+        .pipelineLayout = pipelineLayout,
+        .firstSet = 0,
+        .descriptorSets = { descriptorSet },
+        .dynamicOffsets = {},
+    });
+};
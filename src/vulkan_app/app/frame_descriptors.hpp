@@ -0,0 +1,92 @@
+#pragma once
+
+#include <vulkan/vulkan_core.h>
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+#include "vulkan_app/app/descriptor_allocator.hpp"
+#include "vulkan_app/app/descriptor_layout_cache.hpp"
+#include "vulkan_app/vki/command_buffer.hpp"
+#include "vulkan_app/vki/descriptor_set_layout.hpp"
+#include "vulkan_app/vki/descriptor_update_template.hpp"
+#include "vulkan_app/vki/logical_device.hpp"
+#include "vulkan_app/vki/pipeline_layout.hpp"
+
+// Contents of descriptor set 0, laid out for its update template. They
+// differ only by uniform and instance buffer, which come in pairs, so there
+// is one distinct set per uniform buffer.
+struct FrameDescriptors {
+    VkDescriptorBufferInfo uniformBuffer;
+    VkDescriptorImageInfo sampler;
+    VkDescriptorBufferInfo instances;
+
+    bool operator==(const FrameDescriptors &other) const;
+    uint64_t hash() const;
+
+    static std::array<VkDescriptorUpdateTemplateEntry, 3>
+    getTemplateEntries() {
+        return {
+            (VkDescriptorUpdateTemplateEntry){
+                .dstBinding = 0,
+                .dstArrayElement = 0,
+                .descriptorCount = 1,
+                .descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER,
+                .offset = offsetof(FrameDescriptors, uniformBuffer),
+                .stride = sizeof(VkDescriptorBufferInfo) },
+            (VkDescriptorUpdateTemplateEntry){
+                .dstBinding = 1,
+                .dstArrayElement = 0,
+                .descriptorCount = 1,
+                .descriptorType = VK_DESCRIPTOR_TYPE_SAMPLER,
+                .offset = offsetof(FrameDescriptors, sampler),
+                .stride = sizeof(VkDescriptorImageInfo) },
+            (VkDescriptorUpdateTemplateEntry){
+                .dstBinding = 2,
+                .dstArrayElement = 0,
+                .descriptorCount = 1,
+                .descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER,
+                .offset = offsetof(FrameDescriptors, instances),
+                .stride = sizeof(VkDescriptorBufferInfo) },
+        };
+    };
+};
+
+struct FrameDescriptorsHash {
+    inline std::size_t operator()(const FrameDescriptors &descriptors) const {
+        return static_cast<std::size_t>(descriptors.hash());
+    };
+};
+
+using FrameDescriptorSetCache =
+    DescriptorSetCache<FrameDescriptors, FrameDescriptorsHash>;
+
+// Binds set 0 for a frame. If the layout is a push descriptor layout the
+// contents are pushed into the command buffer, and no set is allocated or
+// written. Otherwise the first setCount distinct contents are cached as
+// immutable sets, and any others are written into a set of the frame's
+// own, freed once the frame has finished.
+class FrameDescriptorSets {
+    const vki::PipelineLayout &pipelineLayout;
+    uint32_t setCount;
+    std::unique_ptr<vki::DescriptorUpdateTemplate> updateTemplate;
+    std::unique_ptr<DescriptorAllocator> allocator;
+    std::unique_ptr<FrameDescriptorSetCache> cache;
+    // Only one frame is in flight, so one allocator serves every frame.
+    std::unique_ptr<DescriptorAllocator> frameAllocator;
+
+public:
+    // setCount is the number of distinct contents that will be bound.
+    explicit FrameDescriptorSets(
+        const vki::LogicalDevice &logicalDevice,
+        const DescriptorSetLayoutDescription &description,
+        const vki::DescriptorSetLayout &setLayout,
+        const vki::PipelineLayout &pipelineLayout, const uint32_t &setCount);
+
+    // Frees the previous frame's sets, which the device must be done with.
+    void reset();
+    void bind(const vki::CommandBuffer &commandBuffer,
+              const FrameDescriptors &descriptors);
+};
@@ -4,7 +4,10 @@
 #include <ratio>
 
 #include "glm/ext/matrix_float4x4.hpp"
+#include "glm/ext/matrix_transform.hpp"
 #include "glm/ext/vector_float3.hpp"
+#include "glm/geometric.hpp"
+#include "vulkan_app/app/bounds.hpp"
 
 struct FrameState {
     glm::mat4 projection;
@@ -20,4 +23,13 @@ struct FrameState {
     float pitch;
     float yaw;
     bool firstMouse;
+
+    inline glm::mat4 getViewMatrix() const {
+        return glm::lookAt(cameraPos, cameraPos + cameraFront, cameraUp);
+    };
+
+    inline Ray getCameraRay() const {
+        return { .origin = cameraPos,
+                 .direction = glm::normalize(cameraFront) };
+    };
 };
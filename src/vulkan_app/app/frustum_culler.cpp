@@ -0,0 +1,171 @@
+#include "./frustum_culler.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+
+#include "vulkan_app/app/bounds.hpp"
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__)
+#define FRUSTUM_CULLER_X86
+#include <immintrin.h>
+#endif
+
+namespace {
+inline std::size_t emitBatch(uint32_t *out, std::size_t count,
+                             const uint32_t &base, const unsigned int &mask) {
+    for (unsigned int lane = 0; lane < 8; lane++) {
+        out[count] = base + lane;
+        count += (mask >> lane) & 1;
+    };
+    return count;
+};
+
+std::size_t cullScalar(const ShapeBounds &bounds, const Frustum &frustum,
+                       const std::size_t &first, uint32_t *out,
+                       std::size_t count) {
+    for (std::size_t i = first; i < bounds.size(); i++) {
+        bool isVisible = true;
+        for (const auto &plane : frustum.planes) {
+            const float distance = plane.x * bounds.centerX[i] +
+                                   plane.y * bounds.centerY[i] +
+                                   plane.z * bounds.centerZ[i] + plane.w;
+            isVisible &= distance >= -bounds.radius[i];
+        };
+        out[count] = static_cast<uint32_t>(i);
+        count += isVisible;
+    };
+    return count;
+};
+
+// Spheres of long or flat shapes reach well past their boxes, so shapes
+// whose spheres pass are tested again against their boxes.
+std::size_t cullBoxes(const ShapeBounds &bounds, const Frustum &frustum,
+                      uint32_t *visible, const std::size_t &visibleCount) {
+    std::size_t count = 0;
+    for (std::size_t i = 0; i < visibleCount; i++) {
+        const auto &shape = visible[i];
+        bool isVisible = true;
+        for (const auto &plane : frustum.planes) {
+            const float distance =
+                plane.x * (plane.x >= 0.0f ? bounds.maxX[shape]
+                                           : bounds.minX[shape]) +
+                plane.y * (plane.y >= 0.0f ? bounds.maxY[shape]
+                                           : bounds.minY[shape]) +
+                plane.z * (plane.z >= 0.0f ? bounds.maxZ[shape]
+                                           : bounds.minZ[shape]) +
+                plane.w;
+            isVisible &= distance >= 0.0f;
+        };
+        visible[count] = shape;
+        count += isVisible;
+    };
+    return count;
+};
+
+#ifdef FRUSTUM_CULLER_X86
+std::size_t cullSSE(const ShapeBounds &bounds, const Frustum &frustum,
+                    uint32_t *out, std::size_t &processed) {
+    const std::size_t batches = bounds.size() / 8;
+    std::size_t count = 0;
+    for (std::size_t batch = 0; batch < batches; batch++) {
+        const std::size_t base = batch * 8;
+        const __m128 x0 = _mm_loadu_ps(&bounds.centerX[base]);
+        const __m128 x1 = _mm_loadu_ps(&bounds.centerX[base + 4]);
+        const __m128 y0 = _mm_loadu_ps(&bounds.centerY[base]);
+        const __m128 y1 = _mm_loadu_ps(&bounds.centerY[base + 4]);
+        const __m128 z0 = _mm_loadu_ps(&bounds.centerZ[base]);
+        const __m128 z1 = _mm_loadu_ps(&bounds.centerZ[base + 4]);
+        const __m128 zero = _mm_setzero_ps();
+        const __m128 r0 = _mm_sub_ps(zero, _mm_loadu_ps(&bounds.radius[base]));
+        const __m128 r1 =
+            _mm_sub_ps(zero, _mm_loadu_ps(&bounds.radius[base + 4]));
+        __m128 visible0 = _mm_castsi128_ps(_mm_set1_epi32(-1));
+        __m128 visible1 = visible0;
+        for (const auto &plane : frustum.planes) {
+            const __m128 nx = _mm_set1_ps(plane.x);
+            const __m128 ny = _mm_set1_ps(plane.y);
+            const __m128 nz = _mm_set1_ps(plane.z);
+            const __m128 d = _mm_set1_ps(plane.w);
+            const __m128 distance0 = _mm_add_ps(
+                _mm_add_ps(_mm_mul_ps(nx, x0), _mm_mul_ps(ny, y0)),
+                _mm_add_ps(_mm_mul_ps(nz, z0), d));
+            const __m128 distance1 = _mm_add_ps(
+                _mm_add_ps(_mm_mul_ps(nx, x1), _mm_mul_ps(ny, y1)),
+                _mm_add_ps(_mm_mul_ps(nz, z1), d));
+            visible0 = _mm_and_ps(visible0, _mm_cmpge_ps(distance0, r0));
+            visible1 = _mm_and_ps(visible1, _mm_cmpge_ps(distance1, r1));
+        };
+        const unsigned int mask = _mm_movemask_ps(visible0) |
+                                  (_mm_movemask_ps(visible1) << 4);
+        count = emitBatch(out, count, static_cast<uint32_t>(base), mask);
+    };
+    processed = batches * 8;
+    return count;
+};
+
+#if defined(__GNUC__) || defined(__clang__)
+#define FRUSTUM_CULLER_AVX2
+
+__attribute__((target("avx2"))) std::size_t cullAVX2(
+    const ShapeBounds &bounds, const Frustum &frustum, uint32_t *out,
+    std::size_t &processed) {
+    const std::size_t batches = bounds.size() / 8;
+    std::size_t count = 0;
+    __m256 nx[6], ny[6], nz[6], d[6];
+    for (unsigned int i = 0; i < 6; i++) {
+        nx[i] = _mm256_set1_ps(frustum.planes[i].x);
+        ny[i] = _mm256_set1_ps(frustum.planes[i].y);
+        nz[i] = _mm256_set1_ps(frustum.planes[i].z);
+        d[i] = _mm256_set1_ps(frustum.planes[i].w);
+    };
+    for (std::size_t batch = 0; batch < batches; batch++) {
+        const std::size_t base = batch * 8;
+        const __m256 x = _mm256_loadu_ps(&bounds.centerX[base]);
+        const __m256 y = _mm256_loadu_ps(&bounds.centerY[base]);
+        const __m256 z = _mm256_loadu_ps(&bounds.centerZ[base]);
+        const __m256 negativeRadius = _mm256_sub_ps(
+            _mm256_setzero_ps(), _mm256_loadu_ps(&bounds.radius[base]));
+        __m256 visible = _mm256_castsi256_ps(_mm256_set1_epi32(-1));
+        for (unsigned int i = 0; i < 6; i++) {
+            const __m256 distance = _mm256_add_ps(
+                _mm256_add_ps(_mm256_mul_ps(nx[i], x), _mm256_mul_ps(ny[i], y)),
+                _mm256_add_ps(_mm256_mul_ps(nz[i], z), d[i]));
+            visible = _mm256_and_ps(
+                visible, _mm256_cmp_ps(distance, negativeRadius, _CMP_GE_OQ));
+        };
+        const unsigned int mask = _mm256_movemask_ps(visible);
+        count = emitBatch(out, count, static_cast<uint32_t>(base), mask);
+    };
+    processed = batches * 8;
+    return count;
+};
+
+bool hasAVX2() {
+    static const bool supported = __builtin_cpu_supports("avx2");
+    return supported;
+};
+#endif
+#endif
+};  // namespace
+
+std::span<const uint32_t> FrustumCuller::cull(const ShapeBounds &bounds,
+                                              const Frustum &frustum) {
+    // Every batch stores all eight lanes and only advances past the visible
+    // ones, so keep a full batch of slack at the end.
+    visible.resize(bounds.size() + batchSize);
+    std::size_t processed = 0;
+    std::size_t count = 0;
+#if defined(FRUSTUM_CULLER_AVX2)
+    if (hasAVX2()) {
+        count = cullAVX2(bounds, frustum, visible.data(), processed);
+    } else {
+        count = cullSSE(bounds, frustum, visible.data(), processed);
+    };
+#elif defined(FRUSTUM_CULLER_X86)
+    count = cullSSE(bounds, frustum, visible.data(), processed);
+#endif
+    count = cullScalar(bounds, frustum, processed, visible.data(), count);
+    count = cullBoxes(bounds, frustum, visible.data(), count);
+    return std::span<const uint32_t>(visible.data(), count);
+};
@@ -0,0 +1,20 @@
+#pragma once
+
+#include <cstdint>
+#include <span>
+#include <vector>
+
+#include "vulkan_app/app/bounds.hpp"
+
+// Tests bounding spheres against the frustum eight shapes at a time (AVX2,
+// or two SSE registers) and writes the indices of visible shapes into a
+// reusable compact list, then drops the shapes whose boxes are outside.
+class FrustumCuller {
+    std::vector<uint32_t> visible;
+
+public:
+    static constexpr unsigned int batchSize = 8;
+
+    std::span<const uint32_t> cull(const ShapeBounds &bounds,
+                                   const Frustum &frustum);
+};
@@ -0,0 +1,58 @@
+#include "./gpu_frame_timer.hpp"
+
+#include <vulkan/vulkan_core.h>
+
+#include <array>
+#include <cstdint>
+#include <optional>
+
+#include "vulkan_app/vki/command_buffer.hpp"
+#include "vulkan_app/vki/logical_device.hpp"
+#include "vulkan_app/vki/physical_device.hpp"
+#include "vulkan_app/vki/query_pool.hpp"
+
+namespace {
+constexpr uint32_t queryCount = 2;
+
+VkQueryPoolCreateInfo timestampPoolCreateInfo() {
+    return { .sType = VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO,
+             .queryType = VK_QUERY_TYPE_TIMESTAMP,
+             .queryCount = queryCount };
+};
+};  // namespace
+
+GpuFrameTimer::GpuFrameTimer(const vki::LogicalDevice &logicalDevice,
+                             const vki::PhysicalDevice &physicalDevice,
+                             const uint32_t &timestampValidBits)
+    : queryPool{ logicalDevice, timestampPoolCreateInfo() },
+      millisecondsPerTick{
+          physicalDevice.properties.limits.timestampPeriod / 1e6 },
+      validMask{ timestampValidBits >= 64
+                     ? ~uint64_t{ 0 }
+                     : (uint64_t{ 1 } << timestampValidBits) - 1 },
+      isSupported{ timestampValidBits != 0 } {};
+
+void GpuFrameTimer::begin(const vki::CommandBuffer &commandBuffer) {
+    if (!isSupported) return;
+    commandBuffer.resetQueryPool(queryPool, 0, queryCount);
+    commandBuffer.writeTimestamp(VK_PIPELINE_STAGE_2_TOP_OF_PIPE_BIT,
+                                 queryPool, 0);
+    isPending = true;
+};
+
+void GpuFrameTimer::end(const vki::CommandBuffer &commandBuffer) const {
+    if (!isSupported) return;
+    commandBuffer.writeTimestamp(VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT,
+                                 queryPool, 1);
+};
+
+std::optional<float> GpuFrameTimer::read() {
+    std::array<uint64_t, queryCount> timestamps;
+    if (!isPending || !queryPool.getResults(0, timestamps)) {
+        return std::nullopt;
+    };
+    isPending = false;
+    // The counter may wrap around between the two timestamps.
+    const auto &ticks = (timestamps[1] - timestamps[0]) & validMask;
+    return static_cast<float>(ticks * millisecondsPerTick);
+};
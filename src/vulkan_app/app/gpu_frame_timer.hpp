@@ -0,0 +1,35 @@
+#pragma once
+
+#include <cstdint>
+#include <optional>
+
+#include "vulkan_app/vki/command_buffer.hpp"
+#include "vulkan_app/vki/logical_device.hpp"
+#include "vulkan_app/vki/physical_device.hpp"
+#include "vulkan_app/vki/query_pool.hpp"
+
+// Measures how long the device spends on a frame's commands, between
+// timestamps written at either end of its command buffer. A frame's time
+// can be read once its fence has signalled.
+class GpuFrameTimer {
+    vki::QueryPool queryPool;
+    double millisecondsPerTick;
+    uint64_t validMask;
+    bool isSupported;
+    bool isPending = false;
+
+public:
+    // Queue families without timestamp bits measure nothing.
+    explicit GpuFrameTimer(const vki::LogicalDevice &logicalDevice,
+                           const vki::PhysicalDevice &physicalDevice,
+                           const uint32_t &timestampValidBits);
+    GpuFrameTimer(const GpuFrameTimer &other) = delete;
+    GpuFrameTimer &operator=(const GpuFrameTimer &other) = delete;
+
+    // Recorded first and last in the frame's command buffer.
+    void begin(const vki::CommandBuffer &commandBuffer);
+    void end(const vki::CommandBuffer &commandBuffer) const;
+    // The last recorded frame's time in milliseconds, once, and only if
+    // the device has finished it.
+    std::optional<float> read();
+};
@@ -2,29 +2,245 @@
 
 #include <stdlib.h>
 
+#include <array>
 #include <cassert>
+#include <csetjmp>
+#include <cstddef>
 #include <cstdint>
 #include <cstring>
-#include <filesystem>
+#include <format>
+#include <span>
+#include <stdexcept>
+#include <string>
 
-#include "assets.hpp"
+#include "png.h"
 #include "turbojpeg.h"
 
-ImageData load_jpeg_image(const std::filesystem::path &filepath) {
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__)
+#define IMAGE_LOADERS_X86
+#include <immintrin.h>
+#endif
+
+namespace {
+constexpr std::array<uint8_t, 8> pngSignature = { 0x89, 'P',  'N',  'G',
+                                                  '\r', '\n', 0x1A, '\n' };
+constexpr std::array<uint8_t, 2> jpegSignature = { 0xFF, 0xD8 };
+
+bool hasSignature(const std::span<const uint8_t> &encoded,
+                  const std::span<const uint8_t> &signature) {
+    return encoded.size() >= signature.size() &&
+           std::memcmp(encoded.data(), signature.data(), signature.size()) ==
+               0;
+};
+
+struct PngDecodeState {
+    uint8_t *destination;
+    std::size_t rowPitch;
+    png_uint_32 width;
+    png_uint_32 height;
+    bool isRGB;
+    bool isComplete;
+};
+
+void pngInfoCallback(png_structp png, png_infop info) {
+    auto &state = *static_cast<PngDecodeState *>(png_get_progressive_ptr(png));
+    if (png_get_image_width(png, info) != state.width ||
+        png_get_image_height(png, info) != state.height) {
+        png_error(png, "PNG size does not match its header");
+    };
+    const auto colorType = png_get_color_type(png, info);
+    const bool hasTransparency = png_get_valid(png, info, PNG_INFO_tRNS);
+    png_set_strip_16(png);
+    png_set_packing(png);
+    if (colorType == PNG_COLOR_TYPE_PALETTE) png_set_palette_to_rgb(png);
+    if (colorType == PNG_COLOR_TYPE_GRAY ||
+        colorType == PNG_COLOR_TYPE_GRAY_ALPHA) {
+        png_set_expand_gray_1_2_4_to_8(png);
+        png_set_gray_to_rgb(png);
+    };
+    if (hasTransparency) png_set_tRNS_to_alpha(png);
+    const bool hasAlpha =
+        (colorType & PNG_COLOR_MASK_ALPHA) != 0 || hasTransparency;
+    const bool isInterlaced = png_set_interlace_handling(png) > 1;
+    // Interlaced passes are merged into the destination by libpng, which
+    // needs rows in the final layout, so let it add the alpha there.
+    if (!hasAlpha && isInterlaced) {
+        png_set_filler(png, 0xFF, PNG_FILLER_AFTER);
+    };
+    state.isRGB = !hasAlpha && !isInterlaced;
+    png_start_read_image(png);
+};
+
+void pngRowCallback(png_structp png, png_bytep row, png_uint_32 rowIndex,
+                    int pass) {
+    if (row == nullptr) return;
+    auto &state = *static_cast<PngDecodeState *>(png_get_progressive_ptr(png));
+    uint8_t *destinationRow = state.destination + rowIndex * state.rowPitch;
+    if (state.isRGB) {
+        expand_rgb_to_rgba(row, destinationRow, state.width);
+    } else {
+        png_progressive_combine_row(png, destinationRow, row);
+    };
+};
+
+void pngEndCallback(png_structp png, png_infop info) {
+    static_cast<PngDecodeState *>(png_get_progressive_ptr(png))->isComplete =
+        true;
+};
+
+// Kept free of objects with destructors since libpng reports errors with
+// longjmp.
+bool processPng(png_structp png, png_infop info,
+                const std::span<const uint8_t> &encoded,
+                PngDecodeState &state) {
+    if (setjmp(png_jmpbuf(png))) return false;
+    png_set_progressive_read_fn(png, &state, pngInfoCallback, pngRowCallback,
+                                pngEndCallback);
+    png_process_data(png, info, const_cast<png_bytep>(encoded.data()),
+                     encoded.size());
+    return state.isComplete;
+};
+
+void expandRGBToRGBAScalar(const uint8_t *source, uint8_t *destination,
+                           const std::size_t &first,
+                           const std::size_t &pixelCount) {
+    for (std::size_t i = first; i < pixelCount; i++) {
+        destination[i * 4] = source[i * 3];
+        destination[i * 4 + 1] = source[i * 3 + 1];
+        destination[i * 4 + 2] = source[i * 3 + 2];
+        destination[i * 4 + 3] = 0xFF;
+    };
+};
+
+#if defined(IMAGE_LOADERS_X86) && (defined(__GNUC__) || defined(__clang__))
+#define IMAGE_LOADERS_SSSE3
+
+// Expands four pixels per shuffle. Each load reads 16 bytes for 12 bytes
+// of input, so stop while at least two pixels of slack remain.
+__attribute__((target("ssse3"))) std::size_t expandRGBToRGBASSSE3(
+    const uint8_t *source, uint8_t *destination,
+    const std::size_t &pixelCount) {
+    const __m128i shuffle =
+        _mm_setr_epi8(0, 1, 2, -1, 3, 4, 5, -1, 6, 7, 8, -1, 9, 10, 11, -1);
+    const __m128i alpha = _mm_set1_epi32(static_cast<int>(0xFF000000));
+    std::size_t i = 0;
+    for (; i + 6 <= pixelCount; i += 4) {
+        const __m128i rgb = _mm_loadu_si128(
+            reinterpret_cast<const __m128i *>(source + i * 3));
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(destination + i * 4),
+                         _mm_or_si128(_mm_shuffle_epi8(rgb, shuffle), alpha));
+    };
+    return i;
+};
+
+bool hasSSSE3() {
+    static const bool supported = __builtin_cpu_supports("ssse3");
+    return supported;
+};
+#endif
+};  // namespace
+
+ImageHeader read_jpeg_header(const std::span<const uint8_t> &encoded) {
     tjhandle _jpegDecompressor = tjInitDecompress();
     int width, height;
     int jpegSubsamp;
-    const auto &compressedData = const_cast<uint8_t *>(checkJpgAsset.data());
-    tjDecompressHeader2(_jpegDecompressor, compressedData, checkJpgAsset.size(),
-                        &width, &height, &jpegSubsamp);
+    const auto &compressedData = const_cast<uint8_t *>(encoded.data());
+    const int result =
+        tjDecompressHeader2(_jpegDecompressor, compressedData, encoded.size(),
+                            &width, &height, &jpegSubsamp);
+    const std::string error = tjGetErrorStr2(_jpegDecompressor);
+    tjDestroy(_jpegDecompressor);
+    if (result != 0) {
+        throw std::runtime_error(
+            std::format("Failed to read JPEG header: {}", error));
+    };
     assert(width > 0);
     assert(height > 0);
-    uint8_t *buffer = new uint8_t[width * height * 4];
-    tjDecompress2(_jpegDecompressor, compressedData, checkJpgAsset.size(),
-                  buffer, width, 0 /*pitch*/, height, TJPF_RGBA,
-                  TJFLAG_FASTDCT);
-    tjDestroy(_jpegDecompressor);
     return { .width = static_cast<unsigned int>(width),
-             .height = static_cast<unsigned int>(height),
-             .buffer = buffer };
+             .height = static_cast<unsigned int>(height) };
+};
+
+ImageHeader read_png_header(const std::span<const uint8_t> &encoded) {
+    png_image image;
+    std::memset(&image, 0, sizeof(image));
+    image.version = PNG_IMAGE_VERSION;
+    if (!png_image_begin_read_from_memory(&image, encoded.data(),
+                                          encoded.size())) {
+        throw std::runtime_error(
+            std::format("Failed to read PNG header: {}", image.message));
+    };
+    png_image_free(&image);
+    return { .width = image.width, .height = image.height };
+};
+
+ImageHeader read_image_header(const std::span<const uint8_t> &encoded) {
+    if (hasSignature(encoded, pngSignature)) return read_png_header(encoded);
+    if (hasSignature(encoded, jpegSignature)) return read_jpeg_header(encoded);
+    throw std::runtime_error("Unsupported image format");
+};
+
+void decode_jpeg_image(const std::span<const uint8_t> &encoded,
+                       uint8_t *destination, const std::size_t &rowPitch) {
+    tjhandle _jpegDecompressor = tjInitDecompress();
+    int width, height;
+    int jpegSubsamp;
+    const auto &compressedData = const_cast<uint8_t *>(encoded.data());
+    // turbojpeg converts to RGBA in its own SIMD color conversion.
+    const bool isFailed =
+        tjDecompressHeader2(_jpegDecompressor, compressedData, encoded.size(),
+                            &width, &height, &jpegSubsamp) != 0 ||
+        tjDecompress2(_jpegDecompressor, compressedData, encoded.size(),
+                      destination, width, static_cast<int>(rowPitch), height,
+                      TJPF_RGBA, TJFLAG_FASTDCT) != 0;
+    const std::string error = tjGetErrorStr2(_jpegDecompressor);
+    tjDestroy(_jpegDecompressor);
+    if (isFailed) {
+        throw std::runtime_error(
+            std::format("Failed to decode JPEG: {}", error));
+    };
+};
+
+void decode_png_image(const std::span<const uint8_t> &encoded,
+                      uint8_t *destination, const std::size_t &rowPitch) {
+    const auto &header = read_png_header(encoded);
+    png_structp png = png_create_read_struct(PNG_LIBPNG_VER_STRING, nullptr,
+                                             nullptr, nullptr);
+    png_infop info = png != nullptr ? png_create_info_struct(png) : nullptr;
+    if (info == nullptr) {
+        png_destroy_read_struct(&png, nullptr, nullptr);
+        throw std::runtime_error("Failed to create PNG decoder");
+    };
+    PngDecodeState state = { .destination = destination,
+                             .rowPitch = rowPitch,
+                             .width = header.width,
+                             .height = header.height,
+                             .isRGB = false,
+                             .isComplete = false };
+    const bool isDecoded = processPng(png, info, encoded, state);
+    png_destroy_read_struct(&png, &info, nullptr);
+    if (!isDecoded) throw std::runtime_error("Failed to decode PNG");
+};
+
+void decode_image(const std::span<const uint8_t> &encoded,
+                  uint8_t *destination, const std::size_t &rowPitch) {
+    if (hasSignature(encoded, pngSignature)) {
+        decode_png_image(encoded, destination, rowPitch);
+        return;
+    };
+    if (hasSignature(encoded, jpegSignature)) {
+        decode_jpeg_image(encoded, destination, rowPitch);
+        return;
+    };
+    throw std::runtime_error("Unsupported image format");
+};
+
+void expand_rgb_to_rgba(const uint8_t *source, uint8_t *destination,
+                        const std::size_t &pixelCount) {
+    std::size_t processed = 0;
+#ifdef IMAGE_LOADERS_SSSE3
+    if (hasSSSE3()) {
+        processed = expandRGBToRGBASSSE3(source, destination, pixelCount);
+    };
+#endif
+    expandRGBToRGBAScalar(source, destination, processed, pixelCount);
 };
@@ -1,16 +1,37 @@
 #pragma once
 
+#include <cstddef>
 #include <cstdint>
-#include <filesystem>
+#include <span>
 
-struct ImageData {
+// Decoded images are always 8-bit RGBA.
+struct ImageHeader {
     unsigned int width;
     unsigned int height;
-    uint8_t* buffer;
 
-    ~ImageData() {
-        delete buffer;
+    inline std::size_t rowPitch() const {
+        return static_cast<std::size_t>(width) * 4;
     };
+    inline std::size_t size() const { return rowPitch() * height; };
 };
 
-ImageData load_jpeg_image(const std::filesystem::path &filename);
+ImageHeader read_jpeg_header(const std::span<const uint8_t> &encoded);
+
+ImageHeader read_png_header(const std::span<const uint8_t> &encoded);
+
+// Picks the format from the file signature.
+ImageHeader read_image_header(const std::span<const uint8_t> &encoded);
+
+// Decoders write rows straight into the destination, which must hold
+// rowPitch bytes for each of the header's rows.
+void decode_jpeg_image(const std::span<const uint8_t> &encoded,
+                       uint8_t *destination, const std::size_t &rowPitch);
+
+void decode_png_image(const std::span<const uint8_t> &encoded,
+                      uint8_t *destination, const std::size_t &rowPitch);
+
+void decode_image(const std::span<const uint8_t> &encoded,
+                  uint8_t *destination, const std::size_t &rowPitch);
+
+void expand_rgb_to_rgba(const uint8_t *source, uint8_t *destination,
+                        const std::size_t &pixelCount);
@@ -0,0 +1,9 @@
+#pragma once
+
+#include <cstdint>
+
+// Per-shape attributes, read by shader.vert from a storage buffer indexed
+// by shape. Matches Instance there.
+struct InstanceData {
+    uint32_t textureIndex;
+};
@@ -0,0 +1,188 @@
+#include "./ktx2.hpp"
+
+#include <vulkan/vulkan_core.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <format>
+#include <numeric>
+#include <span>
+#include <stdexcept>
+#include <vector>
+
+namespace {
+constexpr std::size_t headerSize = 80;
+constexpr std::size_t levelIndexEntrySize = 24;
+
+// Khronos Data Format descriptor values used by the supported formats.
+constexpr uint8_t dfdModelRGBSDA = 1;
+constexpr uint8_t dfdModelBC1A = 128;
+constexpr uint8_t dfdModelBC7 = 134;
+constexpr uint8_t dfdPrimariesBT709 = 1;
+constexpr uint8_t dfdTransferSRGB = 2;
+constexpr uint8_t dfdChannelLinear = 0x10;
+
+struct DFDSample {
+    uint16_t bitOffset;
+    uint8_t bitLength;
+    uint8_t channelType;
+    uint32_t upper;
+};
+
+struct FormatDescription {
+    uint8_t colorModel;
+    uint8_t blockWidth;
+    uint8_t blockHeight;
+    uint8_t bytesPerBlock;
+    std::vector<DFDSample> samples;
+};
+
+FormatDescription describeFormat(const VkFormat &format) {
+    switch (format) {
+        case VK_FORMAT_BC1_RGB_SRGB_BLOCK:
+            return { .colorModel = dfdModelBC1A,
+                     .blockWidth = 4,
+                     .blockHeight = 4,
+                     .bytesPerBlock = 8,
+                     .samples = { { 0, 63, 0, 0xFFFFFFFF } } };
+        case VK_FORMAT_BC7_SRGB_BLOCK:
+            return { .colorModel = dfdModelBC7,
+                     .blockWidth = 4,
+                     .blockHeight = 4,
+                     .bytesPerBlock = 16,
+                     .samples = { { 0, 127, 0, 0xFFFFFFFF } } };
+        case VK_FORMAT_R8G8B8A8_SRGB:
+            return { .colorModel = dfdModelRGBSDA,
+                     .blockWidth = 1,
+                     .blockHeight = 1,
+                     .bytesPerBlock = 4,
+                     .samples = { { 0, 7, 0, 255 },
+                                  { 8, 7, 1, 255 },
+                                  { 16, 7, 2, 255 },
+                                  { 24, 7, 15 | dfdChannelLinear, 255 } } };
+        default:
+            throw std::runtime_error(
+                std::format("Unsupported KTX2 format: {}",
+                            static_cast<int>(format)));
+    };
+};
+
+template <typename T>
+T readValue(const std::span<const uint8_t> &encoded,
+            const std::size_t &offset) {
+    if (offset + sizeof(T) > encoded.size()) {
+        throw std::runtime_error("Truncated KTX2 file");
+    };
+    T value;
+    std::memcpy(&value, encoded.data() + offset, sizeof(T));
+    return value;
+};
+
+template <typename T>
+void writeValue(std::vector<uint8_t> &out, const std::size_t &offset,
+                const T &value) {
+    std::memcpy(out.data() + offset, &value, sizeof(T));
+};
+};  // namespace
+
+bool is_ktx2(const std::span<const uint8_t> &encoded) {
+    return encoded.size() >= ktx2Identifier.size() &&
+           std::equal(ktx2Identifier.begin(), ktx2Identifier.end(),
+                      encoded.begin());
+};
+
+KTX2Image read_ktx2(const std::span<const uint8_t> &encoded) {
+    if (!is_ktx2(encoded) || encoded.size() < headerSize) {
+        throw std::runtime_error("Not a KTX2 file");
+    };
+    const auto format = static_cast<VkFormat>(readValue<uint32_t>(encoded, 12));
+    const auto width = readValue<uint32_t>(encoded, 20);
+    const auto height = readValue<uint32_t>(encoded, 24);
+    const auto depth = readValue<uint32_t>(encoded, 28);
+    const auto layerCount = readValue<uint32_t>(encoded, 32);
+    const auto faceCount = readValue<uint32_t>(encoded, 36);
+    const auto levelCount = std::max(readValue<uint32_t>(encoded, 40), 1u);
+    const auto supercompression = readValue<uint32_t>(encoded, 44);
+    if (format == VK_FORMAT_UNDEFINED || width == 0 || height == 0 ||
+        depth != 0 || layerCount > 1 || faceCount != 1) {
+        throw std::runtime_error("Only 2D KTX2 textures are supported");
+    };
+    if (supercompression != 0) {
+        throw std::runtime_error("Supercompressed KTX2 is not supported");
+    };
+    KTX2Image image = { .format = format, .width = width, .height = height };
+    image.levels.reserve(levelCount);
+    for (uint32_t level = 0; level < levelCount; level++) {
+        const auto &entryOffset = headerSize + level * levelIndexEntrySize;
+        const auto offset = readValue<uint64_t>(encoded, entryOffset);
+        const auto length = readValue<uint64_t>(encoded, entryOffset + 8);
+        if (offset > encoded.size() || length > encoded.size() - offset) {
+            throw std::runtime_error("KTX2 level is out of bounds");
+        };
+        image.levels.push_back(encoded.subspan(offset, length));
+    };
+    return image;
+};
+
+std::vector<uint8_t> write_ktx2(const KTX2Image &image) {
+    const auto &description = describeFormat(image.format);
+    const auto levelCount = static_cast<uint32_t>(image.levels.size());
+    const uint32_t dfdOffset = headerSize + levelCount * levelIndexEntrySize;
+    const uint32_t blockSize = 24 + 16 * description.samples.size();
+    const uint32_t dfdSize = 4 + blockSize;
+    const std::size_t alignment = std::lcm(description.bytesPerBlock, 4);
+
+    // Levels are stored smallest first, each aligned to the block size.
+    std::vector<uint64_t> levelOffsets(levelCount);
+    std::size_t size = dfdOffset + dfdSize;
+    for (uint32_t level = levelCount; level-- > 0;) {
+        size = (size + alignment - 1) / alignment * alignment;
+        levelOffsets[level] = size;
+        size += image.levels[level].size();
+    };
+
+    std::vector<uint8_t> out(size, 0);
+    std::copy(ktx2Identifier.begin(), ktx2Identifier.end(), out.begin());
+    writeValue<uint32_t>(out, 12, image.format);
+    writeValue<uint32_t>(out, 16, 1);
+    writeValue<uint32_t>(out, 20, image.width);
+    writeValue<uint32_t>(out, 24, image.height);
+    writeValue<uint32_t>(out, 28, 0);
+    writeValue<uint32_t>(out, 32, 0);
+    writeValue<uint32_t>(out, 36, 1);
+    writeValue<uint32_t>(out, 40, levelCount);
+    writeValue<uint32_t>(out, 44, 0);
+    writeValue<uint32_t>(out, 48, dfdOffset);
+    writeValue<uint32_t>(out, 52, dfdSize);
+    for (uint32_t level = 0; level < levelCount; level++) {
+        const auto &entryOffset = headerSize + level * levelIndexEntrySize;
+        const uint64_t length = image.levels[level].size();
+        writeValue<uint64_t>(out, entryOffset, levelOffsets[level]);
+        writeValue<uint64_t>(out, entryOffset + 8, length);
+        writeValue<uint64_t>(out, entryOffset + 16, length);
+        std::copy(image.levels[level].begin(), image.levels[level].end(),
+                  out.begin() + levelOffsets[level]);
+    };
+
+    writeValue<uint32_t>(out, dfdOffset, dfdSize);
+    // Basic descriptor block, version 2.
+    writeValue<uint32_t>(out, dfdOffset + 4, 0);
+    writeValue<uint32_t>(out, dfdOffset + 8, 2 | (blockSize << 16));
+    out[dfdOffset + 12] = description.colorModel;
+    out[dfdOffset + 13] = dfdPrimariesBT709;
+    out[dfdOffset + 14] = dfdTransferSRGB;
+    out[dfdOffset + 16] = description.blockWidth - 1;
+    out[dfdOffset + 17] = description.blockHeight - 1;
+    out[dfdOffset + 20] = description.bytesPerBlock;
+    for (std::size_t i = 0; i < description.samples.size(); i++) {
+        const auto &sample = description.samples[i];
+        const std::size_t sampleOffset = dfdOffset + 28 + i * 16;
+        writeValue<uint16_t>(out, sampleOffset, sample.bitOffset);
+        out[sampleOffset + 2] = sample.bitLength;
+        out[sampleOffset + 3] = sample.channelType;
+        writeValue<uint32_t>(out, sampleOffset + 12, sample.upper);
+    };
+    return out;
+};
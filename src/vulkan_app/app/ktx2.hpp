@@ -0,0 +1,30 @@
+#pragma once
+
+#include <vulkan/vulkan_core.h>
+
+#include <array>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+constexpr std::array<uint8_t, 12> ktx2Identifier = {
+    0xAB, 'K', 'T', 'X', ' ', '2', '0', 0xBB, '\r', '\n', 0x1A, '\n'
+};
+
+// Only single-layer 2D textures without supercompression are supported.
+struct KTX2Image {
+    VkFormat format;
+    uint32_t width;
+    uint32_t height;
+    // Level 0 is the full resolution image.
+    std::vector<std::span<const uint8_t>> levels;
+};
+
+bool is_ktx2(const std::span<const uint8_t> &encoded);
+
+// The returned levels point into the encoded bytes.
+KTX2Image read_ktx2(const std::span<const uint8_t> &encoded);
+
+// Supports the formats produced by the texture encoder: BC1 RGB, BC7 and
+// RGBA8, all sRGB.
+std::vector<uint8_t> write_ktx2(const KTX2Image &image);
@@ -0,0 +1,74 @@
+#include "./mapped_file.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <stdexcept>
+#include <string>
+
+#if defined(_WIN32)
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#if defined(_WIN32)
+MappedFile::MappedFile(const std::filesystem::path &path) {
+    file = CreateFileW(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+                       OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE) {
+        throw std::runtime_error("Failed to open " + path.string());
+    };
+    LARGE_INTEGER fileSize;
+    GetFileSizeEx(file, &fileSize);
+    size = static_cast<std::size_t>(fileSize.QuadPart);
+    if (size == 0) return;
+    mapping = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (mapping != nullptr) {
+        data = static_cast<const uint8_t *>(
+            MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+    };
+    if (data == nullptr) {
+        if (mapping != nullptr) CloseHandle(mapping);
+        CloseHandle(file);
+        throw std::runtime_error("Failed to map " + path.string());
+    };
+};
+
+MappedFile::~MappedFile() {
+    if (data != nullptr) UnmapViewOfFile(data);
+    if (mapping != nullptr) CloseHandle(mapping);
+    CloseHandle(file);
+};
+#else
+MappedFile::MappedFile(const std::filesystem::path &path) {
+    const int descriptor = open(path.c_str(), O_RDONLY);
+    if (descriptor < 0) {
+        throw std::runtime_error("Failed to open " + path.string());
+    };
+    struct stat status;
+    if (fstat(descriptor, &status) != 0) {
+        close(descriptor);
+        throw std::runtime_error("Failed to stat " + path.string());
+    };
+    size = static_cast<std::size_t>(status.st_size);
+    if (size > 0) {
+        void *mapped =
+            mmap(nullptr, size, PROT_READ, MAP_PRIVATE, descriptor, 0);
+        if (mapped == MAP_FAILED) {
+            close(descriptor);
+            throw std::runtime_error("Failed to map " + path.string());
+        };
+        data = static_cast<const uint8_t *>(mapped);
+    };
+    // The mapping keeps its own reference to the file.
+    close(descriptor);
+};
+
+MappedFile::~MappedFile() {
+    if (data != nullptr) munmap(const_cast<uint8_t *>(data), size);
+};
+#endif
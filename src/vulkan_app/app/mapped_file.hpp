@@ -0,0 +1,24 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <span>
+
+// Read-only memory mapping of a whole file; pages are loaded on demand.
+class MappedFile {
+    const uint8_t *data = nullptr;
+    std::size_t size = 0;
+#if defined(_WIN32)
+    void *file = nullptr;
+    void *mapping = nullptr;
+#endif
+
+public:
+    explicit MappedFile(const std::filesystem::path &path);
+    MappedFile(const MappedFile &other) = delete;
+    MappedFile &operator=(const MappedFile &other) = delete;
+    ~MappedFile();
+
+    inline std::span<const uint8_t> getBytes() const { return { data, size }; };
+};
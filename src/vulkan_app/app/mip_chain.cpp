@@ -0,0 +1,76 @@
+#include "./mip_chain.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+namespace {
+float toLinear(const float &value) {
+    return value <= 0.04045f ? value / 12.92f
+                             : std::pow((value + 0.055f) / 1.055f, 2.4f);
+};
+
+const std::array<float, 256> linearTable = []() {
+    std::array<float, 256> table;
+    for (std::size_t i = 0; i < table.size(); i++) {
+        table[i] = toLinear(i / 255.0f);
+    };
+    return table;
+}();
+
+uint8_t toSRGB(const float &value) {
+    const float encoded = value <= 0.0031308f
+                              ? value * 12.92f
+                              : 1.055f * std::pow(value, 1.0f / 2.4f) - 0.055f;
+    return static_cast<uint8_t>(
+        std::clamp(std::lround(encoded * 255.0f), 0l, 255l));
+};
+
+MipLevel downsample(const MipLevel &source) {
+    MipLevel level = { .width = std::max(source.width / 2, 1u),
+                       .height = std::max(source.height / 2, 1u) };
+    level.rgba.resize(static_cast<std::size_t>(level.width) * level.height * 4);
+    for (uint32_t y = 0; y < level.height; y++) {
+        for (uint32_t x = 0; x < level.width; x++) {
+            std::array<float, 4> sum = {};
+            for (uint32_t dy = 0; dy < 2; dy++) {
+                for (uint32_t dx = 0; dx < 2; dx++) {
+                    const uint32_t sourceX =
+                        std::min(x * 2 + dx, source.width - 1);
+                    const uint32_t sourceY =
+                        std::min(y * 2 + dy, source.height - 1);
+                    const auto *pixel =
+                        source.rgba.data() +
+                        (static_cast<std::size_t>(sourceY) * source.width +
+                         sourceX) * 4;
+                    for (unsigned int c = 0; c < 3; c++) {
+                        sum[c] += linearTable[pixel[c]];
+                    };
+                    sum[3] += pixel[3];
+                };
+            };
+            auto *pixel = level.rgba.data() +
+                          (static_cast<std::size_t>(y) * level.width + x) * 4;
+            for (unsigned int c = 0; c < 3; c++) pixel[c] = toSRGB(sum[c] / 4);
+            pixel[3] = static_cast<uint8_t>(std::lround(sum[3] / 4));
+        };
+    };
+    return level;
+};
+};  // namespace
+
+std::vector<MipLevel> generate_mip_chain(std::vector<uint8_t> &&rgba,
+                                         const uint32_t &width,
+                                         const uint32_t &height) {
+    std::vector<MipLevel> levels;
+    levels.push_back(
+        { .width = width, .height = height, .rgba = std::move(rgba) });
+    while (levels.back().width > 1 || levels.back().height > 1) {
+        levels.push_back(downsample(levels.back()));
+    };
+    return levels;
+};
@@ -0,0 +1,17 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+struct MipLevel {
+    uint32_t width;
+    uint32_t height;
+    std::vector<uint8_t> rgba;
+};
+
+// Builds the full chain down to 1x1 from tightly packed sRGB RGBA pixels.
+// Each level box-filters the previous one, color in linear space and alpha
+// as is.
+std::vector<MipLevel> generate_mip_chain(std::vector<uint8_t> &&rgba,
+                                         const uint32_t &width,
+                                         const uint32_t &height);
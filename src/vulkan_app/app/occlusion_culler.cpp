@@ -0,0 +1,262 @@
+#include "./occlusion_culler.hpp"
+
+#include <vulkan/vulkan_core.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <format>
+#include <iterator>
+#include <span>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include "shaders.hpp"
+#include "vulkan_app/app/create_buffers.hpp"
+#include "vulkan_app/app/create_pipeline.hpp"
+#include "vulkan_app/app/data_aggregator.hpp"
+#include "vulkan_app/app/depth_pyramid.hpp"
+#include "vulkan_app/app/descriptor_allocator.hpp"
+#include "vulkan_app/app/descriptor_layout_cache.hpp"
+#include "vulkan_app/app/spirv_reflection.hpp"
+#include "vulkan_app/vki/buffer.hpp"
+#include "vulkan_app/vki/command_buffer.hpp"
+#include "vulkan_app/vki/compute_pipeline.hpp"
+#include "vulkan_app/vki/logical_device.hpp"
+#include "vulkan_app/vki/pipeline_cache.hpp"
+#include "vulkan_app/vki/pipeline_layout.hpp"
+
+namespace {
+constexpr uint32_t groupSize = 64;
+
+// Matches the step constants in cull.comp.
+enum class CullStep : uint32_t {
+    TEST,
+    SCAN,
+    SCATTER,
+};
+
+// Makes one step's results readable by the next.
+constexpr VkMemoryBarrier2 stepBarrier = {
+    .sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER_2,
+    .srcStageMask = VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT,
+    .srcAccessMask = VK_ACCESS_2_SHADER_WRITE_BIT,
+    .dstStageMask = VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT,
+    .dstAccessMask =
+        VK_ACCESS_2_SHADER_READ_BIT | VK_ACCESS_2_SHADER_WRITE_BIT,
+};
+
+// Makes a phase's commands and count readable by the draws, and keeps the
+// next phase from overwriting the slots before they are scattered.
+constexpr VkMemoryBarrier2 drawBarrier = {
+    .sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER_2,
+    .srcStageMask = VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT,
+    .srcAccessMask = VK_ACCESS_2_SHADER_WRITE_BIT,
+    .dstStageMask = VK_PIPELINE_STAGE_2_DRAW_INDIRECT_BIT |
+                    VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT,
+    .dstAccessMask = VK_ACCESS_2_INDIRECT_COMMAND_READ_BIT,
+};
+};  // namespace
+
+OcclusionCuller::MappedBuffer OcclusionCuller::createMapped(
+    const vki::LogicalDevice &logicalDevice,
+    const VkPhysicalDeviceMemoryProperties &memoryProperties,
+    const std::size_t &size) {
+    auto [buffer, mapped] =
+        createMappedBuffer(logicalDevice, memoryProperties, size,
+                           VK_BUFFER_USAGE_STORAGE_BUFFER_BIT);
+    return { .buffer = std::move(buffer), .mapped = mapped };
+};
+
+OcclusionCuller::OcclusionCuller(
+    const vki::LogicalDevice &logicalDevice,
+    const VkPhysicalDeviceMemoryProperties &memoryProperties,
+    DescriptorLayoutCache &descriptorLayouts,
+    const vki::PipelineCache &pipelineCache, const DepthPyramid &depthPyramid,
+    const uint32_t &capacity)
+    : capacity{ capacity },
+      candidates{ createMapped(logicalDevice, memoryProperties,
+                               sizeof(uint32_t) * capacity) },
+      shapes{ createMapped(logicalDevice, memoryProperties,
+                           sizeof(CullShape) * capacity) },
+      visibility{ createDeviceLocalBuffer(
+          logicalDevice, memoryProperties, sizeof(uint32_t) * capacity,
+          VK_BUFFER_USAGE_STORAGE_BUFFER_BIT |
+              VK_BUFFER_USAGE_TRANSFER_DST_BIT) },
+      draws{ createDeviceLocalBuffer(
+          logicalDevice, memoryProperties,
+          sizeof(VkDrawIndexedIndirectCommand) * capacity * 2,
+          VK_BUFFER_USAGE_STORAGE_BUFFER_BIT |
+              VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT) },
+      drawCounts{ createDeviceLocalBuffer(
+          logicalDevice, memoryProperties, sizeof(uint32_t) * 2,
+          VK_BUFFER_USAGE_STORAGE_BUFFER_BIT |
+              VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT) },
+      slots{ createDeviceLocalBuffer(logicalDevice, memoryProperties,
+                                     sizeof(uint32_t) * capacity,
+                                     VK_BUFFER_USAGE_STORAGE_BUFFER_BIT) },
+      groupCounts{ createDeviceLocalBuffer(
+          logicalDevice, memoryProperties,
+          sizeof(uint32_t) * ((capacity + groupSize - 1) / groupSize),
+          VK_BUFFER_USAGE_STORAGE_BUFFER_BIT) },
+      layoutDescription{ describePipelineLayout(
+          { reflect_spirv(cullCompShaderCode.words()) }, 0) },
+      pipelineLayout{ descriptorLayouts.getPipelineLayout(layoutDescription) },
+      descriptorAllocator{
+          logicalDevice, layoutDescription.sets.at(0),
+          descriptorLayouts.getSetLayout(layoutDescription.sets.at(0)), 1 },
+      descriptorSet{ descriptorAllocator.allocate() },
+      pipeline{ createComputePipeline(logicalDevice, cullCompShaderCode.name,
+                                      pipelineLayout, pipelineCache) } {
+    const VkDescriptorBufferInfo bufferInfos[] = {
+        { .buffer = candidates.buffer.getVkBuffer(),
+          .offset = 0,
+          .range = VK_WHOLE_SIZE },
+        { .buffer = shapes.buffer.getVkBuffer(),
+          .offset = 0,
+          .range = VK_WHOLE_SIZE },
+        { .buffer = visibility.getVkBuffer(),
+          .offset = 0,
+          .range = VK_WHOLE_SIZE },
+        { .buffer = draws.getVkBuffer(), .offset = 0, .range = VK_WHOLE_SIZE },
+        { .buffer = drawCounts.getVkBuffer(),
+          .offset = 0,
+          .range = VK_WHOLE_SIZE },
+        { .buffer = slots.getVkBuffer(), .offset = 0, .range = VK_WHOLE_SIZE },
+        { .buffer = groupCounts.getVkBuffer(),
+          .offset = 0,
+          .range = VK_WHOLE_SIZE },
+    };
+    std::vector<VkWriteDescriptorSet> writes;
+    for (uint32_t binding = 0; binding < std::size(bufferInfos); binding++) {
+        writes.push_back({
+            .sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET,
+            .dstSet = descriptorSet,
+            .dstBinding = binding,
+            .dstArrayElement = 0,
+            .descriptorCount = 1,
+            .descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER,
+            .pBufferInfo = &bufferInfos[binding],
+        });
+    };
+    const VkDescriptorImageInfo pyramidInfo = {
+        .imageView = depthPyramid.getImageView().getVkImageView(),
+        .imageLayout = VK_IMAGE_LAYOUT_GENERAL,
+    };
+    writes.push_back({
+        .sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET,
+        .dstSet = descriptorSet,
+        .dstBinding = static_cast<uint32_t>(std::size(bufferInfos)),
+        .dstArrayElement = 0,
+        .descriptorCount = 1,
+        .descriptorType = VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE,
+        .pImageInfo = &pyramidInfo,
+    });
+    logicalDevice.updateWriteDescriptorSets(writes);
+};
+
+void OcclusionCuller::update(const DataAggregator &aggregator,
+                             const std::span<const uint32_t> &visibleShapes,
+                             const glm::mat4 &newViewProjection) {
+    if (visibleShapes.size() > capacity) {
+        throw std::invalid_argument(
+            std::format("{} shapes to cull, room for {}",
+                        visibleShapes.size(), capacity));
+    };
+    std::memcpy(candidates.mapped, visibleShapes.data(),
+                visibleShapes.size_bytes());
+    // Only the candidates' entries are read, so the others may be stale.
+    auto *shapeEntries = static_cast<CullShape *>(shapes.mapped);
+    for (const auto &shapeIndex : visibleShapes) {
+        const auto &shape = aggregator.shapes[shapeIndex];
+        const auto &sphere = aggregator.shapeBounds.getSphere(shapeIndex);
+        shapeEntries[shapeIndex] = {
+            .sphere = glm::vec4(sphere.center, sphere.radius),
+            .indexCount = shape.indexCount,
+            .firstIndex = shape.indexOffset,
+            .vertexOffset = static_cast<int32_t>(shape.vertexOffset),
+        };
+    };
+    candidateCount = static_cast<uint32_t>(visibleShapes.size());
+    viewProjection = newViewProjection;
+};
+
+void OcclusionCuller::dispatch(const vki::CommandBuffer &commandBuffer,
+                               const CullPhase &phase) const {
+    commandBuffer.bindPipeline(pipeline);
+    commandBuffer.bindDescriptorSet({
+        .bindPointType = vki::PipelineBindPointType::COMPUTE,
+        .pipelineLayout = pipelineLayout,
+        .firstSet = 0,
+        .descriptorSets = { descriptorSet },
+        .dynamicOffsets = {},
+    });
+    const uint32_t groupCount = (candidateCount + groupSize - 1) / groupSize;
+    for (const auto &step :
+         { CullStep::TEST, CullStep::SCAN, CullStep::SCATTER }) {
+        if (step != CullStep::TEST) {
+            commandBuffer.memoryBarrier(stepBarrier);
+        };
+        const CullConstants constants = {
+            .viewProjection = viewProjection,
+            .candidateCount = candidateCount,
+            .drawCapacity = capacity,
+            .isLate = static_cast<uint32_t>(phase),
+            .step = static_cast<uint32_t>(step),
+        };
+        commandBuffer.pushConstants(pipelineLayout, CullConstants::stageFlags,
+                                    0,
+                                    std::as_bytes(std::span(&constants, 1)));
+        // The scan covers every workgroup's count at once.
+        commandBuffer.dispatch(step == CullStep::SCAN ? 1 : groupCount, 1, 1);
+    };
+    commandBuffer.memoryBarrier(drawBarrier);
+};
+
+void OcclusionCuller::recordEarly(const vki::CommandBuffer &commandBuffer) {
+    // The last frame's draws and culling are done with the buffers.
+    commandBuffer.memoryBarrier({
+        .sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER_2,
+        .srcStageMask = VK_PIPELINE_STAGE_2_DRAW_INDIRECT_BIT |
+                        VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT,
+        .srcAccessMask = VK_ACCESS_2_SHADER_WRITE_BIT,
+        .dstStageMask = VK_PIPELINE_STAGE_2_TRANSFER_BIT |
+                        VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT,
+        .dstAccessMask = VK_ACCESS_2_TRANSFER_WRITE_BIT |
+                         VK_ACCESS_2_SHADER_READ_BIT |
+                         VK_ACCESS_2_SHADER_WRITE_BIT,
+    });
+    // Nothing is drawn early on the first frame, so its late phase draws
+    // everything it finds unoccluded.
+    if (!isVisibilityCleared) {
+        commandBuffer.fillBuffer(visibility, 0, VK_WHOLE_SIZE, 0);
+        commandBuffer.memoryBarrier({
+            .sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER_2,
+            .srcStageMask = VK_PIPELINE_STAGE_2_TRANSFER_BIT,
+            .srcAccessMask = VK_ACCESS_2_TRANSFER_WRITE_BIT,
+            .dstStageMask = VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT,
+            .dstAccessMask =
+                VK_ACCESS_2_SHADER_READ_BIT | VK_ACCESS_2_SHADER_WRITE_BIT,
+        });
+        isVisibilityCleared = true;
+    };
+    dispatch(commandBuffer, CullPhase::EARLY);
+};
+
+void OcclusionCuller::recordLate(
+    const vki::CommandBuffer &commandBuffer) const {
+    dispatch(commandBuffer, CullPhase::LATE);
+};
+
+void OcclusionCuller::draw(const vki::CommandBuffer &commandBuffer,
+                           const CullPhase &phase) const {
+    const auto &index = static_cast<uint32_t>(phase);
+    commandBuffer.drawIndexedIndirectCount({
+        .buffer = draws,
+        .offset = sizeof(VkDrawIndexedIndirectCommand) * capacity * index,
+        .countBuffer = drawCounts,
+        .countBufferOffset = sizeof(uint32_t) * index,
+        .maxDrawCount = capacity,
+    });
+};
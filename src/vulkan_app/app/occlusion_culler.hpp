@@ -0,0 +1,113 @@
+#pragma once
+
+#include <vulkan/vulkan_core.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+
+#include "glm/mat4x4.hpp"
+#include "glm/vec4.hpp"
+#include "vulkan_app/app/data_aggregator.hpp"
+#include "vulkan_app/app/depth_pyramid.hpp"
+#include "vulkan_app/app/descriptor_allocator.hpp"
+#include "vulkan_app/app/descriptor_layout_cache.hpp"
+#include "vulkan_app/vki/buffer.hpp"
+#include "vulkan_app/vki/command_buffer.hpp"
+#include "vulkan_app/vki/compute_pipeline.hpp"
+#include "vulkan_app/vki/logical_device.hpp"
+#include "vulkan_app/vki/pipeline_cache.hpp"
+#include "vulkan_app/vki/pipeline_layout.hpp"
+
+enum class CullPhase : uint32_t {
+    // Draws what was visible last frame, untested.
+    EARLY,
+    // Tests everything against the early phase's depth and draws what it
+    // missed.
+    LATE,
+};
+
+// Matches the push_constant block in cull.comp.
+struct CullConstants {
+    glm::mat4 viewProjection;
+    uint32_t candidateCount;
+    uint32_t drawCapacity;
+    uint32_t isLate;
+    uint32_t step;
+
+    static constexpr VkShaderStageFlags stageFlags =
+        VK_SHADER_STAGE_COMPUTE_BIT;
+};
+
+// Matches Shape in cull.comp.
+struct CullShape {
+    glm::vec4 sphere;
+    uint32_t indexCount;
+    uint32_t firstIndex;
+    int32_t vertexOffset;
+    uint32_t padding;
+};
+
+// Two-phase occlusion culling of the shapes that pass the frustum test,
+// writing indirect draws whose counts stay on the device. Each phase packs
+// the commands of the shapes it draws in candidate order, so culled shapes
+// cost the draws nothing. Which shapes
+// were visible is kept on the device from one frame's late phase to the
+// next frame's early phase. The host writes the candidates after the
+// previous frame's fence, so the buffers it writes are not duplicated.
+class OcclusionCuller {
+    struct MappedBuffer {
+        vki::Buffer buffer;
+        void *mapped;
+    };
+
+    uint32_t capacity;
+    MappedBuffer candidates;
+    MappedBuffer shapes;
+    vki::Buffer visibility;
+    vki::Buffer draws;
+    vki::Buffer drawCounts;
+    vki::Buffer slots;
+    vki::Buffer groupCounts;
+    PipelineLayoutDescription layoutDescription;
+    const vki::PipelineLayout &pipelineLayout;
+    DescriptorAllocator descriptorAllocator;
+    VkDescriptorSet descriptorSet;
+    vki::ComputePipeline pipeline;
+    uint32_t candidateCount = 0;
+    glm::mat4 viewProjection;
+    bool isVisibilityCleared = false;
+
+    static MappedBuffer createMapped(
+        const vki::LogicalDevice &logicalDevice,
+        const VkPhysicalDeviceMemoryProperties &memoryProperties,
+        const std::size_t &size);
+    void dispatch(const vki::CommandBuffer &commandBuffer,
+                  const CullPhase &phase) const;
+
+public:
+    // capacity is the number of shapes in the aggregator.
+    explicit OcclusionCuller(
+        const vki::LogicalDevice &logicalDevice,
+        const VkPhysicalDeviceMemoryProperties &memoryProperties,
+        DescriptorLayoutCache &descriptorLayouts,
+        const vki::PipelineCache &pipelineCache,
+        const DepthPyramid &depthPyramid, const uint32_t &capacity);
+    OcclusionCuller(const OcclusionCuller &other) = delete;
+    OcclusionCuller &operator=(const OcclusionCuller &other) = delete;
+
+    // Sets the shapes the next recorded frame tests, in the order their
+    // draws are recorded. Must be called once the previous frame has
+    // finished.
+    void update(const DataAggregator &aggregator,
+                const std::span<const uint32_t> &visibleShapes,
+                const glm::mat4 &viewProjection);
+    // Records the early phase before the frame's passes.
+    void recordEarly(const vki::CommandBuffer &commandBuffer);
+    // Records the late phase once the depth pyramid has been built.
+    void recordLate(const vki::CommandBuffer &commandBuffer) const;
+    // Records the phase's draws into rendering with the scene pipeline,
+    // vertex and index buffers bound.
+    void draw(const vki::CommandBuffer &commandBuffer,
+              const CullPhase &phase) const;
+};
@@ -0,0 +1,62 @@
+#include "./picking.hpp"
+
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <optional>
+
+#include "glm/ext/vector_float3.hpp"
+#include "glm/geometric.hpp"
+#include "vulkan_app/app/bounds.hpp"
+#include "vulkan_app/app/bvh.hpp"
+#include "vulkan_app/app/data_aggregator.hpp"
+
+namespace {
+std::optional<float> intersectTriangle(const Ray &ray, const glm::vec3 &a,
+                                       const glm::vec3 &b,
+                                       const glm::vec3 &c) {
+    constexpr float epsilon = 1e-7f;
+    const auto &edge1 = b - a;
+    const auto &edge2 = c - a;
+    const auto &p = glm::cross(ray.direction, edge2);
+    const float determinant = glm::dot(edge1, p);
+    if (std::fabs(determinant) < epsilon) return std::nullopt;
+    const float invDeterminant = 1.0f / determinant;
+    const auto &s = ray.origin - a;
+    const float u = glm::dot(s, p) * invDeterminant;
+    if (u < 0.0f || u > 1.0f) return std::nullopt;
+    const auto &q = glm::cross(s, edge1);
+    const float v = glm::dot(ray.direction, q) * invDeterminant;
+    if (v < 0.0f || u + v > 1.0f) return std::nullopt;
+    const float t = glm::dot(edge2, q) * invDeterminant;
+    if (t < 0.0f) return std::nullopt;
+    return t;
+};
+};  // namespace
+
+std::optional<float> intersectShape(const DataAggregator &aggregator,
+                                    const ShapeData &shape, const Ray &ray) {
+    std::optional<float> closest;
+    for (uint32_t i = 0; i + 2 < shape.indexCount; i += 3) {
+        const auto &vertex = [&aggregator, &shape, i](const uint32_t &corner) {
+            const auto &index =
+                aggregator.indexArray[shape.indexOffset + i + corner];
+            return aggregator.vertexArray[shape.vertexOffset + index].pos;
+        };
+        const auto &t = intersectTriangle(ray, vertex(0), vertex(1), vertex(2));
+        if (t.has_value() && (!closest.has_value() || t < closest)) {
+            closest = t;
+        };
+    };
+    return closest;
+};
+
+std::optional<BVHRayHit> pickShape(const BVH &bvh,
+                                   const DataAggregator &aggregator,
+                                   const Ray &ray) {
+    return bvh.intersectRay(
+        ray, [&aggregator, &ray](const uint32_t &shapeIndex) {
+            return intersectShape(aggregator, aggregator.shapes[shapeIndex],
+                                  ray);
+        });
+};
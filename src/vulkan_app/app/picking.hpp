@@ -0,0 +1,15 @@
+#pragma once
+
+#include <cstdint>
+#include <optional>
+
+#include "vulkan_app/app/bounds.hpp"
+#include "vulkan_app/app/bvh.hpp"
+#include "vulkan_app/app/data_aggregator.hpp"
+
+std::optional<float> intersectShape(const DataAggregator &aggregator,
+                                    const ShapeData &shape, const Ray &ray);
+
+std::optional<BVHRayHit> pickShape(const BVH &bvh,
+                                   const DataAggregator &aggregator,
+                                   const Ray &ray);
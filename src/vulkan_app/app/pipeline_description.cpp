@@ -0,0 +1,27 @@
+#include "./pipeline_description.hpp"
+
+#include <cstdint>
+
+#include "vulkan_app/app/fnv1a.hpp"
+
+uint64_t PipelineDescription::hash() const {
+    uint64_t hash = fnv1a(fnvOffsetBasis, vertexShader);
+    // Separates the names, so moving characters between them changes the
+    // hash.
+    hash = fnv1aValue(hash, static_cast<uint64_t>(vertexShader.size()));
+    hash = fnv1a(hash, fragmentShader);
+    hash = fnv1aValue(hash, static_cast<uint64_t>(fragmentShader.size()));
+    hash = fnv1aValue(hash, hasVertexInput);
+    hash = fnv1aValue(hash, colorAttachmentFormat);
+    hash = fnv1aValue(hash, depthAttachmentFormat);
+    hash = fnv1aValue(hash, topology);
+    hash = fnv1aValue(hash, polygonMode);
+    hash = fnv1aValue(hash, frontFace);
+    hash = fnv1aValue(hash, sampleCount);
+    hash = fnv1aValue(hash, minSampleShading);
+    hash = fnv1aValue(hash, isBlendEnabled);
+    hash = fnv1aValue(hash, depthCompareOp);
+    hash = fnv1aValue(hash, specialization.isTextureSampled);
+    hash = fnv1aValue(hash, specialization.colorSource);
+    return hash;
+};
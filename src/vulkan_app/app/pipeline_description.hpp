@@ -0,0 +1,83 @@
+#pragma once
+
+#include <vulkan/vulkan_core.h>
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+#include "shaders.hpp"
+
+enum class VertexColorSource : uint32_t {
+    VERTEX = 0,
+    WHITE = 1,
+};
+
+// Values for the shaders' specialization constants. Every combination is
+// its own pipeline, compiled from the same SPIR-V modules.
+struct ShaderSpecialization {
+    // constant_id 0 in shader.frag.
+    VkBool32 isTextureSampled = VK_TRUE;
+    // constant_id 1 in shader.vert.
+    VertexColorSource colorSource = VertexColorSource::VERTEX;
+
+    bool operator==(const ShaderSpecialization &other) const = default;
+
+    // Both stages get all entries; ids a module does not declare are
+    // ignored.
+    static std::array<VkSpecializationMapEntry, 2> getMapEntries() {
+        return {
+            (VkSpecializationMapEntry){
+                .constantID = 0,
+                .offset = offsetof(ShaderSpecialization, isTextureSampled),
+                .size = sizeof(VkBool32) },
+            (VkSpecializationMapEntry){
+                .constantID = 1,
+                .offset = offsetof(ShaderSpecialization, colorSource),
+                .size = sizeof(VertexColorSource) },
+        };
+    };
+};
+
+// Everything baked into a graphics pipeline. Viewport, scissor, cull mode
+// and depth test and write are dynamic state (see DynamicRenderState), so
+// changing them never needs another pipeline.
+struct PipelineDescription {
+    // Names of SPIR-V modules in the embedded resource registry.
+    std::string_view vertexShader = vertShaderCode.name;
+    std::string_view fragmentShader = fragShaderCode.name;
+    // False for vertex shaders that generate their own vertices.
+    bool hasVertexInput = true;
+    // Of the attachments the pipeline renders into.
+    VkFormat colorAttachmentFormat = VK_FORMAT_UNDEFINED;
+    VkFormat depthAttachmentFormat = VK_FORMAT_UNDEFINED;
+    VkPrimitiveTopology topology = VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST;
+    VkPolygonMode polygonMode = VK_POLYGON_MODE_FILL;
+    VkFrontFace frontFace = VK_FRONT_FACE_COUNTER_CLOCKWISE;
+    VkSampleCountFlagBits sampleCount = VK_SAMPLE_COUNT_1_BIT;
+    float minSampleShading = 0.0f;
+    bool isBlendEnabled = false;
+    VkCompareOp depthCompareOp = VK_COMPARE_OP_LESS;
+    ShaderSpecialization specialization = {};
+
+    bool operator==(const PipelineDescription &other) const = default;
+
+    // Stable across runs, so it can also key data persisted on disk.
+    uint64_t hash() const;
+};
+
+struct PipelineDescriptionHash {
+    inline std::size_t operator()(
+        const PipelineDescription &description) const {
+        return static_cast<std::size_t>(description.hash());
+    };
+};
+
+struct DynamicRenderState {
+    VkViewport viewport;
+    VkRect2D scissor;
+    VkCullModeFlags cullMode = VK_CULL_MODE_NONE;
+    bool isDepthTestEnabled = true;
+    bool isDepthWriteEnabled = true;
+};
@@ -0,0 +1,109 @@
+#include "./pipeline_variants.hpp"
+
+#include <vulkan/vulkan_core.h>
+
+#include <chrono>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "vulkan_app/app/create_pipeline.hpp"
+#include "vulkan_app/app/pipeline_description.hpp"
+#include "vulkan_app/vki/graphics_pipeline.hpp"
+#include "vulkan_app/vki/pipeline_cache.hpp"
+
+PipelineVariants::PipelineVariants(const vki::LogicalDevice &logicalDevice,
+                                   const vki::PhysicalDevice &physicalDevice,
+                                   const vki::PipelineLayout &pipelineLayout,
+                                   vki::PipelineCache &pipelineCache,
+                                   const unsigned int &threadCount)
+    : logicalDevice{ logicalDevice },
+      physicalDevice{ physicalDevice },
+      pipelineLayout{ pipelineLayout },
+      pipelineCache{ pipelineCache },
+      workers(threadCount) {};
+
+vki::PipelineCache &PipelineVariants::acquireCache() {
+    std::lock_guard lock(mutex);
+    if (!idleCaches.empty()) {
+        auto &cache = *idleCaches.back();
+        idleCaches.pop_back();
+        return cache;
+    };
+    // Nothing has been merged back yet, so the shared data is only read.
+    workerCaches.push_back(std::make_unique<vki::PipelineCache>(
+        logicalDevice, physicalDevice, pipelineCache.getData()));
+    return *workerCaches.back();
+};
+
+void PipelineVariants::releaseCache(vki::PipelineCache &cache) {
+    std::lock_guard lock(mutex);
+    idleCaches.push_back(&cache);
+};
+
+const vki::GraphicsPipeline *PipelineVariants::compile(
+    const PipelineDescription &description) {
+    auto &cache = acquireCache();
+    std::unique_ptr<vki::GraphicsPipeline> pipeline;
+    try {
+        pipeline = std::make_unique<vki::GraphicsPipeline>(
+            createGraphicsPipeline(logicalDevice, description, pipelineLayout,
+                                   cache));
+    } catch (...) {
+        releaseCache(cache);
+        throw;
+    };
+    releaseCache(cache);
+    std::lock_guard lock(mutex);
+    // Map nodes never move, so the variant outlives this task.
+    auto &variant = variants.at(description);
+    variant.pipeline = std::move(pipeline);
+    return variant.pipeline.get();
+};
+
+std::shared_future<const vki::GraphicsPipeline *> PipelineVariants::request(
+    const PipelineDescription &description) {
+    std::lock_guard lock(mutex);
+    auto &variant = variants[description];
+    if (!variant.ready.valid()) {
+        variant.ready = workers
+                            .submit([this, description]() {
+                                return compile(description);
+                            })
+                            .share();
+    };
+    return variant.ready;
+};
+
+const vki::GraphicsPipeline *PipelineVariants::tryGet(
+    const PipelineDescription &description) {
+    const auto &ready = request(description);
+    if (ready.wait_for(std::chrono::seconds(0)) !=
+        std::future_status::ready) {
+        return nullptr;
+    };
+    return ready.get();
+};
+
+const vki::GraphicsPipeline &PipelineVariants::get(
+    const PipelineDescription &description) {
+    return *request(description).get();
+};
+
+void PipelineVariants::mergeCaches() {
+    std::vector<std::shared_future<const vki::GraphicsPipeline *>> pending;
+    {
+        std::lock_guard lock(mutex);
+        for (const auto &[description, variant] : variants) {
+            pending.push_back(variant.ready);
+        };
+    };
+    for (const auto &ready : pending) ready.wait();
+    std::lock_guard lock(mutex);
+    std::vector<VkPipelineCache> sources;
+    for (const auto &cache : workerCaches) {
+        sources.push_back(cache->getVkPipelineCache());
+    };
+    pipelineCache.merge(sources);
+};
@@ -0,0 +1,71 @@
+#pragma once
+
+#include <cstddef>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+#include "vulkan_app/app/pipeline_description.hpp"
+#include "vulkan_app/app/thread_pool.hpp"
+#include "vulkan_app/vki/graphics_pipeline.hpp"
+#include "vulkan_app/vki/logical_device.hpp"
+#include "vulkan_app/vki/physical_device.hpp"
+#include "vulkan_app/vki/pipeline_cache.hpp"
+#include "vulkan_app/vki/pipeline_layout.hpp"
+
+// Compiles each distinct PipelineDescription once, on a worker pool, and
+// hands out the same pipeline for every later request with an identical
+// description. Each compile borrows a worker-local pipeline cache seeded
+// from the shared one, so workers never contend on a cache; mergeCaches
+// folds them back. The render loop polls with tryGet and draws with a
+// fallback until the pipeline it wants is ready.
+class PipelineVariants {
+    struct Variant {
+        std::shared_future<const vki::GraphicsPipeline *> ready;
+        std::unique_ptr<vki::GraphicsPipeline> pipeline;
+    };
+
+    const vki::LogicalDevice &logicalDevice;
+    const vki::PhysicalDevice &physicalDevice;
+    const vki::PipelineLayout &pipelineLayout;
+    vki::PipelineCache &pipelineCache;
+    std::mutex mutex;
+    std::unordered_map<PipelineDescription, Variant, PipelineDescriptionHash>
+        variants;
+    std::vector<std::unique_ptr<vki::PipelineCache>> workerCaches;
+    std::vector<vki::PipelineCache *> idleCaches;
+    // Declared last so the workers finish before anything they use is
+    // destroyed.
+    ThreadPool workers;
+
+    vki::PipelineCache &acquireCache();
+    void releaseCache(vki::PipelineCache &cache);
+    const vki::GraphicsPipeline *compile(
+        const PipelineDescription &description);
+
+public:
+    explicit PipelineVariants(
+        const vki::LogicalDevice &logicalDevice,
+        const vki::PhysicalDevice &physicalDevice,
+        const vki::PipelineLayout &pipelineLayout,
+        vki::PipelineCache &pipelineCache,
+        const unsigned int &threadCount = ThreadPool::defaultThreadCount());
+
+    // Starts compiling unless the description was requested before. The
+    // pipeline lives as long as the variants; compile errors are rethrown
+    // from the future.
+    std::shared_future<const vki::GraphicsPipeline *> request(
+        const PipelineDescription &description);
+    // Returns the pipeline if it has finished compiling, without blocking,
+    // and requests it otherwise.
+    const vki::GraphicsPipeline *tryGet(
+        const PipelineDescription &description);
+    // Blocks until the pipeline is ready.
+    const vki::GraphicsPipeline &get(const PipelineDescription &description);
+
+    // Waits for pending compiles and merges the worker caches into the
+    // shared pipeline cache.
+    void mergeCaches();
+};
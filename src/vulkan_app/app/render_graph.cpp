@@ -0,0 +1,547 @@
+#include "./render_graph.hpp"
+
+#include <vulkan/vulkan_core.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <cstddef>
+#include <format>
+#include <memory>
+#include <optional>
+#include <stdexcept>
+#include <vector>
+
+#include "vulkan_app/app/frame_arena.hpp"
+#include "vulkan_app/vki/command_buffer.hpp"
+#include "vulkan_app/vki/image.hpp"
+#include "vulkan_app/vki/image_view.hpp"
+#include "vulkan_app/vki/logical_device.hpp"
+#include "vulkan_app/vki/memory.hpp"
+#include "vulkan_app/vki/utils.hpp"
+
+namespace {
+constexpr VkAccessFlags2 writeAccessMask =
+    VK_ACCESS_2_COLOR_ATTACHMENT_WRITE_BIT |
+    VK_ACCESS_2_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT |
+    VK_ACCESS_2_SHADER_WRITE_BIT | VK_ACCESS_2_TRANSFER_WRITE_BIT |
+    VK_ACCESS_2_MEMORY_WRITE_BIT;
+
+ImageState getAccessState(const ImageAccess &access) {
+    switch (access) {
+        case ImageAccess::COLOR_ATTACHMENT:
+            return { .stageMask =
+                         VK_PIPELINE_STAGE_2_COLOR_ATTACHMENT_OUTPUT_BIT,
+                     .accessMask = VK_ACCESS_2_COLOR_ATTACHMENT_READ_BIT |
+                                   VK_ACCESS_2_COLOR_ATTACHMENT_WRITE_BIT,
+                     .layout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL };
+        case ImageAccess::DEPTH_ATTACHMENT:
+            return {
+                .stageMask = VK_PIPELINE_STAGE_2_EARLY_FRAGMENT_TESTS_BIT |
+                             VK_PIPELINE_STAGE_2_LATE_FRAGMENT_TESTS_BIT,
+                .accessMask = VK_ACCESS_2_DEPTH_STENCIL_ATTACHMENT_READ_BIT |
+                              VK_ACCESS_2_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT,
+                .layout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL
+            };
+        case ImageAccess::RESOLVE_ATTACHMENT:
+            return { .stageMask =
+                         VK_PIPELINE_STAGE_2_COLOR_ATTACHMENT_OUTPUT_BIT,
+                     .accessMask = VK_ACCESS_2_COLOR_ATTACHMENT_WRITE_BIT,
+                     .layout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL };
+        case ImageAccess::SAMPLED:
+            return { .stageMask = VK_PIPELINE_STAGE_2_FRAGMENT_SHADER_BIT,
+                     .accessMask = VK_ACCESS_2_SHADER_SAMPLED_READ_BIT,
+                     .layout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL };
+        case ImageAccess::COMPUTE_SAMPLED:
+            return { .stageMask = VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT,
+                     .accessMask = VK_ACCESS_2_SHADER_SAMPLED_READ_BIT,
+                     .layout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL };
+    };
+    throw std::invalid_argument("Unknown image access");
+};
+
+VkImageUsageFlags getAccessUsage(const ImageAccess &access) {
+    switch (access) {
+        case ImageAccess::COLOR_ATTACHMENT:
+        case ImageAccess::RESOLVE_ATTACHMENT:
+            return VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT;
+        case ImageAccess::DEPTH_ATTACHMENT:
+            return VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT;
+        case ImageAccess::SAMPLED:
+        case ImageAccess::COMPUTE_SAMPLED:
+            return VK_IMAGE_USAGE_SAMPLED_BIT;
+    };
+    throw std::invalid_argument("Unknown image access");
+};
+
+// Layout transitions of depth formats with stencil cover both aspects.
+VkImageAspectFlags getBarrierAspectMask(
+    const TransientImageDescription &description) {
+    switch (description.format) {
+        case VK_FORMAT_D16_UNORM_S8_UINT:
+        case VK_FORMAT_D24_UNORM_S8_UINT:
+        case VK_FORMAT_D32_SFLOAT_S8_UINT:
+            return description.aspectMask | VK_IMAGE_ASPECT_STENCIL_BIT;
+        default:
+            return description.aspectMask;
+    };
+};
+
+bool isWrite(const ImageAccess &access) {
+    return access != ImageAccess::SAMPLED &&
+           access != ImageAccess::COMPUTE_SAMPLED;
+};
+
+// The source half of a barrier only needs to make writes available.
+ImageState withWritesOnly(const ImageState &state) {
+    return { .stageMask = state.stageMask,
+             .accessMask = state.accessMask & writeAccessMask,
+             .layout = state.layout };
+};
+
+struct Lifetime {
+    uint32_t firstPass;
+    uint32_t lastPass;
+
+    bool overlaps(const Lifetime &other) const {
+        return firstPass <= other.lastPass && other.firstPass <= lastPass;
+    };
+};
+
+struct MemoryBlock {
+    VkMemoryRequirements requirements;
+    // Of only transient attachments that fit lazily allocated memory.
+    bool isLazilyAllocated;
+    std::vector<uint32_t> images;
+};
+
+// Largest images first, each into the first block it fits with: one of
+// compatible memory types whose images are all used in other passes.
+// Images that can be lazily allocated are kept apart from others, which
+// would force their memory to be committed up front.
+std::vector<MemoryBlock> placeInMemoryBlocks(
+    const std::vector<uint32_t> &images,
+    const std::vector<VkMemoryRequirements> &requirements,
+    const std::vector<Lifetime> &lifetimes,
+    const std::vector<bool> &isLazilyAllocated) {
+    auto order = images;
+    std::ranges::stable_sort(order, std::ranges::greater{},
+                             [&requirements](const uint32_t &image) {
+                                 return requirements[image].size;
+                             });
+    std::vector<MemoryBlock> blocks;
+    for (const auto &image : order) {
+        const auto &imageRequirements = requirements[image];
+        const auto &block = std::ranges::find_if(
+            blocks, [&](const MemoryBlock &candidate) {
+                return candidate.isLazilyAllocated ==
+                           isLazilyAllocated[image] &&
+                       (candidate.requirements.memoryTypeBits &
+                        imageRequirements.memoryTypeBits) != 0 &&
+                       std::ranges::none_of(
+                           candidate.images, [&](const uint32_t &other) {
+                               return lifetimes[image].overlaps(
+                                   lifetimes[other]);
+                           });
+            });
+        if (block == blocks.end()) {
+            blocks.push_back({ .requirements = imageRequirements,
+                               .isLazilyAllocated = isLazilyAllocated[image],
+                               .images = { image } });
+            continue;
+        };
+        auto &blockRequirements = block->requirements;
+        blockRequirements.size =
+            std::max(blockRequirements.size, imageRequirements.size);
+        blockRequirements.alignment =
+            std::max(blockRequirements.alignment, imageRequirements.alignment);
+        blockRequirements.memoryTypeBits &= imageRequirements.memoryTypeBits;
+        block->images.push_back(image);
+    };
+    for (auto &block : blocks) {
+        std::ranges::sort(block.images, {}, [&lifetimes](const uint32_t &i) {
+            return lifetimes[i].firstPass;
+        });
+    };
+    return blocks;
+};
+
+// Memory of this type is only committed as the device needs it, which
+// tiled GPUs never do for attachments that stay in tile memory.
+std::optional<uint32_t> findLazilyAllocatedMemoryType(
+    const uint32_t &typeBits,
+    const VkPhysicalDeviceMemoryProperties &memoryProperties) {
+    for (uint32_t i = 0; i < memoryProperties.memoryTypeCount; i++) {
+        if ((typeBits & (1u << i)) != 0 &&
+            (memoryProperties.memoryTypes[i].propertyFlags &
+             VK_MEMORY_PROPERTY_LAZILY_ALLOCATED_BIT) != 0) {
+            return i;
+        };
+    };
+    return std::nullopt;
+};
+};  // namespace
+
+uint32_t RenderGraph::importImage(
+    const ImportedImageDescription &description) {
+    images.push_back(
+        { .aspectMask = description.aspectMask, .imported = description });
+    return static_cast<uint32_t>(images.size() - 1);
+};
+
+uint32_t RenderGraph::createImage(
+    const TransientImageDescription &description) {
+    images.push_back({ .aspectMask = getBarrierAspectMask(description),
+                       .transient = description });
+    return static_cast<uint32_t>(images.size() - 1);
+};
+
+uint32_t RenderGraph::addPass(const RenderGraphPass &pass) {
+    passes.push_back(pass);
+    return static_cast<uint32_t>(passes.size() - 1);
+};
+
+std::vector<std::vector<RenderGraph::PassUse>> RenderGraph::collectUses()
+    const {
+    std::vector<std::vector<PassUse>> uses(images.size());
+    for (uint32_t pass = 0; pass < passes.size(); pass++) {
+        const auto &passImages = passes[pass].images;
+        for (uint32_t index = 0; index < passImages.size(); index++) {
+            const auto &use = passImages[index];
+            if (use.image >= images.size()) {
+                throw std::runtime_error(
+                    std::format("Pass {} uses unknown image {}",
+                                passes[pass].name, use.image));
+            };
+            auto &imageUses = uses[use.image];
+            if (!imageUses.empty() && imageUses.back().pass == pass) {
+                throw std::runtime_error(
+                    std::format("Pass {} uses image {} twice",
+                                passes[pass].name, use.image));
+            };
+            imageUses.push_back({ .pass = pass, .index = index, .use = use });
+        };
+    };
+    for (uint32_t image = 0; image < images.size(); image++) {
+        if (!images[image].imported.has_value() && uses[image].empty()) {
+            throw std::runtime_error(
+                std::format("Transient image {} is never used", image));
+        };
+    };
+    return uses;
+};
+
+VkImageCreateInfo RenderGraph::getTransientCreateInfo(
+    const uint32_t &image, const std::vector<PassUse> &imageUses) const {
+    VkImageUsageFlags usage = 0;
+    for (const auto &passUse : imageUses) {
+        usage |= getAccessUsage(passUse.use.access);
+    };
+    // Attachments only used by one pass are never stored, so they need not
+    // be backed by memory on tiled GPUs. Any later use loads what an
+    // earlier pass stored, which has to be in memory.
+    if (imageUses.size() == 1 && (usage & VK_IMAGE_USAGE_SAMPLED_BIT) == 0) {
+        usage |= VK_IMAGE_USAGE_TRANSIENT_ATTACHMENT_BIT;
+    };
+    const auto &description = images[image].transient;
+    return {
+        .sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO,
+        .flags = 0,
+        .imageType = VK_IMAGE_TYPE_2D,
+        .format = description.format,
+        .extent = { .width = description.extent.width,
+                    .height = description.extent.height,
+                    .depth = 1 },
+        .mipLevels = 1,
+        .arrayLayers = 1,
+        .samples = description.samples,
+        .tiling = VK_IMAGE_TILING_OPTIMAL,
+        .usage = usage,
+        .sharingMode = VK_SHARING_MODE_EXCLUSIVE,
+        .initialLayout = VK_IMAGE_LAYOUT_UNDEFINED,
+    };
+};
+
+void RenderGraph::compile(
+    const vki::LogicalDevice &logicalDevice,
+    const VkPhysicalDeviceMemoryProperties &memoryProperties) {
+    const auto &uses = collectUses();
+    const auto &blocks =
+        createTransientImages(logicalDevice, memoryProperties, uses);
+    synchronize(uses, blocks);
+};
+
+RenderGraphMemory RenderGraph::estimateMemory(
+    const vki::LogicalDevice &logicalDevice,
+    const VkPhysicalDeviceMemoryProperties &memoryProperties) const {
+    const auto &uses = collectUses();
+    std::vector<uint32_t> transient;
+    std::vector<VkMemoryRequirements> requirements(images.size());
+    std::vector<Lifetime> lifetimes(images.size());
+    std::vector<bool> isLazilyAllocated(images.size(), false);
+    RenderGraphMemory memory = {};
+    for (uint32_t image = 0; image < images.size(); image++) {
+        if (images[image].imported.has_value()) continue;
+        const auto &createInfo = getTransientCreateInfo(image, uses[image]);
+        const VkDeviceImageMemoryRequirements info = {
+            .sType = VK_STRUCTURE_TYPE_DEVICE_IMAGE_MEMORY_REQUIREMENTS,
+            .pCreateInfo = &createInfo,
+        };
+        VkMemoryRequirements2 imageRequirements = {
+            .sType = VK_STRUCTURE_TYPE_MEMORY_REQUIREMENTS_2,
+        };
+        vkGetDeviceImageMemoryRequirements(logicalDevice.getVkDevice(),
+                                           &info, &imageRequirements);
+        requirements[image] = imageRequirements.memoryRequirements;
+        isLazilyAllocated[image] =
+            (createInfo.usage & VK_IMAGE_USAGE_TRANSIENT_ATTACHMENT_BIT) != 0 &&
+            findLazilyAllocatedMemoryType(requirements[image].memoryTypeBits,
+                                          memoryProperties)
+                .has_value();
+        lifetimes[image] = { .firstPass = uses[image].front().pass,
+                             .lastPass = uses[image].back().pass };
+        memory.unaliasedSize += requirements[image].size;
+        transient.push_back(image);
+    };
+    for (const auto &block : placeInMemoryBlocks(
+             transient, requirements, lifetimes, isLazilyAllocated)) {
+        if (block.isLazilyAllocated &&
+            findLazilyAllocatedMemoryType(block.requirements.memoryTypeBits,
+                                          memoryProperties)
+                .has_value()) {
+            memory.lazilyAllocatedSize += block.requirements.size;
+        };
+        memory.transientSize += block.requirements.size;
+    };
+    return memory;
+};
+
+std::vector<std::vector<uint32_t>> RenderGraph::createTransientImages(
+    const vki::LogicalDevice &logicalDevice,
+    const VkPhysicalDeviceMemoryProperties &memoryProperties,
+    const std::vector<std::vector<PassUse>> &uses) {
+    imageViews.assign(images.size(), nullptr);
+    std::vector<uint32_t> transient;
+    std::vector<VkMemoryRequirements> requirements(images.size());
+    std::vector<Lifetime> lifetimes(images.size());
+    std::vector<vki::Image *> imageObjects(images.size(), nullptr);
+    std::vector<bool> isLazilyAllocated(images.size(), false);
+    for (uint32_t image = 0; image < images.size(); image++) {
+        if (images[image].imported.has_value()) continue;
+        const auto &imageUses = uses[image];
+        const auto &createInfo = getTransientCreateInfo(image, imageUses);
+        transientImages.push_back(
+            std::make_unique<vki::Image>(logicalDevice, createInfo));
+        imageObjects[image] = transientImages.back().get();
+        images[image].vkImage = transientImages.back()->getVkImage();
+        requirements[image] = transientImages.back()->getMemoryRequirements();
+        isLazilyAllocated[image] =
+            (createInfo.usage & VK_IMAGE_USAGE_TRANSIENT_ATTACHMENT_BIT) != 0 &&
+            findLazilyAllocatedMemoryType(requirements[image].memoryTypeBits,
+                                          memoryProperties)
+                .has_value();
+        lifetimes[image] = { .firstPass = imageUses.front().pass,
+                             .lastPass = imageUses.back().pass };
+        unaliasedMemorySize += requirements[image].size;
+        transient.push_back(image);
+    };
+
+    std::vector<std::vector<uint32_t>> blockImages;
+    for (const auto &block :
+         placeInMemoryBlocks(transient, requirements, lifetimes,
+                             isLazilyAllocated)) {
+        auto memoryType = block.isLazilyAllocated
+                              ? findLazilyAllocatedMemoryType(
+                                    block.requirements.memoryTypeBits,
+                                    memoryProperties)
+                              : std::nullopt;
+        if (memoryType.has_value()) {
+            lazilyAllocatedMemorySize += block.requirements.size;
+        } else {
+            memoryType = vki::utils::findMemoryType(
+                block.requirements.memoryTypeBits, memoryProperties,
+                VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+        };
+        VkMemoryAllocateInfo allocInfo = {
+            .sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO,
+            .allocationSize = block.requirements.size,
+            .memoryTypeIndex = memoryType.value(),
+        };
+        memories.push_back(
+            std::make_unique<vki::Memory>(logicalDevice, allocInfo));
+        transientMemorySize += block.requirements.size;
+        for (const auto &image : block.images) {
+            imageObjects[image]->bindMemory(*memories.back(), 0);
+            VkImageViewCreateInfo viewCreateInfo = {
+                .sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO,
+                .image = images[image].vkImage,
+                .viewType = VK_IMAGE_VIEW_TYPE_2D,
+                .format = images[image].transient.format,
+                .subresourceRange = { .aspectMask =
+                                          images[image].transient.aspectMask,
+                                      .baseMipLevel = 0,
+                                      .levelCount = 1,
+                                      .baseArrayLayer = 0,
+                                      .layerCount = 1 }
+            };
+            transientImageViews.push_back(std::make_unique<vki::ImageView>(
+                logicalDevice, viewCreateInfo));
+            imageViews[image] = transientImageViews.back().get();
+        };
+        blockImages.push_back(block.images);
+    };
+    return blockImages;
+};
+
+void RenderGraph::synchronize(
+    const std::vector<std::vector<PassUse>> &uses,
+    const std::vector<std::vector<uint32_t>> &blocks) {
+    barriers.assign(passes.size() + 1, {});
+    attachmentOps.clear();
+    for (const auto &pass : passes) {
+        attachmentOps.emplace_back(pass.images.size());
+    };
+    // A transient image's first use waits for the last use of the image
+    // before it in the same memory. The first image of a block follows the
+    // block's last one from the previous frame.
+    std::vector<uint32_t> predecessors(images.size());
+    for (const auto &block : blocks) {
+        for (uint32_t i = 0; i < block.size(); i++) {
+            predecessors[block[i]] = block[(i + block.size() - 1) %
+                                           block.size()];
+        };
+    };
+    for (uint32_t image = 0; image < images.size(); image++) {
+        const auto &imageUses = uses[image];
+        const auto &imported = images[image].imported;
+        for (uint32_t i = 0; i < imageUses.size(); i++) {
+            const auto &[pass, index, use] = imageUses[i];
+            const auto &state = getAccessState(use.access);
+            std::optional<ImageState> src;
+            if (i > 0) {
+                const auto &previous = imageUses[i - 1].use.access;
+                const auto &previousState = getAccessState(previous);
+                // Reads in one layout need no barrier between them.
+                if (isWrite(previous) || isWrite(use.access) ||
+                    previousState.layout != state.layout) {
+                    src = withWritesOnly(previousState);
+                };
+            } else if (imported.has_value()) {
+                src = imported->initialState;
+            } else {
+                const auto &last =
+                    uses[predecessors[image]].back().use.access;
+                src = withWritesOnly(getAccessState(last));
+                src->layout = VK_IMAGE_LAYOUT_UNDEFINED;
+            };
+            if (src.has_value()) {
+                barriers[pass].push_back(
+                    { .image = image, .src = src.value(), .dst = state });
+            };
+
+            const bool hasContents =
+                i > 0 || (imported.has_value() &&
+                          imported->initialState.layout !=
+                              VK_IMAGE_LAYOUT_UNDEFINED);
+            const bool isStored =
+                i + 1 < imageUses.size() || imported.has_value();
+            auto &ops = attachmentOps[pass][index];
+            ops.layout = state.layout;
+            ops.loadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
+            if (use.isCleared) {
+                ops.loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR;
+            } else if (hasContents &&
+                       use.access != ImageAccess::RESOLVE_ATTACHMENT) {
+                ops.loadOp = VK_ATTACHMENT_LOAD_OP_LOAD;
+            };
+            ops.storeOp = isStored ? VK_ATTACHMENT_STORE_OP_STORE
+                                   : VK_ATTACHMENT_STORE_OP_DONT_CARE;
+        };
+        if (!imported.has_value()) continue;
+        const auto &last =
+            imageUses.empty()
+                ? imported->initialState
+                : withWritesOnly(getAccessState(imageUses.back().use.access));
+        const auto &finalState = imported->finalState;
+        if (last.layout != finalState.layout || finalState.accessMask != 0) {
+            barriers.back().push_back(
+                { .image = image, .src = last, .dst = finalState });
+        };
+    };
+};
+
+void RenderGraph::setImportedImage(const uint32_t &image,
+                                   const vki::ImageRef &importedImage) {
+    if (!images.at(image).imported.has_value()) {
+        throw std::invalid_argument(
+            std::format("Image {} is not imported", image));
+    };
+    images[image].vkImage = importedImage.getVkImage();
+};
+
+const vki::ImageView &RenderGraph::getImageView(const uint32_t &image) const {
+    const auto *imageView = imageViews.at(image);
+    if (imageView == nullptr) {
+        throw std::invalid_argument(
+            std::format("Image {} has no view of the graph's", image));
+    };
+    return *imageView;
+};
+
+AttachmentOps RenderGraph::getAttachmentOps(const uint32_t &pass,
+                                            const uint32_t &image) const {
+    const auto &passImages = passes.at(pass).images;
+    const auto &use =
+        std::ranges::find(passImages, image, &ImageUse::image);
+    if (use == passImages.end()) {
+        throw std::invalid_argument(std::format(
+            "Pass {} does not use image {}", passes[pass].name, image));
+    };
+    return attachmentOps.at(pass)[use - passImages.begin()];
+};
+
+VkDeviceSize RenderGraph::getTransientMemorySize() const {
+    return transientMemorySize;
+};
+
+VkDeviceSize RenderGraph::getUnaliasedMemorySize() const {
+    return unaliasedMemorySize;
+};
+
+VkDeviceSize RenderGraph::getLazilyAllocatedMemorySize() const {
+    return lazilyAllocatedMemorySize;
+};
+
+void RenderGraph::recordBarriers(
+    const vki::CommandBuffer &commandBuffer, FrameArena &arena,
+    const std::vector<ImageBarrier> &passBarriers) const {
+    if (passBarriers.empty()) return;
+    const auto &imageBarriers =
+        arena.allocate<VkImageMemoryBarrier2>(passBarriers.size());
+    for (std::size_t i = 0; i < passBarriers.size(); i++) {
+        const auto &barrier = passBarriers[i];
+        imageBarriers[i] = {
+            .sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER_2,
+            .srcStageMask = barrier.src.stageMask,
+            .srcAccessMask = barrier.src.accessMask,
+            .dstStageMask = barrier.dst.stageMask,
+            .dstAccessMask = barrier.dst.accessMask,
+            .oldLayout = barrier.src.layout,
+            .newLayout = barrier.dst.layout,
+            .srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+            .dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+            .image = images[barrier.image].vkImage,
+            .subresourceRange = { .aspectMask =
+                                      images[barrier.image].aspectMask,
+                                  .baseMipLevel = 0,
+                                  .levelCount = VK_REMAINING_MIP_LEVELS,
+                                  .baseArrayLayer = 0,
+                                  .layerCount = VK_REMAINING_ARRAY_LAYERS },
+        };
+    };
+    const VkDependencyInfo dependencyInfo = {
+        .sType = VK_STRUCTURE_TYPE_DEPENDENCY_INFO,
+        .imageMemoryBarrierCount = static_cast<uint32_t>(imageBarriers.size()),
+        .pImageMemoryBarriers = imageBarriers.data(),
+    };
+    commandBuffer.pipelineBarrier(dependencyInfo);
+};
@@ -0,0 +1,190 @@
+#pragma once
+
+#include <vulkan/vulkan_core.h>
+
+#include <cstdint>
+#include <format>
+#include <memory>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "vulkan_app/app/frame_arena.hpp"
+#include "vulkan_app/vki/command_buffer.hpp"
+#include "vulkan_app/vki/image.hpp"
+#include "vulkan_app/vki/image_view.hpp"
+#include "vulkan_app/vki/logical_device.hpp"
+#include "vulkan_app/vki/memory.hpp"
+
+// How a pass uses an image. Each access implies the layout, stages and
+// memory accesses the graph synchronizes against.
+enum class ImageAccess {
+    COLOR_ATTACHMENT,
+    DEPTH_ATTACHMENT,
+    // Written by the multisample resolve at the end of the pass.
+    RESOLVE_ATTACHMENT,
+    // Sampled by fragment shaders.
+    SAMPLED,
+    // Sampled by compute shaders.
+    COMPUTE_SAMPLED,
+};
+
+struct ImageState {
+    VkPipelineStageFlags2 stageMask;
+    VkAccessFlags2 accessMask;
+    VkImageLayout layout;
+};
+
+// An image owned outside the graph, such as a swapchain image. A frame
+// finds it in initialState and leaves it in finalState.
+struct ImportedImageDescription {
+    VkImageAspectFlags aspectMask;
+    ImageState initialState;
+    ImageState finalState;
+};
+
+// An image whose contents live within one frame. The graph creates it, and
+// places it in the same memory as transient images it never overlaps with.
+struct TransientImageDescription {
+    VkFormat format;
+    VkExtent2D extent;
+    VkSampleCountFlagBits samples;
+    VkImageAspectFlags aspectMask;
+};
+
+struct ImageUse {
+    uint32_t image;
+    ImageAccess access;
+    // Only for attachments. Otherwise the load op follows from whether an
+    // earlier use left contents behind.
+    bool isCleared = false;
+};
+
+struct RenderGraphPass {
+    std::string name;
+    // At most one use per image.
+    std::vector<ImageUse> images;
+};
+
+// What a graph's transient images take, as getTransientMemorySize,
+// getLazilyAllocatedMemorySize and getUnaliasedMemorySize report it.
+struct RenderGraphMemory {
+    VkDeviceSize transientSize;
+    VkDeviceSize lazilyAllocatedSize;
+    VkDeviceSize unaliasedSize;
+};
+
+struct AttachmentOps {
+    // The image's layout throughout the pass.
+    VkImageLayout layout;
+    VkAttachmentLoadOp loadOp;
+    VkAttachmentStoreOp storeOp;
+};
+
+// Passes declare the images they use, in execution order. Compiling the
+// graph derives the barriers between passes, the attachment load and store
+// ops, and the memory of transient images; executing it records the
+// barriers around each pass's commands.
+class RenderGraph {
+    struct GraphImage {
+        // Of the whole image, as barriers transition it.
+        VkImageAspectFlags aspectMask;
+        std::optional<ImportedImageDescription> imported;
+        TransientImageDescription transient;
+        VkImage vkImage = VK_NULL_HANDLE;
+    };
+    struct ImageBarrier {
+        uint32_t image;
+        ImageState src;
+        ImageState dst;
+    };
+    struct PassUse {
+        uint32_t pass;
+        // Position among the pass's image uses.
+        uint32_t index;
+        ImageUse use;
+    };
+
+    std::vector<GraphImage> images;
+    std::vector<RenderGraphPass> passes;
+    // One list per pass, recorded before it, and one after the last pass.
+    std::vector<std::vector<ImageBarrier>> barriers;
+    // Parallel to each pass's image uses.
+    std::vector<std::vector<AttachmentOps>> attachmentOps;
+    std::vector<std::unique_ptr<vki::Memory>> memories;
+    std::vector<std::unique_ptr<vki::Image>> transientImages;
+    std::vector<std::unique_ptr<vki::ImageView>> transientImageViews;
+    // Indexed by image handle, null for imported images.
+    std::vector<const vki::ImageView *> imageViews;
+    VkDeviceSize transientMemorySize = 0;
+    VkDeviceSize unaliasedMemorySize = 0;
+    VkDeviceSize lazilyAllocatedMemorySize = 0;
+
+    // Each image's uses, in pass order.
+    std::vector<std::vector<PassUse>> collectUses() const;
+    VkImageCreateInfo getTransientCreateInfo(
+        const uint32_t &image, const std::vector<PassUse> &imageUses) const;
+    // Returns the images sharing each memory block, in order of first use.
+    std::vector<std::vector<uint32_t>> createTransientImages(
+        const vki::LogicalDevice &logicalDevice,
+        const VkPhysicalDeviceMemoryProperties &memoryProperties,
+        const std::vector<std::vector<PassUse>> &uses);
+    void synchronize(const std::vector<std::vector<PassUse>> &uses,
+                     const std::vector<std::vector<uint32_t>> &blocks);
+    void recordBarriers(const vki::CommandBuffer &commandBuffer,
+                        FrameArena &arena,
+                        const std::vector<ImageBarrier> &passBarriers) const;
+
+public:
+    RenderGraph() = default;
+    RenderGraph(RenderGraph &&other) = default;
+    RenderGraph(const RenderGraph &other) = delete;
+    RenderGraph &operator=(const RenderGraph &other) = delete;
+
+    // Each returns the handle that image uses refer to.
+    uint32_t importImage(const ImportedImageDescription &description);
+    uint32_t createImage(const TransientImageDescription &description);
+    uint32_t addPass(const RenderGraphPass &pass);
+
+    // Throws if a pass uses an unknown image or one image twice, or if a
+    // transient image is never used.
+    void compile(const vki::LogicalDevice &logicalDevice,
+                 const VkPhysicalDeviceMemoryProperties &memoryProperties);
+    // The memory compiling would allocate, from the device's memory
+    // requirements for each transient image without creating any of them.
+    RenderGraphMemory estimateMemory(
+        const vki::LogicalDevice &logicalDevice,
+        const VkPhysicalDeviceMemoryProperties &memoryProperties) const;
+
+    // Imported images may change from frame to frame.
+    void setImportedImage(const uint32_t &image,
+                          const vki::ImageRef &importedImage);
+    const vki::ImageView &getImageView(const uint32_t &image) const;
+    AttachmentOps getAttachmentOps(const uint32_t &pass,
+                                   const uint32_t &image) const;
+    // Memory bound to transient images, and what it would take without
+    // aliasing.
+    VkDeviceSize getTransientMemorySize() const;
+    VkDeviceSize getUnaliasedMemorySize() const;
+    // The part of the transient memory that is only committed if the
+    // device spills attachments out of tile memory.
+    VkDeviceSize getLazilyAllocatedMemorySize() const;
+
+    // Records one function per pass, in the order they were added. The
+    // barriers between them are built in the arena.
+    template <typename... Recorders>
+    void execute(const vki::CommandBuffer &commandBuffer, FrameArena &arena,
+                 Recorders &&...recorders) const {
+        if (sizeof...(recorders) != passes.size()) {
+            throw std::invalid_argument(std::format(
+                "Render graph has {} passes but got {} recorders",
+                passes.size(), sizeof...(recorders)));
+        };
+        uint32_t pass = 0;
+        ((recordBarriers(commandBuffer, arena, barriers[pass++]),
+          recorders()),
+         ...);
+        recordBarriers(commandBuffer, arena, barriers.back());
+    };
+};
@@ -0,0 +1,120 @@
+#include "./render_queue.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <utility>
+
+#include "glm/geometric.hpp"
+#include "vulkan_app/app/data_aggregator.hpp"
+#include "vulkan_app/app/frame_state.hpp"
+
+namespace {
+constexpr unsigned int passBits = 4;
+constexpr unsigned int pipelineBits = 12;
+constexpr unsigned int materialBits = 24;
+constexpr unsigned int depthBits = 24;
+static_assert(passBits + pipelineBits + materialBits + depthBits == 64);
+
+inline uint64_t field(const uint64_t &value, const unsigned int &bits,
+                      const unsigned int &shift) {
+    return (value & ((uint64_t(1) << bits) - 1)) << shift;
+};
+};  // namespace
+
+uint64_t DrawKey::pack() const {
+    // Non-negative floats order the same as their bit patterns, whose sign
+    // bit is clear. Negative depths and NaN are clamped to zero.
+    const float clamped = depth > 0.0f ? depth : 0.0f;
+    const auto &depthKey =
+        std::bit_cast<uint32_t>(clamped) >> (32 - depthBits);
+    return field(static_cast<uint32_t>(pass), passBits,
+                 pipelineBits + materialBits + depthBits) |
+           field(pipeline, pipelineBits, materialBits + depthBits) |
+           field(material, materialBits, depthBits) |
+           field(depthKey, depthBits, 0);
+};
+
+RenderQueue::RenderQueue(const unsigned int &threadCount)
+    : workers(threadCount) {};
+
+void RenderQueue::clear() { entries.clear(); };
+
+void RenderQueue::push(const DrawKey &key, const uint32_t &shape) {
+    entries.push_back({ .key = key.pack(), .shape = shape });
+};
+
+std::span<const uint32_t> RenderQueue::sort() {
+    const std::size_t count = entries.size();
+    // The calling thread sorts a chunk of its own.
+    const std::size_t chunkCount =
+        count < parallelSortThreshold ? 1 : workers.size() + 1;
+    const auto &chunkBegin = [&](const std::size_t &chunk) {
+        return count * chunk / chunkCount;
+    };
+    uint64_t anyBits = 0;
+    uint64_t allBits = ~uint64_t(0);
+    for (const auto &entry : entries) {
+        anyBits |= entry.key;
+        allBits &= entry.key;
+    };
+    const uint64_t varyingBits = anyBits ^ allBits;
+    scratch.resize(count);
+    histograms.resize(chunkCount);
+    for (unsigned int shift = 0; shift < 64; shift += radixBits) {
+        if (((varyingBits >> shift) & (radixSize - 1)) == 0) continue;
+        forEachChunk(chunkCount, [&](const std::size_t &chunk) {
+            auto &histogram = histograms[chunk];
+            histogram.fill(0);
+            for (std::size_t i = chunkBegin(chunk); i < chunkBegin(chunk + 1);
+                 i++) {
+                histogram[(entries[i].key >> shift) & (radixSize - 1)]++;
+            };
+        });
+        // Each chunk scatters a digit after the same digit of the chunks
+        // before it, which keeps the sort stable.
+        uint32_t offset = 0;
+        for (std::size_t digit = 0; digit < radixSize; digit++) {
+            for (auto &histogram : histograms) {
+                const auto digitCount = histogram[digit];
+                histogram[digit] = offset;
+                offset += digitCount;
+            };
+        };
+        forEachChunk(chunkCount, [&](const std::size_t &chunk) {
+            auto &offsets = histograms[chunk];
+            for (std::size_t i = chunkBegin(chunk); i < chunkBegin(chunk + 1);
+                 i++) {
+                const auto &entry = entries[i];
+                scratch[offsets[(entry.key >> shift) & (radixSize - 1)]++] =
+                    entry;
+            };
+        });
+        std::swap(entries, scratch);
+    };
+    order.resize(count);
+    for (std::size_t i = 0; i < count; i++) {
+        order[i] = entries[i].shape;
+    };
+    return order;
+};
+
+void queueSceneDraws(RenderQueue &queue, const DataAggregator &aggregator,
+                     const std::span<const uint32_t> &visibleShapes,
+                     const FrameState &frameState, const uint32_t &pipeline) {
+    const auto &viewDirection = glm::normalize(frameState.cameraFront);
+    queue.clear();
+    for (const auto &shapeIndex : visibleShapes) {
+        const auto &sphere = aggregator.shapeBounds.getSphere(shapeIndex);
+        queue.push(
+            { .pass = DrawPass::SCENE,
+              .pipeline = pipeline,
+              .material = aggregator.instances[shapeIndex].textureIndex,
+              .depth = glm::dot(sphere.center - frameState.cameraPos,
+                                viewDirection) -
+                       sphere.radius },
+            shapeIndex);
+    };
+};
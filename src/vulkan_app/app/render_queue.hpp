@@ -0,0 +1,89 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <future>
+#include <span>
+#include <vector>
+
+#include "vulkan_app/app/data_aggregator.hpp"
+#include "vulkan_app/app/frame_state.hpp"
+#include "vulkan_app/app/thread_pool.hpp"
+
+enum class DrawPass : uint32_t {
+    SCENE = 0,
+};
+
+// The fields of a draw's sort key, from most to least significant. Each is
+// truncated to its width in the packed key: 4 bits of pass, 12 of pipeline,
+// 24 of material and 24 of depth.
+struct DrawKey {
+    DrawPass pass;
+    uint32_t pipeline;
+    uint32_t material;
+    // Distance along the view direction; nearer draws sort first.
+    float depth;
+
+    uint64_t pack() const;
+};
+
+// Collects a frame's draws with their sort keys and orders them by key
+// with a least significant digit radix sort. Large queues are split into
+// one chunk per worker, which count and scatter their digits in parallel;
+// digits that are equal across every key are skipped. The storage is kept
+// from frame to frame.
+class RenderQueue {
+    static constexpr unsigned int radixBits = 8;
+    static constexpr std::size_t radixSize = std::size_t(1) << radixBits;
+    using Histogram = std::array<uint32_t, radixSize>;
+
+    struct Entry {
+        uint64_t key;
+        uint32_t shape;
+    };
+
+    std::vector<Entry> entries;
+    std::vector<Entry> scratch;
+    std::vector<uint32_t> order;
+    // One per chunk, turned into the chunk's scatter offsets.
+    std::vector<Histogram> histograms;
+    std::vector<std::future<void>> tasks;
+    // Declared last so the workers finish before anything they use is
+    // destroyed.
+    ThreadPool workers;
+
+    template <typename Func>
+    void forEachChunk(const std::size_t &chunkCount, Func &&func) {
+        tasks.clear();
+        for (std::size_t chunk = 1; chunk < chunkCount; chunk++) {
+            tasks.push_back(
+                workers.submit([&func, chunk]() { func(chunk); }));
+        };
+        func(0);
+        for (auto &task : tasks) {
+            task.get();
+        };
+    };
+
+public:
+    // Queues smaller than this are sorted on the calling thread.
+    static constexpr std::size_t parallelSortThreshold = 16384;
+
+    explicit RenderQueue(
+        const unsigned int &threadCount = ThreadPool::defaultThreadCount());
+    RenderQueue(const RenderQueue &other) = delete;
+    RenderQueue &operator=(const RenderQueue &other) = delete;
+
+    void clear();
+    void push(const DrawKey &key, const uint32_t &shape);
+    // Returns the queued shapes in key order, with equal keys in the order
+    // they were pushed. Valid until the next call to clear.
+    std::span<const uint32_t> sort();
+};
+
+// Queues the visible shapes for the scene pass, keyed by their texture and
+// by the distance to the nearest point of their bounding sphere.
+void queueSceneDraws(RenderQueue &queue, const DataAggregator &aggregator,
+                     const std::span<const uint32_t> &visibleShapes,
+                     const FrameState &frameState, const uint32_t &pipeline);
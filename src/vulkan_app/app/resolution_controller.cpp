@@ -0,0 +1,108 @@
+#include "./resolution_controller.hpp"
+
+#include <vulkan/vulkan_core.h>
+
+#include <algorithm>
+#include <charconv>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <format>
+#include <stdexcept>
+#include <string_view>
+#include <system_error>
+
+namespace {
+// Weight of the newest frame time in the average.
+constexpr float smoothing = 0.1f;
+// Below this share of the budget the scale is raised.
+constexpr float headroom = 0.8f;
+// Changes aim between the headroom and the budget.
+constexpr float targetShare = 0.9f;
+constexpr float maxDecrease = 0.85f;
+constexpr float maxIncrease = 1.05f;
+// Frame times only reflect a change once the frames recorded before it
+// have been measured.
+constexpr uint32_t settleFrames = 4;
+
+float parseFloat(const std::string_view &text, const std::string_view &name) {
+    float value;
+    const auto *end = text.data() + text.size();
+    const auto &[parsedEnd, error] = std::from_chars(text.data(), end, value);
+    if (error != std::errc{} || parsedEnd != end) {
+        throw std::invalid_argument(
+            std::format("Malformed {}: {}", name, text));
+    };
+    return value;
+};
+
+uint32_t scaleDimension(const uint32_t &dimension, const float &scale) {
+    return std::max(1u, static_cast<uint32_t>(std::lround(dimension * scale)));
+};
+};  // namespace
+
+ResolutionScaling getRequestedResolutionScaling() {
+    ResolutionScaling scaling;
+    if (const char *value = std::getenv("VULKAN_APP_RENDER_SCALE")) {
+        const std::string_view text = value;
+        const auto &separator = text.find('-');
+        scaling.minScale = parseFloat(text.substr(0, separator),
+                                      "VULKAN_APP_RENDER_SCALE");
+        scaling.maxScale = separator == std::string_view::npos
+                               ? scaling.minScale
+                               : parseFloat(text.substr(separator + 1),
+                                            "VULKAN_APP_RENDER_SCALE");
+    };
+    if (const char *value = std::getenv("VULKAN_APP_FRAME_BUDGET")) {
+        scaling.frameBudget = parseFloat(value, "VULKAN_APP_FRAME_BUDGET");
+    };
+    if (!(scaling.minScale > 0.0f && scaling.minScale <= scaling.maxScale &&
+          scaling.maxScale <= 1.0f)) {
+        throw std::invalid_argument(
+            std::format("Render scale bounds {}-{} are not within (0, 1]",
+                        scaling.minScale, scaling.maxScale));
+    };
+    if (!(scaling.frameBudget > 0.0f)) {
+        throw std::invalid_argument(std::format(
+            "Frame budget of {} ms is not positive", scaling.frameBudget));
+    };
+    return scaling;
+};
+
+ResolutionController::ResolutionController(const ResolutionScaling &scaling)
+    : scaling{ scaling }, scale{ scaling.maxScale } {};
+
+void ResolutionController::update(const float &gpuFrameTime) {
+    averageFrameTime =
+        averageFrameTime < 0.0f
+            ? gpuFrameTime
+            : averageFrameTime + smoothing * (gpuFrameTime - averageFrameTime);
+    if (++framesSinceChange < settleFrames) return;
+    const auto &budget = scaling.frameBudget;
+    if (averageFrameTime <= budget && averageFrameTime >= budget * headroom) {
+        return;
+    };
+    // Frame time grows with the pixel count, the square of the scale.
+    auto target =
+        scale * std::sqrt(budget * targetShare / averageFrameTime);
+    target = std::clamp(target, scale * maxDecrease, scale * maxIncrease);
+    target = std::clamp(target, scaling.minScale, scaling.maxScale);
+    if (target == scale) return;
+    // What the average would have been at the new scale, so that frames
+    // measured before the change do not drive another one.
+    averageFrameTime *= (target * target) / (scale * scale);
+    scale = target;
+    framesSinceChange = 0;
+};
+
+VkExtent2D ResolutionController::getRenderExtent(
+    const VkExtent2D &outputExtent) const {
+    return { .width = scaleDimension(outputExtent.width, scale),
+             .height = scaleDimension(outputExtent.height, scale) };
+};
+
+VkExtent2D ResolutionController::getMaxRenderExtent(
+    const VkExtent2D &outputExtent) const {
+    return { .width = scaleDimension(outputExtent.width, scaling.maxScale),
+             .height = scaleDimension(outputExtent.height, scaling.maxScale) };
+};
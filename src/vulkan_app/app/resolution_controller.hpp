@@ -0,0 +1,39 @@
+#pragma once
+
+#include <vulkan/vulkan_core.h>
+
+#include <cstdint>
+
+struct ResolutionScaling {
+    // Bounds of the render extent relative to the output extent, per axis.
+    float minScale = 0.5f;
+    float maxScale = 1.0f;
+    // GPU time a frame should stay within, in milliseconds.
+    float frameBudget = 16.0f;
+};
+
+// $VULKAN_APP_RENDER_SCALE as "min-max", or one scale to render at
+// throughout, and $VULKAN_APP_FRAME_BUDGET in milliseconds. Unset ones
+// keep their defaults. Throws on malformed values and on scales outside
+// (0, 1].
+ResolutionScaling getRequestedResolutionScaling();
+
+// Picks the scale the scene is rendered at from measured GPU frame times.
+// The scale drops quickly when frames go over budget and recovers slowly
+// once there is headroom, so that it does not oscillate around the budget.
+class ResolutionController {
+    ResolutionScaling scaling;
+    float scale;
+    // Moving average of frame times, negative until the first one.
+    float averageFrameTime = -1.0f;
+    uint32_t framesSinceChange = 0;
+
+public:
+    explicit ResolutionController(const ResolutionScaling &scaling);
+
+    void update(const float &gpuFrameTime);
+    inline float getScale() const { return scale; };
+    // At least one pixel, and never larger than at the maximum scale.
+    VkExtent2D getRenderExtent(const VkExtent2D &outputExtent) const;
+    VkExtent2D getMaxRenderExtent(const VkExtent2D &outputExtent) const;
+};
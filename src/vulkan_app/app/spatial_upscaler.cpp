@@ -0,0 +1,95 @@
+#include "./spatial_upscaler.hpp"
+
+#include <vulkan/vulkan_core.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+
+#include "shaders.hpp"
+#include "vulkan_app/app/create_pipeline.hpp"
+#include "vulkan_app/app/descriptor_allocator.hpp"
+#include "vulkan_app/app/descriptor_layout_cache.hpp"
+#include "vulkan_app/app/pipeline_description.hpp"
+#include "vulkan_app/app/spirv_reflection.hpp"
+#include "vulkan_app/vki/command_buffer.hpp"
+#include "vulkan_app/vki/graphics_pipeline.hpp"
+#include "vulkan_app/vki/image_view.hpp"
+#include "vulkan_app/vki/logical_device.hpp"
+#include "vulkan_app/vki/pipeline_cache.hpp"
+#include "vulkan_app/vki/pipeline_layout.hpp"
+
+SpatialUpscaler::SpatialUpscaler(const vki::LogicalDevice &logicalDevice,
+                                 DescriptorLayoutCache &descriptorLayouts,
+                                 const vki::PipelineCache &pipelineCache,
+                                 const VkFormat &outputFormat,
+                                 const vki::ImageView &source)
+    : layoutDescription{ describePipelineLayout(
+          { reflect_spirv(upscaleVertShaderCode.words()),
+            reflect_spirv(upscaleFragShaderCode.words()) },
+          0) },
+      pipelineLayout{ descriptorLayouts.getPipelineLayout(layoutDescription) },
+      descriptorAllocator{
+          logicalDevice, layoutDescription.sets.at(0),
+          descriptorLayouts.getSetLayout(layoutDescription.sets.at(0)), 1 },
+      descriptorSet{ descriptorAllocator.allocate() },
+      pipeline{ createGraphicsPipeline(
+          logicalDevice,
+          { .vertexShader = upscaleVertShaderCode.name,
+            .fragmentShader = upscaleFragShaderCode.name,
+            .hasVertexInput = false,
+            .colorAttachmentFormat = outputFormat },
+          pipelineLayout, pipelineCache) } {
+    VkDescriptorImageInfo imageInfo = {
+        .imageView = source.getVkImageView(),
+        .imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL
+    };
+    logicalDevice.updateWriteDescriptorSets({ {
+        .sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET,
+        .dstSet = descriptorSet,
+        .dstBinding = 0,
+        .dstArrayElement = 0,
+        .descriptorCount = 1,
+        .descriptorType = VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE,
+        .pImageInfo = &imageInfo,
+        .pBufferInfo = nullptr,
+        .pTexelBufferView = nullptr,
+    } });
+};
+
+void SpatialUpscaler::record(const vki::CommandBuffer &commandBuffer,
+                             const VkExtent2D &renderExtent,
+                             const VkExtent2D &outputExtent) const {
+    commandBuffer.bindPipeline(pipeline,
+                               vki::PipelineBindPointType::GRAPHICS);
+    commandBuffer.setViewport(
+        { .x = 0.0f,
+          .y = 0.0f,
+          .width = static_cast<float>(outputExtent.width),
+          .height = static_cast<float>(outputExtent.height),
+          .minDepth = 0.0f,
+          .maxDepth = 1.0f });
+    commandBuffer.setScissor(
+        { .offset = { .x = 0, .y = 0 }, .extent = outputExtent });
+    commandBuffer.setCullMode(VK_CULL_MODE_NONE);
+    commandBuffer.setDepthTestEnable(false);
+    commandBuffer.setDepthWriteEnable(false);
+    commandBuffer.bindDescriptorSet({
+        .bindPointType = vki::PipelineBindPointType::GRAPHICS,
+        .pipelineLayout = pipelineLayout,
+        .firstSet = 0,
+        .descriptorSets = { descriptorSet },
+        .dynamicOffsets = {},
+    });
+    const UpscaleConstants constants = {
+        .inputScale = { static_cast<float>(renderExtent.width) /
+                            static_cast<float>(outputExtent.width),
+                        static_cast<float>(renderExtent.height) /
+                            static_cast<float>(outputExtent.height) },
+        .inputMax = { static_cast<int32_t>(renderExtent.width) - 1,
+                      static_cast<int32_t>(renderExtent.height) - 1 },
+    };
+    commandBuffer.pushConstants(pipelineLayout, UpscaleConstants::stageFlags,
+                                0, std::as_bytes(std::span(&constants, 1)));
+    commandBuffer.draw({ .vertexCount = 3, .instanceCount = 1 });
+};
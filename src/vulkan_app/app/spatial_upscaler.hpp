@@ -0,0 +1,47 @@
+#pragma once
+
+#include <vulkan/vulkan_core.h>
+
+#include "glm/vec2.hpp"
+#include "vulkan_app/app/descriptor_allocator.hpp"
+#include "vulkan_app/app/descriptor_layout_cache.hpp"
+#include "vulkan_app/vki/command_buffer.hpp"
+#include "vulkan_app/vki/graphics_pipeline.hpp"
+#include "vulkan_app/vki/image_view.hpp"
+#include "vulkan_app/vki/logical_device.hpp"
+#include "vulkan_app/vki/pipeline_cache.hpp"
+#include "vulkan_app/vki/pipeline_layout.hpp"
+
+// Matches the push_constant block in upscale.frag.
+struct UpscaleConstants {
+    glm::vec2 inputScale;
+    glm::ivec2 inputMax;
+
+    static constexpr VkShaderStageFlags stageFlags =
+        VK_SHADER_STAGE_FRAGMENT_BIT;
+};
+
+// Draws the render extent of the source image over the whole output with
+// the edge-adaptive filter in upscale.frag. The source is read by texel
+// fetches, so it needs no sampler, and its descriptor set is written once.
+class SpatialUpscaler {
+    PipelineLayoutDescription layoutDescription;
+    const vki::PipelineLayout &pipelineLayout;
+    DescriptorAllocator descriptorAllocator;
+    VkDescriptorSet descriptorSet;
+    vki::GraphicsPipeline pipeline;
+
+public:
+    explicit SpatialUpscaler(const vki::LogicalDevice &logicalDevice,
+                             DescriptorLayoutCache &descriptorLayouts,
+                             const vki::PipelineCache &pipelineCache,
+                             const VkFormat &outputFormat,
+                             const vki::ImageView &source);
+    SpatialUpscaler(const SpatialUpscaler &other) = delete;
+    SpatialUpscaler &operator=(const SpatialUpscaler &other) = delete;
+
+    // Records into rendering begun on the output image.
+    void record(const vki::CommandBuffer &commandBuffer,
+                const VkExtent2D &renderExtent,
+                const VkExtent2D &outputExtent) const;
+};
@@ -0,0 +1,347 @@
+#include "./spirv_reflection.hpp"
+
+#include <vulkan/vulkan_core.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <map>
+#include <optional>
+#include <span>
+#include <stdexcept>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+namespace {
+constexpr uint32_t spirvMagic = 0x07230203;
+constexpr std::size_t headerWords = 5;
+
+constexpr uint32_t opEntryPoint = 15;
+constexpr uint32_t opTypeBool = 20;
+constexpr uint32_t opTypeInt = 21;
+constexpr uint32_t opTypeFloat = 22;
+constexpr uint32_t opTypeVector = 23;
+constexpr uint32_t opTypeMatrix = 24;
+constexpr uint32_t opTypeImage = 25;
+constexpr uint32_t opTypeSampler = 26;
+constexpr uint32_t opTypeSampledImage = 27;
+constexpr uint32_t opTypeArray = 28;
+constexpr uint32_t opTypeRuntimeArray = 29;
+constexpr uint32_t opTypeStruct = 30;
+constexpr uint32_t opTypePointer = 32;
+constexpr uint32_t opConstant = 43;
+constexpr uint32_t opSpecConstant = 50;
+constexpr uint32_t opVariable = 59;
+constexpr uint32_t opDecorate = 71;
+constexpr uint32_t opMemberDecorate = 72;
+constexpr uint32_t opTypeAccelerationStructure = 5341;
+
+constexpr uint32_t decorationBufferBlock = 3;
+constexpr uint32_t decorationArrayStride = 6;
+constexpr uint32_t decorationMatrixStride = 7;
+constexpr uint32_t decorationBinding = 33;
+constexpr uint32_t decorationDescriptorSet = 34;
+constexpr uint32_t decorationOffset = 35;
+
+constexpr uint32_t storageUniformConstant = 0;
+constexpr uint32_t storageUniform = 2;
+constexpr uint32_t storagePushConstant = 9;
+constexpr uint32_t storageStorageBuffer = 12;
+
+constexpr uint32_t dimBuffer = 5;
+constexpr uint32_t dimSubpassData = 6;
+
+VkShaderStageFlagBits toShaderStage(const uint32_t &executionModel) {
+    switch (executionModel) {
+        case 0: return VK_SHADER_STAGE_VERTEX_BIT;
+        case 1: return VK_SHADER_STAGE_TESSELLATION_CONTROL_BIT;
+        case 2: return VK_SHADER_STAGE_TESSELLATION_EVALUATION_BIT;
+        case 3: return VK_SHADER_STAGE_GEOMETRY_BIT;
+        case 4: return VK_SHADER_STAGE_FRAGMENT_BIT;
+        case 5: return VK_SHADER_STAGE_COMPUTE_BIT;
+    };
+    throw std::runtime_error("Unsupported SPIR-V execution model");
+};
+
+uint32_t operand(const std::span<const uint32_t> &operands,
+                 const std::size_t &index) {
+    if (index >= operands.size()) {
+        throw std::runtime_error("Truncated SPIR-V instruction");
+    };
+    return operands[index];
+};
+
+struct Type {
+    uint32_t opcode;
+    // Operands after the result id.
+    std::vector<uint32_t> operands;
+};
+
+struct Variable {
+    uint32_t pointerType;
+    uint32_t id;
+    uint32_t storageClass;
+};
+
+// The subset of a module's declarations that describes its interface.
+struct SpirvModule {
+    std::optional<uint32_t> executionModel;
+    std::unordered_map<uint32_t, Type> types;
+    std::unordered_map<uint32_t, uint32_t> constants;
+    std::vector<Variable> variables;
+    std::unordered_map<uint32_t, uint32_t> descriptorSets;
+    std::unordered_map<uint32_t, uint32_t> bindings;
+    std::unordered_map<uint32_t, uint32_t> arrayStrides;
+    std::unordered_set<uint32_t> bufferBlocks;
+    std::map<std::pair<uint32_t, uint32_t>, uint32_t> memberOffsets;
+    std::map<std::pair<uint32_t, uint32_t>, uint32_t> memberMatrixStrides;
+
+    void read(const uint32_t &opcode,
+              const std::span<const uint32_t> &operands) {
+        switch (opcode) {
+            case opEntryPoint:
+                if (executionModel.has_value()) {
+                    throw std::runtime_error(
+                        "SPIR-V module has several entry points");
+                };
+                executionModel = operand(operands, 0);
+                break;
+            case opDecorate: readDecoration(operands); break;
+            case opMemberDecorate: readMemberDecoration(operands); break;
+            case opTypeBool:
+            case opTypeInt:
+            case opTypeFloat:
+            case opTypeVector:
+            case opTypeMatrix:
+            case opTypeImage:
+            case opTypeSampler:
+            case opTypeSampledImage:
+            case opTypeArray:
+            case opTypeRuntimeArray:
+            case opTypeStruct:
+            case opTypePointer:
+            case opTypeAccelerationStructure:
+                types[operand(operands, 0)] = {
+                    .opcode = opcode,
+                    .operands = { operands.begin() + 1, operands.end() }
+                };
+                break;
+            case opConstant:
+            case opSpecConstant:
+                constants[operand(operands, 1)] = operand(operands, 2);
+                break;
+            case opVariable:
+                variables.push_back({ .pointerType = operand(operands, 0),
+                                      .id = operand(operands, 1),
+                                      .storageClass = operand(operands, 2) });
+                break;
+        };
+    };
+
+    void readDecoration(const std::span<const uint32_t> &operands) {
+        const auto target = operand(operands, 0);
+        switch (operand(operands, 1)) {
+            case decorationDescriptorSet:
+                descriptorSets[target] = operand(operands, 2);
+                break;
+            case decorationBinding:
+                bindings[target] = operand(operands, 2);
+                break;
+            case decorationArrayStride:
+                arrayStrides[target] = operand(operands, 2);
+                break;
+            case decorationBufferBlock: bufferBlocks.insert(target); break;
+        };
+    };
+
+    void readMemberDecoration(const std::span<const uint32_t> &operands) {
+        const std::pair member = { operand(operands, 0),
+                                   operand(operands, 1) };
+        switch (operand(operands, 2)) {
+            case decorationOffset:
+                memberOffsets[member] = operand(operands, 3);
+                break;
+            case decorationMatrixStride:
+                memberMatrixStrides[member] = operand(operands, 3);
+                break;
+        };
+    };
+
+    const Type &getType(const uint32_t &id) const {
+        const auto &type = types.find(id);
+        if (type == types.end()) {
+            throw std::runtime_error("SPIR-V references an undeclared type");
+        };
+        return type->second;
+    };
+
+    uint32_t getConstant(const uint32_t &id) const {
+        const auto &constant = constants.find(id);
+        if (constant == constants.end()) {
+            throw std::runtime_error("SPIR-V array length is not a constant");
+        };
+        return constant->second;
+    };
+
+    VkDescriptorType getDescriptorType(const uint32_t &typeId,
+                                       const uint32_t &storageClass) const {
+        const auto &type = getType(typeId);
+        switch (type.opcode) {
+            case opTypeSampler: return VK_DESCRIPTOR_TYPE_SAMPLER;
+            case opTypeSampledImage:
+                return VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+            case opTypeImage: {
+                const auto dim = operand(type.operands, 1);
+                const auto isStorage = operand(type.operands, 5) == 2;
+                if (dim == dimSubpassData) {
+                    return VK_DESCRIPTOR_TYPE_INPUT_ATTACHMENT;
+                };
+                if (dim == dimBuffer) {
+                    return isStorage ? VK_DESCRIPTOR_TYPE_STORAGE_TEXEL_BUFFER
+                                     : VK_DESCRIPTOR_TYPE_UNIFORM_TEXEL_BUFFER;
+                };
+                return isStorage ? VK_DESCRIPTOR_TYPE_STORAGE_IMAGE
+                                 : VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE;
+            };
+            case opTypeAccelerationStructure:
+                return VK_DESCRIPTOR_TYPE_ACCELERATION_STRUCTURE_KHR;
+            case opTypeStruct:
+                if (storageClass == storageStorageBuffer ||
+                    bufferBlocks.contains(typeId)) {
+                    return VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+                };
+                return VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
+        };
+        throw std::runtime_error("Unsupported SPIR-V descriptor type");
+    };
+
+    // Bytes spanned by a value of the type, following its explicit layout
+    // decorations.
+    uint32_t getSize(const uint32_t &typeId,
+                     const std::optional<uint32_t> &matrixStride) const {
+        const auto &type = getType(typeId);
+        switch (type.opcode) {
+            case opTypeBool: return 4;
+            case opTypeInt:
+            case opTypeFloat: return operand(type.operands, 0) / 8;
+            case opTypeVector:
+                return operand(type.operands, 1) *
+                       getSize(operand(type.operands, 0), std::nullopt);
+            case opTypeMatrix: {
+                const auto &columnSize =
+                    getSize(operand(type.operands, 0), std::nullopt);
+                return (operand(type.operands, 1) - 1) *
+                           matrixStride.value_or(columnSize) +
+                       columnSize;
+            };
+            case opTypeArray: {
+                const auto &elementSize =
+                    getSize(operand(type.operands, 0), matrixStride);
+                const auto &stride = arrayStrides.find(typeId);
+                const auto length = getConstant(operand(type.operands, 1));
+                if (length == 0) return 0;
+                return (length - 1) * (stride == arrayStrides.end()
+                                           ? elementSize
+                                           : stride->second) +
+                       elementSize;
+            };
+            case opTypeStruct: return getStructExtent(typeId).second;
+        };
+        throw std::runtime_error("SPIR-V type has no fixed size");
+    };
+
+    // Offset of the first member and end of the last one.
+    std::pair<uint32_t, uint32_t> getStructExtent(
+        const uint32_t &structId) const {
+        const auto &type = getType(structId);
+        if (type.opcode != opTypeStruct || type.operands.empty()) {
+            return { 0, 0 };
+        };
+        uint32_t begin = std::numeric_limits<uint32_t>::max();
+        uint32_t end = 0;
+        for (uint32_t i = 0; i < type.operands.size(); i++) {
+            const auto &offset = memberOffsets.find({ structId, i });
+            if (offset == memberOffsets.end()) {
+                throw std::runtime_error("SPIR-V block member has no offset");
+            };
+            const auto &stride = memberMatrixStrides.find({ structId, i });
+            const auto &size = getSize(
+                type.operands[i], stride == memberMatrixStrides.end()
+                                      ? std::nullopt
+                                      : std::optional(stride->second));
+            begin = std::min(begin, offset->second);
+            end = std::max(end, offset->second + size);
+        };
+        return { begin, end };
+    };
+};
+};  // namespace
+
+SpirvReflection reflect_spirv(const std::span<const uint32_t> &code) {
+    if (code.size() < headerWords || code[0] != spirvMagic) {
+        throw std::runtime_error("Not a SPIR-V module");
+    };
+    SpirvModule module;
+    for (std::size_t i = headerWords; i < code.size();) {
+        const uint32_t wordCount = code[i] >> 16;
+        if (wordCount == 0 || wordCount > code.size() - i) {
+            throw std::runtime_error("Truncated SPIR-V instruction");
+        };
+        module.read(code[i] & 0xffff, code.subspan(i + 1, wordCount - 1));
+        i += wordCount;
+    };
+    if (!module.executionModel.has_value()) {
+        throw std::runtime_error("SPIR-V module has no entry point");
+    };
+
+    SpirvReflection reflection = {
+        .stage = toShaderStage(module.executionModel.value()),
+        .pushConstantOffset = 0,
+        .pushConstantSize = 0,
+    };
+    for (const auto &variable : module.variables) {
+        const auto &pointer = module.getType(variable.pointerType);
+        if (pointer.opcode != opTypePointer) {
+            throw std::runtime_error("SPIR-V variable is not a pointer");
+        };
+        auto typeId = operand(pointer.operands, 1);
+        if (variable.storageClass == storagePushConstant) {
+            const auto &[begin, end] = module.getStructExtent(typeId);
+            reflection.pushConstantOffset = begin;
+            reflection.pushConstantSize = end - begin;
+            continue;
+        };
+        if (variable.storageClass != storageUniformConstant &&
+            variable.storageClass != storageUniform &&
+            variable.storageClass != storageStorageBuffer) {
+            continue;
+        };
+        const auto &binding = module.bindings.find(variable.id);
+        if (binding == module.bindings.end()) continue;
+
+        uint32_t descriptorCount = 1;
+        const auto &type = module.getType(typeId);
+        if (type.opcode == opTypeArray) {
+            descriptorCount = module.getConstant(operand(type.operands, 1));
+            typeId = operand(type.operands, 0);
+        } else if (type.opcode == opTypeRuntimeArray) {
+            descriptorCount = 0;
+            typeId = operand(type.operands, 0);
+        };
+        const auto &set = module.descriptorSets.find(variable.id);
+        reflection.bindings.push_back({
+            .set = set == module.descriptorSets.end() ? 0 : set->second,
+            .binding = binding->second,
+            .descriptorType =
+                module.getDescriptorType(typeId, variable.storageClass),
+            .descriptorCount = descriptorCount,
+        });
+    };
+    std::ranges::sort(reflection.bindings, {}, [](const SpirvBinding &b) {
+        return std::pair(b.set, b.binding);
+    });
+    return reflection;
+};
@@ -0,0 +1,29 @@
+#pragma once
+
+#include <vulkan/vulkan_core.h>
+
+#include <cstdint>
+#include <span>
+#include <vector>
+
+struct SpirvBinding {
+    uint32_t set;
+    uint32_t binding;
+    VkDescriptorType descriptorType;
+    // Zero for runtime arrays, whose size is chosen by the application.
+    uint32_t descriptorCount;
+};
+
+struct SpirvReflection {
+    VkShaderStageFlagBits stage;
+    std::vector<SpirvBinding> bindings;
+    // Bytes of the push constant block used by this stage, zero if the
+    // module declares none.
+    uint32_t pushConstantOffset;
+    uint32_t pushConstantSize;
+};
+
+// Reads the resource interface of a single-entry-point SPIR-V module:
+// descriptor bindings with their types and array sizes, and the extent of
+// the push constant block. Throws on malformed modules.
+SpirvReflection reflect_spirv(const std::span<const uint32_t> &code);
@@ -0,0 +1,76 @@
+#include "./texture_cache.hpp"
+
+#include <vulkan/vulkan_core.h>
+
+#include <cstdint>
+#include <exception>
+#include <filesystem>
+#include <format>
+#include <memory>
+#include <span>
+#include <system_error>
+#include <utility>
+#include <vector>
+
+#include "vulkan_app/app/cache_files.hpp"
+#include "vulkan_app/app/fnv1a.hpp"
+#include "vulkan_app/app/image_loaders.hpp"
+#include "vulkan_app/app/ktx2.hpp"
+#include "vulkan_app/app/mapped_file.hpp"
+#include "vulkan_app/app/mip_chain.hpp"
+
+namespace {
+std::vector<uint8_t> buildEntry(const std::span<const uint8_t> &source) {
+    const auto &header = read_image_header(source);
+    std::vector<uint8_t> rgba(header.size());
+    decode_image(source, rgba.data(), header.rowPitch());
+    const auto &levels =
+        generate_mip_chain(std::move(rgba), header.width, header.height);
+    KTX2Image image = { .format = VK_FORMAT_R8G8B8A8_SRGB,
+                        .width = header.width,
+                        .height = header.height };
+    for (const auto &level : levels) image.levels.push_back(level.rgba);
+    return write_ktx2(image);
+};
+};  // namespace
+
+TextureCache::TextureCache(const std::filesystem::path &directory)
+    : directory{ directory }, writer(1) {};
+
+std::filesystem::path TextureCache::defaultDirectory() {
+    return cacheDirectory() / "textures";
+};
+
+uint64_t TextureCache::hash(const std::span<const uint8_t> &source) {
+    return fnv1a(fnv1a(fnvOffsetBasis, importSettings), source);
+};
+
+std::filesystem::path TextureCache::entryPath(
+    const std::span<const uint8_t> &source) {
+    return directory / std::format("{:016x}.ktx2", hash(source));
+};
+
+std::span<const uint8_t> TextureCache::resolve(
+    const std::span<const uint8_t> &source) {
+    if (is_ktx2(source)) return source;
+    const auto &path = entryPath(source);
+    std::error_code error;
+    if (std::filesystem::is_regular_file(path, error)) {
+        try {
+            auto mappedFile = std::make_unique<MappedFile>(path);
+            read_ktx2(mappedFile->getBytes());
+            mappedFiles.push_back(std::move(mappedFile));
+            return mappedFiles.back()->getBytes();
+        } catch (const std::exception &) {
+            // A damaged entry is rebuilt below.
+        };
+    };
+    writer.submit([source, path]() {
+        try {
+            writeFileAtomically(path, buildEntry(source));
+        } catch (const std::exception &) {
+            // The cache is an optimization; the next launch retries.
+        };
+    });
+    return source;
+};
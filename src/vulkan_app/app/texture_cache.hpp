@@ -0,0 +1,40 @@
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <span>
+#include <string_view>
+#include <vector>
+
+#include "vulkan_app/app/mapped_file.hpp"
+#include "vulkan_app/app/thread_pool.hpp"
+
+// Persists the GPU-ready form of decoded textures: an sRGB RGBA8 KTX2 with
+// the full mip chain, tightly packed. Entries are named after a hash of the
+// source bytes and the import settings, so any change to either misses the
+// cache instead of serving stale data. Hits are memory-mapped and go
+// through the KTX2 path, skipping decoding and mip generation.
+class TextureCache {
+    std::filesystem::path directory;
+    std::vector<std::unique_ptr<MappedFile>> mappedFiles;
+    ThreadPool writer;
+
+    std::filesystem::path entryPath(const std::span<const uint8_t> &source);
+
+public:
+    // Bump when the stored format or mip generation changes.
+    static constexpr std::string_view importSettings =
+        "rgba8-srgb;box-linear-mips;v1";
+
+    explicit TextureCache(const std::filesystem::path &directory);
+
+    static std::filesystem::path defaultDirectory();
+    static uint64_t hash(const std::span<const uint8_t> &source);
+
+    // Returns the mapped cache entry for a JPEG or PNG source when a
+    // previous launch stored it. Otherwise the entry is built in the
+    // background and the source itself is returned. The source must outlive
+    // the cache, and the returned bytes live as long as the cache.
+    std::span<const uint8_t> resolve(const std::span<const uint8_t> &source);
+};
@@ -0,0 +1,143 @@
+#include "./texture_loader.hpp"
+
+#include <vulkan/vulkan_core.h>
+
+#include <algorithm>
+#include <bit>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <exception>
+#include <future>
+#include <span>
+#include <utility>
+#include <vector>
+
+#include "vulkan_app/app/create_buffers.hpp"
+#include "vulkan_app/app/image_loaders.hpp"
+#include "vulkan_app/app/ktx2.hpp"
+#include "vulkan_app/app/texture_upload.hpp"
+#include "vulkan_app/vki/logical_device.hpp"
+
+namespace {
+// Satisfies the copy offset alignment of every supported block format.
+constexpr VkDeviceSize levelAlignment = 16;
+
+VkBufferImageCopy levelCopy(const VkDeviceSize &offset, const uint32_t &level,
+                            const VkExtent2D &extent) {
+    return { .bufferOffset = offset,
+             .bufferRowLength = 0,
+             .bufferImageHeight = 0,
+             .imageSubresource = { .aspectMask = VK_IMAGE_ASPECT_COLOR_BIT,
+                                   .mipLevel = level,
+                                   .baseArrayLayer = 0,
+                                   .layerCount = 1 },
+             .imageOffset = { 0, 0, 0 },
+             .imageExtent = { .width = std::max(extent.width >> level, 1u),
+                              .height = std::max(extent.height >> level, 1u),
+                              .depth = 1 } };
+};
+
+DecodedTexture stageImage(
+    const vki::LogicalDevice &logicalDevice,
+    const VkPhysicalDeviceMemoryProperties &memoryProperties,
+    const TextureTicket &ticket, const std::span<const uint8_t> &encoded) {
+    const auto &header = read_image_header(encoded);
+    auto [stagingBuffer, mapped] = createMappedStagingBuffer(
+        logicalDevice, memoryProperties, header.size());
+    decode_image(encoded, static_cast<uint8_t *>(mapped), header.rowPitch());
+    const VkExtent2D extent = { .width = header.width,
+                                .height = header.height };
+    return { .ticket = ticket,
+             .upload = { .format = VK_FORMAT_R8G8B8A8_SRGB,
+                         .extent = extent,
+                         .mipLevels = static_cast<uint32_t>(std::bit_width(
+                             std::max(header.width, header.height))),
+                         .regions = { levelCopy(0, 0, extent) } },
+             .stagingBuffer = std::move(stagingBuffer) };
+};
+
+DecodedTexture stageKTX2(
+    const vki::LogicalDevice &logicalDevice,
+    const VkPhysicalDeviceMemoryProperties &memoryProperties,
+    const TextureTicket &ticket, const std::span<const uint8_t> &encoded,
+    const uint32_t &firstLevel, const uint32_t &endLevel) {
+    const auto &image = read_ktx2(encoded);
+    const auto levelCount = static_cast<uint32_t>(image.levels.size());
+    const auto baseLevel = std::min(firstLevel, levelCount - 1);
+    const auto stagedEnd = std::clamp(endLevel, baseLevel + 1, levelCount);
+    const auto levels =
+        std::span(image.levels).subspan(baseLevel, stagedEnd - baseLevel);
+    const VkExtent2D extent = {
+        .width = std::max(image.width >> baseLevel, 1u),
+        .height = std::max(image.height >> baseLevel, 1u)
+    };
+    TextureUpload upload = {
+        .format = image.format,
+        .extent = extent,
+        .mipLevels = levelCount - baseLevel,
+    };
+    VkDeviceSize size = 0;
+    for (uint32_t level = 0; level < levels.size(); level++) {
+        size = (size + levelAlignment - 1) / levelAlignment * levelAlignment;
+        upload.regions.push_back(levelCopy(size, level, extent));
+        size += levels[level].size();
+    };
+    auto [stagingBuffer, mapped] =
+        createMappedStagingBuffer(logicalDevice, memoryProperties, size);
+    for (uint32_t level = 0; level < levels.size(); level++) {
+        std::memcpy(static_cast<uint8_t *>(mapped) +
+                        upload.regions[level].bufferOffset,
+                    levels[level].data(), levels[level].size());
+    };
+    return { .ticket = ticket,
+             .upload = std::move(upload),
+             .stagingBuffer = std::move(stagingBuffer) };
+};
+};  // namespace
+
+TextureLoader::TextureLoader(
+    const vki::LogicalDevice &logicalDevice,
+    const VkPhysicalDeviceMemoryProperties &memoryProperties,
+    const unsigned int &threadCount)
+    : logicalDevice{ logicalDevice },
+      memoryProperties{ memoryProperties },
+      pool(threadCount) {};
+
+TextureTicket TextureLoader::request(const std::span<const uint8_t> &encoded,
+                                     const uint32_t &firstLevel,
+                                     const uint32_t &endLevel) {
+    const auto ticket = nextTicket++;
+    pending.push_back(
+        { .ticket = ticket,
+          .result = pool.submit([this, ticket, encoded, firstLevel,
+                                 endLevel]() {
+              if (is_ktx2(encoded)) {
+                  return stageKTX2(logicalDevice, memoryProperties, ticket,
+                                   encoded, firstLevel, endLevel);
+              };
+              return stageImage(logicalDevice, memoryProperties, ticket,
+                                encoded);
+          }) });
+    return ticket;
+};
+
+CompletedTextures TextureLoader::takeCompleted() {
+    CompletedTextures completed;
+    auto it = pending.begin();
+    while (it != pending.end()) {
+        if (it->result.wait_for(std::chrono::seconds(0)) !=
+            std::future_status::ready) {
+            it++;
+            continue;
+        };
+        try {
+            completed.decoded.push_back(it->result.get());
+        } catch (const std::exception &error) {
+            completed.failed.push_back(
+                { .ticket = it->ticket, .error = error.what() });
+        };
+        it = pending.erase(it);
+    };
+    return completed;
+};
@@ -0,0 +1,71 @@
+#pragma once
+
+#include <vulkan/vulkan_core.h>
+
+#include <cstdint>
+#include <future>
+#include <limits>
+#include <span>
+#include <string>
+#include <vector>
+
+#include "vulkan_app/app/texture_upload.hpp"
+#include "vulkan_app/app/thread_pool.hpp"
+#include "vulkan_app/vki/buffer.hpp"
+#include "vulkan_app/vki/logical_device.hpp"
+
+using TextureTicket = uint32_t;
+
+struct DecodedTexture {
+    TextureTicket ticket;
+    TextureUpload upload;
+    vki::Buffer stagingBuffer;
+};
+
+struct FailedTexture {
+    TextureTicket ticket;
+    std::string error;
+};
+
+struct CompletedTextures {
+    std::vector<DecodedTexture> decoded;
+    std::vector<FailedTexture> failed;
+};
+
+// Decodes JPEG and PNG images on a worker pool straight into mapped staging
+// buffers; KTX2 textures have their requested mip levels copied there
+// instead. Each request returns a ticket that is handed back together with
+// the staging buffer once it is ready, so the render loop can keep drawing
+// with placeholders in the meantime.
+class TextureLoader {
+    struct PendingTexture {
+        TextureTicket ticket;
+        std::future<DecodedTexture> result;
+    };
+
+    const vki::LogicalDevice &logicalDevice;
+    const VkPhysicalDeviceMemoryProperties memoryProperties;
+    ThreadPool pool;
+    std::vector<PendingTexture> pending;
+    TextureTicket nextTicket = 0;
+
+public:
+    explicit TextureLoader(
+        const vki::LogicalDevice &logicalDevice,
+        const VkPhysicalDeviceMemoryProperties &memoryProperties,
+        const unsigned int &threadCount = ThreadPool::defaultThreadCount());
+
+    // The encoded bytes must stay alive until the ticket is completed. KTX2
+    // uploads start at firstLevel, so the image only holds the levels from
+    // there down, of which only those before endLevel are staged; decoded
+    // images always start at full resolution.
+    TextureTicket request(
+        const std::span<const uint8_t> &encoded,
+        const uint32_t &firstLevel = 0,
+        const uint32_t &endLevel = std::numeric_limits<uint32_t>::max());
+    // Returns the decodes finished since the last call without blocking,
+    // with the tickets of those that threw and why.
+    CompletedTextures takeCompleted();
+
+    inline bool isIdle() const { return pending.empty(); };
+};
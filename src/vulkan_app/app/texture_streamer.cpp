@@ -0,0 +1,212 @@
+#include "./texture_streamer.hpp"
+
+#include <vulkan/vulkan_core.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <format>
+#include <limits>
+#include <optional>
+#include <span>
+#include <tuple>
+#include <utility>
+
+#include "easylogging++.h"
+#include "glm/geometric.hpp"
+#include "vulkan_app/app/bindless_textures.hpp"
+#include "vulkan_app/app/create_funcs.hpp"
+#include "vulkan_app/app/data_aggregator.hpp"
+#include "vulkan_app/app/frame_state.hpp"
+#include "vulkan_app/app/ktx2.hpp"
+#include "vulkan_app/app/texture_loader.hpp"
+#include "vulkan_app/app/texture_upload.hpp"
+#include "vulkan_app/vki/buffer.hpp"
+#include "vulkan_app/vki/command_buffer.hpp"
+#include "vulkan_app/vki/logical_device.hpp"
+
+namespace {
+// Coarsest level that still has at least the given resolution.
+uint32_t levelForResolution(const StreamedTexture &texture,
+                            const float &resolution) {
+    uint32_t level = 0;
+    while (level + 1 < texture.levelCount &&
+           (texture.maxDimension >> (level + 1)) >= resolution) {
+        level++;
+    };
+    return level;
+};
+};  // namespace
+
+TextureStreamer::TextureStreamer(
+    const vki::LogicalDevice &logicalDevice,
+    const VkPhysicalDeviceMemoryProperties &memoryProperties)
+    : loader(logicalDevice, memoryProperties) {};
+
+void TextureStreamer::request(const StreamedTextureId &id,
+                              const uint32_t &level) {
+    auto &texture = textures[id];
+    texture.isStreaming = true;
+    // Resident levels are copied over on the device rather than staged.
+    requests.emplace(loader.request(texture.source, level,
+                                    texture.residentLevel),
+                     std::make_pair(id, level));
+};
+
+StreamedTextureId TextureStreamer::add(
+    const std::span<const uint8_t> &source) {
+    StreamedTexture texture = { .source = source,
+                                .maxDimension = 1,
+                                .levelCount = 1,
+                                .isStreaming = false,
+                                .hasFailed = false };
+    if (is_ktx2(source)) {
+        const auto &image = read_ktx2(source);
+        texture.format = image.format;
+        texture.extent = { .width = image.width, .height = image.height };
+        texture.maxDimension = std::max(image.width, image.height);
+        texture.levelCount = image.levels.size();
+    };
+    texture.residentLevel = texture.levelCount;
+    texture.requiredLevel = levelForResolution(texture, initialResolution);
+    const auto id = static_cast<StreamedTextureId>(textures.size());
+    textures.push_back(std::move(texture));
+    request(id, textures.back().requiredLevel);
+    return id;
+};
+
+void TextureStreamer::bindShape(const StreamedTextureId &id,
+                                const uint32_t &shapeIndex) {
+    textures[id].shapes.push_back(shapeIndex);
+    shapeTextures[shapeIndex] = id;
+};
+
+void TextureStreamer::updateResidency(
+    const DataAggregator &dataAggregator,
+    const std::span<const uint32_t> &visibleShapes,
+    const FrameState &frameState, const VkExtent2D &extent) {
+    for (auto &texture : textures) {
+        texture.requiredLevel = levelForResolution(texture, initialResolution);
+    };
+    // Assumes the texture spans its shape once, so the shape's projected
+    // diameter in pixels is the texture resolution worth keeping.
+    const float pixelsPerUnit =
+        std::abs(frameState.projection[1][1]) * extent.height;
+    for (const auto &shapeIndex : visibleShapes) {
+        const auto &it = shapeTextures.find(shapeIndex);
+        if (it == shapeTextures.end()) continue;
+        auto &texture = textures[it->second];
+        const auto &sphere =
+            dataAggregator.shapeBounds.getSphere(shapeIndex);
+        const float distance =
+            glm::distance(sphere.center, frameState.cameraPos);
+        const float resolution =
+            distance > sphere.radius
+                ? sphere.radius / distance * pixelsPerUnit
+                : std::numeric_limits<float>::max();
+        texture.requiredLevel = std::min(
+            texture.requiredLevel, levelForResolution(texture, resolution));
+    };
+};
+
+bool TextureStreamer::update(
+    const vki::LogicalDevice &logicalDevice,
+    const VkPhysicalDeviceMemoryProperties &memoryProperties,
+    el::Logger &logger, BindlessTextures &bindlessTextures,
+    DataAggregator &dataAggregator) {
+    bool hasInstancesChanged = false;
+    const auto &queueUpload = [&](const StreamedTextureId &id,
+                                  const uint32_t &level,
+                                  TextureUpload &&upload,
+                                  std::optional<vki::Buffer> &&staging) {
+        auto &texture = textures[id];
+        texture.isStreaming = true;
+        if (!texture.slot.has_value()) {
+            texture.slot = bindlessTextures.allocateSlot();
+            for (const auto &shapeIndex : texture.shapes) {
+                dataAggregator.setShapeTexture(shapeIndex,
+                                               texture.slot.value());
+            };
+            hasInstancesChanged = true;
+        };
+        auto image =
+            createEmptyTextureImage(logicalDevice, memoryProperties, upload);
+        uploads.push_back({ .id = id,
+                            .level = level,
+                            .upload = std::move(upload),
+                            .stagingBuffer = std::move(staging),
+                            .texture = std::move(image) });
+    };
+    auto [decoded, failed] = loader.takeCompleted();
+    for (const auto &[ticket, error] : failed) {
+        const auto [id, level] = requests.at(ticket);
+        requests.erase(ticket);
+        auto &texture = textures[id];
+        texture.isStreaming = false;
+        texture.hasFailed = true;
+        logger.warn(std::format("Failed to stream texture {} from level {}: {}",
+                                id, level, error));
+    };
+    for (auto &[ticket, upload, stagingBuffer] : decoded) {
+        const auto [id, level] = requests.at(ticket);
+        requests.erase(ticket);
+        const auto extent = upload.extent;
+        queueUpload(id, level, std::move(upload), std::move(stagingBuffer));
+        logger.info(std::format(
+            "Staged texture {} from level {} for slot {} ({}x{})", id,
+            level, textures[id].slot.value(), extent.width, extent.height));
+    };
+    for (StreamedTextureId id = 0; id < textures.size(); id++) {
+        const auto &texture = textures[id];
+        if (texture.isStreaming || texture.hasFailed ||
+            texture.levelCount == 1) {
+            continue;
+        };
+        const uint32_t level = texture.requiredLevel;
+        // Shrinking waits for two spare levels so a texture near a level
+        // boundary is not re-created every few frames.
+        if (level < texture.residentLevel) {
+            request(id, level);
+        } else if (level >= texture.residentLevel + 2) {
+            const VkExtent2D extent = {
+                .width = std::max(texture.extent.width >> level, 1u),
+                .height = std::max(texture.extent.height >> level, 1u)
+            };
+            queueUpload(id, level,
+                        { .format = texture.format,
+                          .extent = extent,
+                          .mipLevels = texture.levelCount - level,
+                          .regions = {} },
+                        std::nullopt);
+        };
+    };
+    return hasInstancesChanged;
+};
+
+void TextureStreamer::recordUploads(const vki::CommandBuffer &commandBuffer,
+                                    BindlessTextures &bindlessTextures) {
+    retiredTextures.clear();
+    retiredBuffers.clear();
+    for (auto &[id, level, upload, stagingBuffer, image] : uploads) {
+        auto &texture = textures[id];
+        const auto &slot = texture.slot.value();
+        if (texture.residentLevel == texture.levelCount) {
+            recordTextureUpload(commandBuffer, std::get<0>(image),
+                                stagingBuffer.value(), upload);
+        } else {
+            recordTextureLevelChange(
+                commandBuffer, bindlessTextures.getImage(slot),
+                texture.residentLevel, std::get<0>(image), level,
+                stagingBuffer, upload);
+        };
+        if (auto previous = bindlessTextures.replace(slot, std::move(image))) {
+            retiredTextures.push_back(std::move(previous.value()));
+        };
+        if (stagingBuffer.has_value()) {
+            retiredBuffers.push_back(std::move(stagingBuffer.value()));
+        };
+        texture.residentLevel = level;
+        texture.isStreaming = false;
+    };
+    uploads.clear();
+};
@@ -0,0 +1,112 @@
+#pragma once
+
+#include <vulkan/vulkan_core.h>
+
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <tuple>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "easylogging++.h"
+#include "vulkan_app/app/bindless_textures.hpp"
+#include "vulkan_app/app/data_aggregator.hpp"
+#include "vulkan_app/app/frame_state.hpp"
+#include "vulkan_app/app/texture_loader.hpp"
+#include "vulkan_app/app/texture_upload.hpp"
+#include "vulkan_app/vki/buffer.hpp"
+#include "vulkan_app/vki/command_buffer.hpp"
+#include "vulkan_app/vki/image.hpp"
+#include "vulkan_app/vki/image_view.hpp"
+#include "vulkan_app/vki/logical_device.hpp"
+
+using StreamedTextureId = uint32_t;
+
+struct StreamedTexture {
+    std::span<const uint8_t> source;
+    // Of the finest level, for KTX2 sources.
+    VkFormat format;
+    VkExtent2D extent;
+    uint32_t maxDimension;
+    uint32_t levelCount;
+    // Finest level of the current image. The image only contains the levels
+    // from here down, which clamps sampling to the resident data.
+    uint32_t residentLevel;
+    uint32_t requiredLevel;
+    std::optional<uint32_t> slot;
+    bool isStreaming;
+    // Set once a request fails, after which the texture keeps whatever it
+    // has resident, or the placeholder.
+    bool hasFailed;
+    std::vector<uint32_t> shapes;
+};
+
+// Streams KTX2 mip chains by residency: textures first arrive with only
+// their low resolution tail, then every frame the visible shapes' screen
+// size decides the finest level each texture needs. Finer levels are staged
+// on the loader's workers and the texture's replacement image is filled by
+// the next frame's command buffer, which copies the levels already resident
+// from the previous image instead of staging them again. Textures that
+// shrink on screen are re-created smaller from their resident levels alone
+// to give memory back. JPEG and PNG sources have no stored mips and are
+// loaded whole.
+class TextureStreamer {
+    // An image waiting for the next frame to fill it and swap it into the
+    // texture's slot.
+    struct PendingUpload {
+        StreamedTextureId id;
+        uint32_t level;
+        TextureUpload upload;
+        // Absent when every level is copied from the previous image.
+        std::optional<vki::Buffer> stagingBuffer;
+        std::tuple<vki::Image, vki::ImageView> texture;
+    };
+
+    TextureLoader loader;
+    std::vector<StreamedTexture> textures;
+    std::unordered_map<uint32_t, StreamedTextureId> shapeTextures;
+    std::unordered_map<TextureTicket, std::pair<StreamedTextureId, uint32_t>>
+        requests;
+    std::vector<PendingUpload> uploads;
+    // Replaced images and spent staging buffers, kept until the fence of the
+    // frame that last used them.
+    std::vector<std::tuple<vki::Image, vki::ImageView>> retiredTextures;
+    std::vector<vki::Buffer> retiredBuffers;
+
+    void request(const StreamedTextureId &id, const uint32_t &level);
+
+public:
+    // Levels larger than this are left out of the first upload.
+    static constexpr uint32_t initialResolution = 64;
+
+    explicit TextureStreamer(
+        const vki::LogicalDevice &logicalDevice,
+        const VkPhysicalDeviceMemoryProperties &memoryProperties);
+
+    // The source bytes must outlive the streamer.
+    StreamedTextureId add(const std::span<const uint8_t> &source);
+    // The shape's instance data is pointed at the texture once it is first
+    // uploaded, and its screen size drives the texture's residency.
+    void bindShape(const StreamedTextureId &id, const uint32_t &shapeIndex);
+
+    void updateResidency(const DataAggregator &dataAggregator,
+                         const std::span<const uint32_t> &visibleShapes,
+                         const FrameState &frameState,
+                         const VkExtent2D &extent);
+
+    // Creates the images of finished requests and of shrinking textures,
+    // and issues new requests. Textures get their slot here, before it is
+    // filled, so that shapes can point at it with the next frame. Returns
+    // whether any shape's instance data changed.
+    bool update(const vki::LogicalDevice &logicalDevice,
+                const VkPhysicalDeviceMemoryProperties &memoryProperties,
+                el::Logger &logger, BindlessTextures &bindlessTextures,
+                DataAggregator &dataAggregator);
+    // Records filling the images created by update and swaps them into
+    // their slots. Must be called once the previous frame's fence has been
+    // waited for, which is also when the images replaced then are released.
+    void recordUploads(const vki::CommandBuffer &commandBuffer,
+                       BindlessTextures &bindlessTextures);
+};
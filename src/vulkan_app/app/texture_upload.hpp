@@ -0,0 +1,17 @@
+#pragma once
+
+#include <vulkan/vulkan_core.h>
+
+#include <cstdint>
+#include <vector>
+
+// Describes how a staging buffer is copied into a sampled image. When the
+// regions only cover the base level of a multi-level image, the rest of the
+// chain is generated with blits, unless it is copied from the image the
+// upload replaces.
+struct TextureUpload {
+    VkFormat format;
+    VkExtent2D extent;
+    uint32_t mipLevels;
+    std::vector<VkBufferImageCopy> regions;
+};
@@ -0,0 +1,45 @@
+#include "./thread_pool.hpp"
+
+#include <algorithm>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <utility>
+
+ThreadPool::ThreadPool(const unsigned int &threadCount) {
+    workers.reserve(threadCount);
+    for (unsigned int i = 0; i < std::max(threadCount, 1u); i++) {
+        workers.emplace_back([this]() { work(); });
+    };
+};
+
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard lock(mutex);
+        isStopping = true;
+    };
+    condition.notify_all();
+    workers.clear();
+};
+
+unsigned int ThreadPool::defaultThreadCount() {
+    // Leave one core to the render loop.
+    return std::max(std::thread::hardware_concurrency(), 2u) - 1;
+};
+
+void ThreadPool::work() {
+    while (true) {
+        std::move_only_function<void()> task;
+        {
+            std::unique_lock lock(mutex);
+            condition.wait(lock,
+                           [this]() { return isStopping || !tasks.empty(); });
+            // Queued tasks are drained before stopping so no future is left
+            // without a value.
+            if (tasks.empty()) return;
+            task = std::move(tasks.front());
+            tasks.pop();
+        };
+        task();
+    };
+};
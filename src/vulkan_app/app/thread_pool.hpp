@@ -0,0 +1,44 @@
+#pragma once
+
+#include <condition_variable>
+#include <functional>
+#include <future>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+class ThreadPool {
+    std::vector<std::jthread> workers;
+    std::queue<std::move_only_function<void()>> tasks;
+    std::mutex mutex;
+    std::condition_variable condition;
+    bool isStopping = false;
+
+    void work();
+
+public:
+    explicit ThreadPool(const unsigned int &threadCount);
+    ThreadPool(const ThreadPool &) = delete;
+    ThreadPool(ThreadPool &&) = delete;
+    ~ThreadPool();
+
+    static unsigned int defaultThreadCount();
+
+    template <typename Task>
+    std::future<std::invoke_result_t<Task>> submit(Task &&task) {
+        std::packaged_task<std::invoke_result_t<Task>()> packagedTask(
+            std::forward<Task>(task));
+        auto future = packagedTask.get_future();
+        {
+            std::lock_guard lock(mutex);
+            tasks.emplace(std::move(packagedTask));
+        };
+        condition.notify_one();
+        return future;
+    };
+
+    inline std::size_t size() const { return workers.size(); };
+};
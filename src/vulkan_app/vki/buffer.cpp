@@ -43,7 +43,7 @@ void vki::Buffer::bindMemory(vki::Memory &&newMemory) {
     vkBindBufferMemory(device, vkBuffer, newMemory.getVkMemory(), 0);
 };
 
-const std::optional<vki::Memory> vki::Buffer::getMemory() const {
+const std::optional<vki::Memory> &vki::Buffer::getMemory() const {
     return memory;
 };
 
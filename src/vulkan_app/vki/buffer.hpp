@@ -2,6 +2,7 @@
 #include <vulkan/vulkan_core.h>
 
 #include <optional>
+#include <type_traits>
 
 #include "vulkan_app/vki/memory.hpp"
 
@@ -21,8 +22,21 @@ public:
                     VkBufferCreateInfo createInfo);
     VkBuffer getVkBuffer() const;
     void bindMemory(vki::Memory &&memory);
-    const std::optional<vki::Memory> getMemory() const;
+    const std::optional<vki::Memory> &getMemory() const;
     VkMemoryRequirements getMemoryRequirements() const;
     ~Buffer();
 };
+
+// A non-owning view of a buffer for passing to commands, which copies only
+// the handle. Valid while the buffer it views is alive.
+class BufferRef {
+    VkBuffer vkBuffer = VK_NULL_HANDLE;
+
+public:
+    BufferRef() = default;
+    BufferRef(const vki::Buffer &buffer) : vkBuffer{ buffer.getVkBuffer() } {};
+    BufferRef(const vki::Buffer &&buffer) = delete;
+    inline VkBuffer getVkBuffer() const { return vkBuffer; };
+};
+static_assert(std::is_trivially_copyable_v<BufferRef>);
 };  // namespace vki
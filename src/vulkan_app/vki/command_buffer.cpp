@@ -2,15 +2,20 @@
 
 #include <vulkan/vulkan_core.h>
 
+#include <cstddef>
+#include <array>
 #include <cstdint>
-#include <functional>
-#include <ranges>
+#include <optional>
+#include <span>
 #include <vector>
 
 #include "vulkan_app/vki/base.hpp"
 #include "vulkan_app/vki/buffer.hpp"
+#include "vulkan_app/vki/compute_pipeline.hpp"
 #include "vulkan_app/vki/graphics_pipeline.hpp"
+#include "vulkan_app/vki/image_view.hpp"
 #include "vulkan_app/vki/pipeline_layout.hpp"
+#include "vulkan_app/vki/query_pool.hpp"
 
 vki::CommandBuffer::CommandBuffer(const VkCommandPool &commandPool,
                                   const VkDevice &logicalDevice) {
@@ -49,12 +54,29 @@ void vki::CommandBuffer::end() const {
     vki::assertSuccess(result, "vkEndCommandBuffer");
 };
 
-void vki::CommandBuffer::beginRenderPass(
-    const vki::RenderPassBeginInfo &renderPassBeginInfo,
-    const vki::SubpassContentsType &subpassContentsType) const {
-    const auto &renderPassInfo = renderPassBeginInfo.toVkBeginInfo();
-    vkCmdBeginRenderPass(vkCommandBuffer, &renderPassInfo,
-                         static_cast<VkSubpassContents>(subpassContentsType));
+void vki::CommandBuffer::beginRendering(
+    const vki::RenderingInfo &renderingInfo) const {
+    std::array<VkRenderingAttachmentInfo, maxColorAttachments>
+        colorAttachments;
+    for (std::size_t i = 0; i < renderingInfo.colorAttachments.size(); i++) {
+        colorAttachments[i] =
+            renderingInfo.colorAttachments[i].toVkAttachmentInfo();
+    };
+    std::optional<VkRenderingAttachmentInfo> depthAttachment;
+    if (renderingInfo.depthAttachment.has_value()) {
+        depthAttachment = renderingInfo.depthAttachment->toVkAttachmentInfo();
+    };
+    VkRenderingInfo vkRenderingInfo = {
+        .sType = VK_STRUCTURE_TYPE_RENDERING_INFO,
+        .renderArea = renderingInfo.renderArea,
+        .layerCount = 1,
+        .colorAttachmentCount =
+            static_cast<uint32_t>(renderingInfo.colorAttachments.size()),
+        .pColorAttachments = colorAttachments.data(),
+        .pDepthAttachment =
+            depthAttachment.has_value() ? &depthAttachment.value() : nullptr,
+    };
+    vkCmdBeginRendering(vkCommandBuffer, &vkRenderingInfo);
 };
 
 void vki::CommandBuffer::bindPipeline(
@@ -64,8 +86,14 @@ void vki::CommandBuffer::bindPipeline(
                       pipeline.getVkPipeline());
 };
 
-void vki::CommandBuffer::endRenderPass() const {
-    vkCmdEndRenderPass(vkCommandBuffer);
+void vki::CommandBuffer::bindPipeline(
+    const vki::ComputePipeline &pipeline) const {
+    vkCmdBindPipeline(vkCommandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE,
+                      pipeline.getVkPipeline());
+};
+
+void vki::CommandBuffer::endRendering() const {
+    vkCmdEndRendering(vkCommandBuffer);
 };
 
 void vki::CommandBuffer::draw(const vki::DrawArgs &args) const {
@@ -78,14 +106,33 @@ void vki::CommandBuffer::drawIndexed(const vki::DrawIndexedArgs &args) const {
                      args.firstIndex, args.vertexOffset, args.firstInstance);
 };
 
+void vki::CommandBuffer::drawIndexedIndirectCount(
+    const vki::DrawIndexedIndirectCountArgs &args) const {
+    vkCmdDrawIndexedIndirectCount(
+        vkCommandBuffer, args.buffer.getVkBuffer(), args.offset,
+        args.countBuffer.getVkBuffer(), args.countBufferOffset,
+        args.maxDrawCount, args.stride);
+};
+
+void vki::CommandBuffer::dispatch(const uint32_t &groupCountX,
+                                  const uint32_t &groupCountY,
+                                  const uint32_t &groupCountZ) const {
+    vkCmdDispatch(vkCommandBuffer, groupCountX, groupCountY, groupCountZ);
+};
+
+void vki::CommandBuffer::fillBuffer(const vki::BufferRef &buffer,
+                                    const VkDeviceSize &offset,
+                                    const VkDeviceSize &size,
+                                    const uint32_t &data) const {
+    vkCmdFillBuffer(vkCommandBuffer, buffer.getVkBuffer(), offset, size, data);
+};
+
 void vki::CommandBuffer::bindVertexBuffers(
     const BindVertexBuffersArgs &args) const {
-    std::vector<VkBuffer> vertexBuffers =
-        args.buffers | std::views::transform([](const vki::Buffer &buffer) {
-            return buffer.getVkBuffer();
-        }) |
-        std::ranges::to<std::vector>();
-    VkDeviceSize offsets[] = { 0 };
+    std::array<VkBuffer, maxVertexBindings> vertexBuffers;
+    for (std::size_t i = 0; i < args.buffers.size(); i++) {
+        vertexBuffers[i] = args.buffers[i].getVkBuffer();
+    };
     vkCmdBindVertexBuffers(vkCommandBuffer, args.firstBinding,
                            args.bindingCount, vertexBuffers.data(),
                            args.offsets.data());
@@ -96,17 +143,25 @@ void vki::CommandBuffer::bindIndexBuffer(
     vkCmdBindIndexBuffer(vkCommandBuffer, args.buffer.getVkBuffer(),
                          args.offset, args.type);
 };
-VkRenderPassBeginInfo vki::RenderPassBeginInfo::toVkBeginInfo() const {
-    return { .sType = VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO,
-             .renderPass = renderPass.getVkRenderPass(),
-             .framebuffer = framebuffer.getVkFramebuffer(),
-             .renderArea = renderArea,
-             .clearValueCount = static_cast<unsigned int>(clearValues.size()),
-             .pClearValues = clearValues.data() };
+
+VkRenderingAttachmentInfo vki::RenderingAttachment::toVkAttachmentInfo()
+    const {
+    const auto &vkResolveImageView = resolveImageView.getVkImageView();
+    return { .sType = VK_STRUCTURE_TYPE_RENDERING_ATTACHMENT_INFO,
+             .imageView = imageView.getVkImageView(),
+             .imageLayout = layout,
+             .resolveMode = vkResolveImageView == VK_NULL_HANDLE
+                                ? VK_RESOLVE_MODE_NONE
+                                : VK_RESOLVE_MODE_AVERAGE_BIT,
+             .resolveImageView = vkResolveImageView,
+             .resolveImageLayout = resolveLayout,
+             .loadOp = loadOp,
+             .storeOp = storeOp,
+             .clearValue = clearValue };
 };
 
 void vki::CommandBuffer::copyBuffer(
-    const vki::Buffer &srcBuffer, const vki::Buffer dstBuffer,
+    const vki::BufferRef &srcBuffer, const vki::BufferRef &dstBuffer,
     const std::vector<VkBufferCopy> &copyRegions) const {
     vkCmdCopyBuffer(vkCommandBuffer, srcBuffer.getVkBuffer(),
                     dstBuffer.getVkBuffer(), copyRegions.size(),
@@ -124,17 +179,60 @@ void vki::CommandBuffer::bindDescriptorSet(
         args.dynamicOffsets.data());
 };
 
-void vki::CommandBuffer::record(const std::function<void()> &func) const {
-    begin();
-    func();
-    end();
+void vki::CommandBuffer::pushConstants(
+    const vki::PipelineLayoutRef &pipelineLayout,
+    const VkShaderStageFlags &stageFlags, const uint32_t &offset,
+    const std::span<const std::byte> &data) const {
+    vkCmdPushConstants(vkCommandBuffer, pipelineLayout.getVkPipelineLayout(),
+                       stageFlags, offset, static_cast<uint32_t>(data.size()),
+                       data.data());
+};
+
+void vki::CommandBuffer::pipelineBarrier(
+    const VkDependencyInfo &dependencyInfo) const {
+    vkCmdPipelineBarrier2(vkCommandBuffer, &dependencyInfo);
+};
+
+void vki::CommandBuffer::memoryBarrier(
+    const VkMemoryBarrier2 &barrier) const {
+    const VkDependencyInfo dependencyInfo = {
+        .sType = VK_STRUCTURE_TYPE_DEPENDENCY_INFO,
+        .memoryBarrierCount = 1,
+        .pMemoryBarriers = &barrier,
+    };
+    vkCmdPipelineBarrier2(vkCommandBuffer, &dependencyInfo);
+};
+
+void vki::CommandBuffer::resetQueryPool(const vki::QueryPool &queryPool,
+                                        const uint32_t &firstQuery,
+                                        const uint32_t &queryCount) const {
+    vkCmdResetQueryPool(vkCommandBuffer, queryPool.getVkQueryPool(),
+                        firstQuery, queryCount);
+};
+
+void vki::CommandBuffer::writeTimestamp(const VkPipelineStageFlags2 &stage,
+                                        const vki::QueryPool &queryPool,
+                                        const uint32_t &query) const {
+    vkCmdWriteTimestamp2(vkCommandBuffer, stage, queryPool.getVkQueryPool(),
+                         query);
+};
+
+void vki::CommandBuffer::setViewport(const VkViewport &viewport) const {
+    vkCmdSetViewport(vkCommandBuffer, 0, 1, &viewport);
+};
+
+void vki::CommandBuffer::setScissor(const VkRect2D &scissor) const {
+    vkCmdSetScissor(vkCommandBuffer, 0, 1, &scissor);
+};
+
+void vki::CommandBuffer::setCullMode(const VkCullModeFlags &cullMode) const {
+    vkCmdSetCullMode(vkCommandBuffer, cullMode);
+};
+
+void vki::CommandBuffer::setDepthTestEnable(const bool &isEnabled) const {
+    vkCmdSetDepthTestEnable(vkCommandBuffer, isEnabled);
 };
 
-void vki::CommandBuffer::withRenderPass(
-    const vki::RenderPassBeginInfo &renderPassBeginInfo,
-    const vki::SubpassContentsType &subpassContentsType,
-    const std::function<void()> &func) const {
-    beginRenderPass(renderPassBeginInfo, subpassContentsType);
-    func();
-    endRenderPass();
+void vki::CommandBuffer::setDepthWriteEnable(const bool &isEnabled) const {
+    vkCmdSetDepthWriteEnable(vkCommandBuffer, isEnabled);
 };
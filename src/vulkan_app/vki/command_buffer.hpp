@@ -2,28 +2,35 @@
 
 #include <vulkan/vulkan_core.h>
 
+#include <cstddef>
 #include <cstdint>
-#include <functional>
+#include <optional>
+#include <span>
 #include <vector>
 
 #include "vulkan_app/vki/buffer.hpp"
-#include "vulkan_app/vki/framebuffer.hpp"
+#include "vulkan_app/vki/compute_pipeline.hpp"
 #include "vulkan_app/vki/graphics_pipeline.hpp"
+#include "vulkan_app/vki/image_view.hpp"
 #include "vulkan_app/vki/pipeline_layout.hpp"
-#include "vulkan_app/vki/render_pass.hpp"
+#include "vulkan_app/vki/query_pool.hpp"
+#include "vulkan_app/vki/static_vector.hpp"
 
 namespace vki {
+// Capacities of the arrays in the argument structs, which are stored inline
+// so that recording does not allocate. Vulkan guarantees at least four
+// color attachments and bound descriptor sets, and sixteen vertex bindings.
+inline constexpr std::size_t maxColorAttachments = 8;
+inline constexpr std::size_t maxVertexBindings = 16;
+inline constexpr std::size_t maxBoundDescriptorSets = 8;
+inline constexpr std::size_t maxDynamicOffsets = 8;
+
 enum class CommandBufferUsage {
     ONE_TIME_SUBMIT = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT,
     RENDER_PASS_CONTINUE = VK_COMMAND_BUFFER_USAGE_RENDER_PASS_CONTINUE_BIT,
     SIMULTANEOUS_USE = VK_COMMAND_BUFFER_USAGE_SIMULTANEOUS_USE_BIT,
 };
 
-enum class SubpassContentsType {
-    INLINE = VK_SUBPASS_CONTENTS_INLINE,
-    SECONDARY_COMMAND_BUFFERS = VK_SUBPASS_CONTENTS_SECONDARY_COMMAND_BUFFERS,
-};
-
 enum class PipelineBindPointType {
     GRAPHICS = VK_PIPELINE_BIND_POINT_GRAPHICS,
     COMPUTE = VK_PIPELINE_BIND_POINT_COMPUTE,
@@ -31,12 +38,25 @@ enum class PipelineBindPointType {
     SUBPASS_SHADING_HUAWEI = VK_PIPELINE_BIND_POINT_SUBPASS_SHADING_HUAWEI,
 };
 
-struct RenderPassBeginInfo {
-    vki::RenderPass renderPass;
-    vki::Framebuffer framebuffer;
-    std::vector<VkClearValue> clearValues;
+struct RenderingAttachment {
+    vki::ImageViewRef imageView;
+    VkImageLayout layout;
+    VkAttachmentLoadOp loadOp;
+    VkAttachmentStoreOp storeOp;
+    VkClearValue clearValue = {};
+    // If set, the multisampled contents are averaged into this view when
+    // rendering ends.
+    vki::ImageViewRef resolveImageView = {};
+    VkImageLayout resolveLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+
+    VkRenderingAttachmentInfo toVkAttachmentInfo() const;
+};
+
+struct RenderingInfo {
     VkRect2D renderArea;
-    VkRenderPassBeginInfo toVkBeginInfo() const;
+    StaticVector<vki::RenderingAttachment, maxColorAttachments>
+        colorAttachments;
+    std::optional<vki::RenderingAttachment> depthAttachment;
 };
 
 struct DrawArgs {
@@ -54,25 +74,36 @@ struct DrawIndexedArgs {
     uint32_t firstInstance;
 };
 
+// Draws the first count entries of the buffer's commands, with the count
+// read from countBuffer when the commands execute.
+struct DrawIndexedIndirectCountArgs {
+    vki::BufferRef buffer;
+    VkDeviceSize offset;
+    vki::BufferRef countBuffer;
+    VkDeviceSize countBufferOffset;
+    uint32_t maxDrawCount;
+    uint32_t stride = sizeof(VkDrawIndexedIndirectCommand);
+};
+
 struct BindVertexBuffersArgs {
     unsigned int firstBinding;
     unsigned int bindingCount;
-    std::vector<vki::Buffer> buffers;
-    std::vector<VkDeviceSize> offsets;
+    StaticVector<vki::BufferRef, maxVertexBindings> buffers;
+    StaticVector<VkDeviceSize, maxVertexBindings> offsets;
 };
 
 struct BindIndexBufferArgs {
-    vki::Buffer buffer;
+    vki::BufferRef buffer;
     VkDeviceSize offset;
     VkIndexType type;
 };
 
 struct BindDescriptorSetsArgs {
     vki::PipelineBindPointType bindPointType;
-    vki::PipelineLayout pipelineLayout;
+    vki::PipelineLayoutRef pipelineLayout;
     unsigned int firstSet;
-    std::vector<VkDescriptorSet> descriptorSets;
-    std::vector<unsigned int> dynamicOffsets;
+    StaticVector<VkDescriptorSet, maxBoundDescriptorSets> descriptorSets;
+    StaticVector<unsigned int, maxDynamicOffsets> dynamicOffsets;
 };
 
 class CommandBuffer {
@@ -87,24 +118,57 @@ public:
     void reset() const;
     void begin(const CommandBufferUsage &usage =
                    CommandBufferUsage::ONE_TIME_SUBMIT) const;
-    void copyBuffer(const vki::Buffer &srcBuffer, const vki::Buffer dstBuffer,
+    void copyBuffer(const vki::BufferRef &srcBuffer,
+                    const vki::BufferRef &dstBuffer,
                     const std::vector<VkBufferCopy> &copyRegions) const;
     void end() const;
-    void beginRenderPass(
-        const vki::RenderPassBeginInfo &renderPassBeginInfo,
-        const vki::SubpassContentsType &subpassContentsType) const;
+    void beginRendering(const vki::RenderingInfo &renderingInfo) const;
     void bindPipeline(
         const vki::GraphicsPipeline &pipeline,
         const vki::PipelineBindPointType &pipelineBindPointType) const;
-    void endRenderPass() const;
+    void bindPipeline(const vki::ComputePipeline &pipeline) const;
+    void endRendering() const;
     void draw(const vki::DrawArgs &args) const;
     void drawIndexed(const vki::DrawIndexedArgs &args) const;
+    void drawIndexedIndirectCount(
+        const vki::DrawIndexedIndirectCountArgs &args) const;
+    void dispatch(const uint32_t &groupCountX, const uint32_t &groupCountY,
+                  const uint32_t &groupCountZ) const;
+    void fillBuffer(const vki::BufferRef &buffer, const VkDeviceSize &offset,
+                    const VkDeviceSize &size, const uint32_t &data) const;
     void bindVertexBuffers(const vki::BindVertexBuffersArgs &args) const;
     void bindIndexBuffer(const vki::BindIndexBufferArgs &args) const;
     void bindDescriptorSet(const vki::BindDescriptorSetsArgs &args) const;
-    void record(const std::function<void()> &func) const;
-    void withRenderPass(const vki::RenderPassBeginInfo &renderPassBeginInfo,
-                        const vki::SubpassContentsType &subpassContentsType,
-                        const std::function<void()> &func) const;
+    void pushConstants(const vki::PipelineLayoutRef &pipelineLayout,
+                       const VkShaderStageFlags &stageFlags,
+                       const uint32_t &offset,
+                       const std::span<const std::byte> &data) const;
+    void pipelineBarrier(const VkDependencyInfo &dependencyInfo) const;
+    // A barrier over all memory, for resources without layouts.
+    void memoryBarrier(const VkMemoryBarrier2 &barrier) const;
+    void resetQueryPool(const vki::QueryPool &queryPool,
+                        const uint32_t &firstQuery,
+                        const uint32_t &queryCount) const;
+    void writeTimestamp(const VkPipelineStageFlags2 &stage,
+                        const vki::QueryPool &queryPool,
+                        const uint32_t &query) const;
+    void setViewport(const VkViewport &viewport) const;
+    void setScissor(const VkRect2D &scissor) const;
+    void setCullMode(const VkCullModeFlags &cullMode) const;
+    void setDepthTestEnable(const bool &isEnabled) const;
+    void setDepthWriteEnable(const bool &isEnabled) const;
+    template <typename Func>
+    void record(Func &&func) const {
+        begin();
+        func();
+        end();
+    };
+    template <typename Func>
+    void withRendering(const vki::RenderingInfo &renderingInfo,
+                       Func &&func) const {
+        beginRendering(renderingInfo);
+        func();
+        endRendering();
+    };
 };
 };  // namespace vki
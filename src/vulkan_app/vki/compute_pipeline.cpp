@@ -0,0 +1,33 @@
+#include "./compute_pipeline.hpp"
+
+#include <vulkan/vulkan_core.h>
+
+#include "vulkan_app/vki/base.hpp"
+#include "vulkan_app/vki/logical_device.hpp"
+#include "vulkan_app/vki/pipeline_cache.hpp"
+
+vki::ComputePipeline::ComputePipeline(
+    const vki::LogicalDevice &logicalDevice,
+    const VkComputePipelineCreateInfo &createInfo,
+    const vki::PipelineCache &pipelineCache)
+    : device{ logicalDevice.getVkDevice() }, is_owner{ true } {
+    VkResult result = vkCreateComputePipelines(
+        logicalDevice.getVkDevice(), pipelineCache.getVkPipelineCache(), 1,
+        &createInfo, nullptr, &vkPipeline);
+    vki::assertSuccess(result, "vkCreateComputePipelines");
+};
+
+vki::ComputePipeline::ComputePipeline(vki::ComputePipeline &&other)
+    : vkPipeline{ other.vkPipeline },
+      device{ other.device },
+      is_owner{ other.is_owner } {
+    other.is_owner = false;
+};
+
+VkPipeline vki::ComputePipeline::getVkPipeline() const { return vkPipeline; };
+
+vki::ComputePipeline::~ComputePipeline() {
+    if (is_owner) {
+        vkDestroyPipeline(device, vkPipeline, nullptr);
+    };
+};
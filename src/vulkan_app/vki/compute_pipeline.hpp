@@ -0,0 +1,25 @@
+#pragma once
+
+#include <vulkan/vulkan_core.h>
+
+#include "vulkan_app/vki/pipeline_cache.hpp"
+
+namespace vki {
+class LogicalDevice;
+class ComputePipeline {
+    VkPipeline vkPipeline;
+    VkDevice device;
+
+protected:
+    bool is_owner;
+
+public:
+    explicit ComputePipeline(const vki::LogicalDevice &logicalDevice,
+                             const VkComputePipelineCreateInfo &createInfo,
+                             const vki::PipelineCache &pipelineCache);
+    ComputePipeline(const ComputePipeline &other) = delete;
+    ComputePipeline(ComputePipeline &&other);
+    VkPipeline getVkPipeline() const;
+    ~ComputePipeline();
+};
+};  // namespace vki
@@ -2,6 +2,8 @@
 
 #include <vulkan/vulkan_core.h>
 
+#include <optional>
+
 #include "vulkan_app/vki/base.hpp"
 #include "vulkan_app/vki/logical_device.hpp"
 
@@ -24,3 +26,27 @@ vki::DescriptorPool::~DescriptorPool() {
         vkDestroyDescriptorPool(device, vkDescriptorPool, nullptr);
     };
 };
+
+std::optional<VkDescriptorSet> vki::DescriptorPool::tryAllocate(
+    const VkDescriptorSetLayout &setLayout) const {
+    VkDescriptorSetAllocateInfo allocInfo = {
+        .sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO,
+        .descriptorPool = vkDescriptorPool,
+        .descriptorSetCount = 1,
+        .pSetLayouts = &setLayout
+    };
+    VkDescriptorSet descriptorSet;
+    VkResult result =
+        vkAllocateDescriptorSets(device, &allocInfo, &descriptorSet);
+    if (result == VK_ERROR_OUT_OF_POOL_MEMORY ||
+        result == VK_ERROR_FRAGMENTED_POOL) {
+        return std::nullopt;
+    };
+    vki::assertSuccess(result, "vkAllocateDescriptorSets");
+    return descriptorSet;
+};
+
+void vki::DescriptorPool::reset() const {
+    VkResult result = vkResetDescriptorPool(device, vkDescriptorPool, 0);
+    vki::assertSuccess(result, "vkResetDescriptorPool");
+};
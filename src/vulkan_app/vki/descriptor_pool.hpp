@@ -2,6 +2,8 @@
 
 #include <vulkan/vulkan_core.h>
 
+#include <optional>
+
 #include "vulkan_app/vki/logical_device.hpp"
 namespace vki {
 class DescriptorPool {
@@ -19,5 +21,11 @@ public:
         return vkDescriptorPool;
     };
     ~DescriptorPool();
+
+    // Returns nothing if the pool has run out of space for the set.
+    std::optional<VkDescriptorSet> tryAllocate(
+        const VkDescriptorSetLayout &setLayout) const;
+    // Frees every set allocated from the pool at once.
+    void reset() const;
 };
 };  // namespace vki
@@ -0,0 +1,82 @@
+#include "./descriptor_update_template.hpp"
+
+#include <vulkan/vulkan_core.h>
+
+#include <cstdint>
+#include <span>
+#include <stdexcept>
+
+#include "vulkan_app/vki/base.hpp"
+#include "vulkan_app/vki/command_buffer.hpp"
+#include "vulkan_app/vki/descriptor_set_layout.hpp"
+#include "vulkan_app/vki/logical_device.hpp"
+#include "vulkan_app/vki/pipeline_layout.hpp"
+
+vki::DescriptorUpdateTemplate::DescriptorUpdateTemplate(
+    const vki::LogicalDevice &logicalDevice,
+    const vki::DescriptorSetLayout &setLayout,
+    const std::span<const VkDescriptorUpdateTemplateEntry> &entries)
+    : device{ logicalDevice.getVkDevice() },
+      pipelineLayout{ VK_NULL_HANDLE },
+      set{ 0 },
+      cmdPushDescriptorSet{ nullptr } {
+    init({
+        .sType = VK_STRUCTURE_TYPE_DESCRIPTOR_UPDATE_TEMPLATE_CREATE_INFO,
+        .descriptorUpdateEntryCount = static_cast<uint32_t>(entries.size()),
+        .pDescriptorUpdateEntries = entries.data(),
+        .templateType = VK_DESCRIPTOR_UPDATE_TEMPLATE_TYPE_DESCRIPTOR_SET,
+        .descriptorSetLayout = setLayout.getVkDescriptorSetLayout(),
+    });
+};
+
+vki::DescriptorUpdateTemplate::DescriptorUpdateTemplate(
+    const vki::LogicalDevice &logicalDevice,
+    const vki::DescriptorSetLayout &setLayout,
+    const std::span<const VkDescriptorUpdateTemplateEntry> &entries,
+    const vki::PipelineLayout &pipelineLayout, const uint32_t &set)
+    : device{ logicalDevice.getVkDevice() },
+      pipelineLayout{ pipelineLayout.getVkPipelineLayout() },
+      set{ set } {
+    cmdPushDescriptorSet =
+        reinterpret_cast<PFN_vkCmdPushDescriptorSetWithTemplateKHR>(
+            vkGetDeviceProcAddr(device,
+                                "vkCmdPushDescriptorSetWithTemplateKHR"));
+    if (cmdPushDescriptorSet == nullptr) {
+        throw std::runtime_error("VK_KHR_push_descriptor is not enabled");
+    };
+    init({
+        .sType = VK_STRUCTURE_TYPE_DESCRIPTOR_UPDATE_TEMPLATE_CREATE_INFO,
+        .descriptorUpdateEntryCount = static_cast<uint32_t>(entries.size()),
+        .pDescriptorUpdateEntries = entries.data(),
+        .templateType = VK_DESCRIPTOR_UPDATE_TEMPLATE_TYPE_PUSH_DESCRIPTORS_KHR,
+        .descriptorSetLayout = setLayout.getVkDescriptorSetLayout(),
+        .pipelineBindPoint = VK_PIPELINE_BIND_POINT_GRAPHICS,
+        .pipelineLayout = this->pipelineLayout,
+        .set = set,
+    });
+};
+
+void vki::DescriptorUpdateTemplate::init(
+    const VkDescriptorUpdateTemplateCreateInfo &createInfo) {
+    VkResult result = vkCreateDescriptorUpdateTemplate(
+        device, &createInfo, nullptr, &vkDescriptorUpdateTemplate);
+    vki::assertSuccess(result, "vkCreateDescriptorUpdateTemplate");
+};
+
+vki::DescriptorUpdateTemplate::~DescriptorUpdateTemplate() {
+    vkDestroyDescriptorUpdateTemplate(device, vkDescriptorUpdateTemplate,
+                                      nullptr);
+};
+
+void vki::DescriptorUpdateTemplate::update(
+    const VkDescriptorSet &descriptorSet, const void *data) const {
+    vkUpdateDescriptorSetWithTemplate(device, descriptorSet,
+                                      vkDescriptorUpdateTemplate, data);
+};
+
+void vki::DescriptorUpdateTemplate::push(
+    const vki::CommandBuffer &commandBuffer, const void *data) const {
+    cmdPushDescriptorSet(commandBuffer.getVkCommandBuffer(),
+                         vkDescriptorUpdateTemplate, pipelineLayout, set,
+                         data);
+};
@@ -0,0 +1,49 @@
+#pragma once
+
+#include <vulkan/vulkan_core.h>
+
+#include <cstdint>
+#include <span>
+
+#include "vulkan_app/vki/command_buffer.hpp"
+#include "vulkan_app/vki/descriptor_set_layout.hpp"
+#include "vulkan_app/vki/pipeline_layout.hpp"
+
+namespace vki {
+class LogicalDevice;
+// Writes all of a set's descriptors from one struct in a single call,
+// without building VkWriteDescriptorSet arrays.
+class DescriptorUpdateTemplate {
+    VkDescriptorUpdateTemplate vkDescriptorUpdateTemplate;
+    VkDevice device;
+    VkPipelineLayout pipelineLayout;
+    uint32_t set;
+    PFN_vkCmdPushDescriptorSetWithTemplateKHR cmdPushDescriptorSet;
+
+    void init(const VkDescriptorUpdateTemplateCreateInfo &createInfo);
+
+public:
+    // For updating allocated sets.
+    explicit DescriptorUpdateTemplate(
+        const vki::LogicalDevice &logicalDevice,
+        const vki::DescriptorSetLayout &setLayout,
+        const std::span<const VkDescriptorUpdateTemplateEntry> &entries);
+    // For pushing the given set of a push descriptor layout; needs
+    // VK_KHR_push_descriptor.
+    explicit DescriptorUpdateTemplate(
+        const vki::LogicalDevice &logicalDevice,
+        const vki::DescriptorSetLayout &setLayout,
+        const std::span<const VkDescriptorUpdateTemplateEntry> &entries,
+        const vki::PipelineLayout &pipelineLayout, const uint32_t &set);
+    DescriptorUpdateTemplate(const DescriptorUpdateTemplate &other) = delete;
+    DescriptorUpdateTemplate &operator=(
+        const DescriptorUpdateTemplate &other) = delete;
+    ~DescriptorUpdateTemplate();
+
+    // Data is read at the offsets and strides of the template's entries.
+    void update(const VkDescriptorSet &descriptorSet,
+                const void *data) const;
+    void push(const vki::CommandBuffer &commandBuffer,
+              const void *data) const;
+};
+};  // namespace vki
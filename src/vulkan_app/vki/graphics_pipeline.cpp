@@ -4,22 +4,32 @@
 
 #include "vulkan_app/vki/base.hpp"
 #include "vulkan_app/vki/logical_device.hpp"
+#include "vulkan_app/vki/pipeline_cache.hpp"
 #include "vulkan_app/vki/pipeline_layout.hpp"
-#include "vulkan_app/vki/render_pass.hpp"
 #include "vulkan_app/vki/shader_module.hpp"
 
 vki::GraphicsPipeline::GraphicsPipeline(
     const vki::LogicalDevice &logicalDevice,
-    const VkGraphicsPipelineCreateInfo &createInfo)
-    : device{ logicalDevice.getVkDevice() } {
-    VkResult result =
-        vkCreateGraphicsPipelines(logicalDevice.getVkDevice(), VK_NULL_HANDLE,
-                                  1, &createInfo, nullptr, &vkPipeline);
+    const VkGraphicsPipelineCreateInfo &createInfo,
+    const vki::PipelineCache &pipelineCache)
+    : device{ logicalDevice.getVkDevice() }, is_owner{ true } {
+    VkResult result = vkCreateGraphicsPipelines(
+        logicalDevice.getVkDevice(), pipelineCache.getVkPipelineCache(), 1,
+        &createInfo, nullptr, &vkPipeline);
     vki::assertSuccess(result, "vkCreateGraphicsPipelines");
 };
 
+vki::GraphicsPipeline::GraphicsPipeline(vki::GraphicsPipeline &&other)
+    : vkPipeline{ other.vkPipeline },
+      device{ other.device },
+      is_owner{ other.is_owner } {
+    other.is_owner = false;
+};
+
 VkPipeline vki::GraphicsPipeline::getVkPipeline() const { return vkPipeline; };
 
 vki::GraphicsPipeline::~GraphicsPipeline() {
-    vkDestroyPipeline(device, vkPipeline, nullptr);
+    if (is_owner) {
+        vkDestroyPipeline(device, vkPipeline, nullptr);
+    };
 };
@@ -2,8 +2,8 @@
 
 #include <vulkan/vulkan_core.h>
 
+#include "vulkan_app/vki/pipeline_cache.hpp"
 #include "vulkan_app/vki/pipeline_layout.hpp"
-#include "vulkan_app/vki/render_pass.hpp"
 #include "vulkan_app/vki/shader_module.hpp"
 
 namespace vki {
@@ -12,10 +12,16 @@ class GraphicsPipeline {
     VkPipeline vkPipeline;
     VkDevice device;
 
+protected:
+    bool is_owner;
+
 public:
     explicit GraphicsPipeline(
         const vki::LogicalDevice &logicalDevice,
-        const VkGraphicsPipelineCreateInfo& createInfo);
+        const VkGraphicsPipelineCreateInfo& createInfo,
+        const vki::PipelineCache &pipelineCache);
+    GraphicsPipeline(const GraphicsPipeline &other) = delete;
+    GraphicsPipeline(GraphicsPipeline &&other);
     VkPipeline getVkPipeline() const;
     ~GraphicsPipeline();
 };
@@ -36,6 +36,13 @@ void vki::Image::bindMemory(vki::Memory &&newMemory) {
     memory.emplace(newMemory);
 };
 
+void vki::Image::bindMemory(const vki::Memory &sharedMemory,
+                            const VkDeviceSize &offset) {
+    VkResult result =
+        vkBindImageMemory(device, image, sharedMemory.getVkMemory(), offset);
+    vki::assertSuccess(result, "vkBindImageMemory");
+};
+
 vki::Image::~Image() {
     if (is_owner) {
         vkDestroyImage(device, image, nullptr);
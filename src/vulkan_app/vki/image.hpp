@@ -2,6 +2,7 @@
 
 #include <vulkan/vulkan_core.h>
 #include <optional>
+#include <type_traits>
 
 #include "vulkan_app/vki/logical_device.hpp"
 #include "vulkan_app/vki/memory.hpp"
@@ -20,6 +21,24 @@ public:
     inline const VkImage getVkImage() const { return image; };
     VkMemoryRequirements getMemoryRequirements() const;
     void bindMemory(vki::Memory&& memory);
+    // Binds memory the image does not own, such as an allocation shared by
+    // images that alias each other.
+    void bindMemory(const vki::Memory &memory, const VkDeviceSize &offset);
     ~Image();
 };
+
+// A non-owning view of an image, which copies only the handle. Images the
+// application does not own, such as the swapchain's, are viewed through
+// their handles.
+class ImageRef {
+    VkImage image = VK_NULL_HANDLE;
+
+public:
+    ImageRef() = default;
+    ImageRef(const vki::Image &image) : image{ image.getVkImage() } {};
+    ImageRef(const vki::Image &&image) = delete;
+    explicit ImageRef(const VkImage &image) : image{ image } {};
+    inline VkImage getVkImage() const { return image; };
+};
+static_assert(std::is_trivially_copyable_v<ImageRef>);
 };  // namespace vki
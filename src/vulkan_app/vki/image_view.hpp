@@ -2,6 +2,8 @@
 
 #include <vulkan/vulkan_core.h>
 
+#include <type_traits>
+
 namespace vki {
 class LogicalDevice;
 class ImageView {
@@ -18,4 +20,17 @@ public:
     inline const VkImageView getVkImageView() const { return imageView; };
     ~ImageView();
 };
+
+// A non-owning view of an image view, which copies only the handle.
+class ImageViewRef {
+    VkImageView imageView = VK_NULL_HANDLE;
+
+public:
+    ImageViewRef() = default;
+    ImageViewRef(const vki::ImageView &imageView)
+        : imageView{ imageView.getVkImageView() } {};
+    ImageViewRef(const vki::ImageView &&imageView) = delete;
+    inline VkImageView getVkImageView() const { return imageView; };
+};
+static_assert(std::is_trivially_copyable_v<ImageViewRef>);
 };  // namespace vki
@@ -2,6 +2,7 @@
 
 #include <vulkan/vulkan_core.h>
 
+#include <cstring>
 #include <vector>
 
 #include "vulkan_app/vki/base.hpp"
@@ -14,12 +15,45 @@ void vki::LogicalDevice::init(
     std::vector<const char *> deviceExtensions;
     deviceExtensions.push_back("VK_KHR_portability_subset");
     deviceExtensions.push_back(VK_KHR_SWAPCHAIN_EXTENSION_NAME);
+    isPushDescriptorEnabled = physicalDevice.hasExtensions(
+        { [](const VkExtensionProperties &extension) {
+            return std::strcmp(extension.extensionName,
+                               VK_KHR_PUSH_DESCRIPTOR_EXTENSION_NAME) == 0;
+        } });
+    if (isPushDescriptorEnabled) {
+        deviceExtensions.push_back(VK_KHR_PUSH_DESCRIPTOR_EXTENSION_NAME);
+    };
+
+    VkPhysicalDeviceVulkan13Features vulkan13Features = {
+        .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_3_FEATURES,
+        // Barriers are recorded with vkCmdPipelineBarrier2.
+        .synchronization2 = VK_TRUE,
+        // Passes render without render pass or framebuffer objects.
+        .dynamicRendering = VK_TRUE,
+    };
+    VkPhysicalDeviceVulkan12Features vulkan12Features = {
+        .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_2_FEATURES,
+        .pNext = &vulkan13Features,
+        // Occlusion culling writes the draw counts on the device.
+        .drawIndirectCount = VK_TRUE,
+        // The bindless texture array is written while frames use it, only
+        // partly filled, and sized at runtime.
+        .descriptorBindingSampledImageUpdateAfterBind = VK_TRUE,
+        .descriptorBindingPartiallyBound = VK_TRUE,
+        .runtimeDescriptorArray = VK_TRUE,
+    };
+    VkPhysicalDeviceFeatures2 features2 = {
+        .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2,
+        .pNext = &vulkan12Features,
+        .features = features,
+    };
 
     VkDeviceCreateInfo createInfo{};
     createInfo.sType = VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO;
+    createInfo.pNext = &features2;
     createInfo.queueCreateInfoCount = queueCreateInfoArray.size();
     createInfo.pQueueCreateInfos = queueCreateInfoArray.data();
-    createInfo.pEnabledFeatures = &features;
+    createInfo.pEnabledFeatures = nullptr;
     createInfo.enabledExtensionCount = deviceExtensions.size();
     createInfo.ppEnabledExtensionNames = deviceExtensions.data();
 
@@ -35,6 +69,7 @@ vki::LogicalDevice::~LogicalDevice() { vkDestroyDevice(device, nullptr); };
 
 vki::LogicalDevice::LogicalDevice(vki::LogicalDevice &&other) {
     device = other.device;
+    isPushDescriptorEnabled = other.isPushDescriptorEnabled;
 };
 
 const VkDevice vki::LogicalDevice::getVkDevice() const noexcept {
@@ -13,6 +13,7 @@
 namespace vki {
 class LogicalDevice {
     VkDevice device;
+    bool isPushDescriptorEnabled;
     LogicalDevice(const LogicalDevice &other) = delete;
     void init(const vki::PhysicalDevice &physicalDevice,
               const VkPhysicalDeviceFeatures &features,
@@ -52,6 +53,10 @@ public:
     LogicalDevice(LogicalDevice &&other);
     const VkDevice getVkDevice() const noexcept;
     void waitIdle() const;
+    // VK_KHR_push_descriptor is enabled whenever the device supports it.
+    inline bool supportsPushDescriptor() const {
+        return isPushDescriptorEnabled;
+    };
     std::vector<VkDescriptorSet> allocateDescriptorSets(
         const VkDescriptorSetAllocateInfo &allocInfo) const;
     void updateWriteDescriptorSets(
@@ -135,3 +135,16 @@ VkPhysicalDeviceFeatures vki::PhysicalDevice::getFeatures() const {
     return features;
 };
 
+VkPhysicalDeviceVulkan12Features vki::PhysicalDevice::getVulkan12Features()
+    const {
+    VkPhysicalDeviceVulkan12Features vulkan12Features = {
+        .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_2_FEATURES,
+    };
+    VkPhysicalDeviceFeatures2 features = {
+        .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2,
+        .pNext = &vulkan12Features,
+    };
+    vkGetPhysicalDeviceFeatures2(device, &features);
+    vulkan12Features.pNext = nullptr;
+    return vulkan12Features;
+};
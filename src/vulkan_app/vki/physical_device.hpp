@@ -33,6 +33,7 @@ public:
 
     VkPhysicalDeviceMemoryProperties getMemoryProperties() const;
     VkPhysicalDeviceFeatures getFeatures() const;
+    VkPhysicalDeviceVulkan12Features getVulkan12Features() const;
 
     PRINTABLE_DEFINITIONS(PhysicalDevice)
 };
@@ -0,0 +1,76 @@
+#include "./pipeline_cache.hpp"
+
+#include <vulkan/vulkan_core.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <iterator>
+#include <span>
+#include <vector>
+
+#include "vulkan_app/vki/base.hpp"
+#include "vulkan_app/vki/logical_device.hpp"
+#include "vulkan_app/vki/physical_device.hpp"
+
+vki::PipelineCache::PipelineCache(const vki::LogicalDevice &logicalDevice,
+                                  const vki::PhysicalDevice &physicalDevice,
+                                  const std::span<const uint8_t> &initialData)
+    : device{ logicalDevice.getVkDevice() } {
+    const bool &isUsable = isCompatible(physicalDevice, initialData);
+    VkPipelineCacheCreateInfo createInfo = {
+        .sType = VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO,
+        .initialDataSize = isUsable ? initialData.size() : 0,
+        .pInitialData = isUsable ? initialData.data() : nullptr,
+    };
+    VkResult result =
+        vkCreatePipelineCache(device, &createInfo, nullptr, &vkPipelineCache);
+    vki::assertSuccess(result, "vkCreatePipelineCache");
+};
+
+vki::PipelineCache::~PipelineCache() {
+    vkDestroyPipelineCache(device, vkPipelineCache, nullptr);
+};
+
+bool vki::PipelineCache::isCompatible(
+    const vki::PhysicalDevice &physicalDevice,
+    const std::span<const uint8_t> &data) {
+    VkPipelineCacheHeaderVersionOne header;
+    if (data.size() < sizeof(header)) return false;
+    std::memcpy(&header, data.data(), sizeof(header));
+    const auto &properties = physicalDevice.properties;
+    return header.headerSize >= sizeof(header) &&
+           header.headerSize <= data.size() &&
+           header.headerVersion == VK_PIPELINE_CACHE_HEADER_VERSION_ONE &&
+           header.vendorID == properties.vendorID &&
+           header.deviceID == properties.deviceID &&
+           std::equal(std::begin(header.pipelineCacheUUID),
+                      std::end(header.pipelineCacheUUID),
+                      std::begin(properties.pipelineCacheUUID));
+};
+
+VkPipelineCache vki::PipelineCache::getVkPipelineCache() const {
+    return vkPipelineCache;
+};
+
+std::vector<uint8_t> vki::PipelineCache::getData() const {
+    std::size_t size = 0;
+    VkResult result =
+        vkGetPipelineCacheData(device, vkPipelineCache, &size, nullptr);
+    vki::assertSuccess(result, "vkGetPipelineCacheData");
+    std::vector<uint8_t> data(size);
+    result = vkGetPipelineCacheData(device, vkPipelineCache, &size,
+                                    data.data());
+    vki::assertSuccess(result, "vkGetPipelineCacheData");
+    data.resize(size);
+    return data;
+};
+
+void vki::PipelineCache::merge(
+    const std::span<const VkPipelineCache> &sources) {
+    if (sources.empty()) return;
+    VkResult result = vkMergePipelineCaches(
+        device, vkPipelineCache, static_cast<uint32_t>(sources.size()),
+        sources.data());
+    vki::assertSuccess(result, "vkMergePipelineCaches");
+};
@@ -0,0 +1,35 @@
+#pragma once
+
+#include <vulkan/vulkan_core.h>
+
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace vki {
+class LogicalDevice;
+class PhysicalDevice;
+class PipelineCache {
+    VkPipelineCache vkPipelineCache;
+    VkDevice device;
+
+public:
+    // Initial data written for another driver or device is ignored, so the
+    // cache then starts empty.
+    explicit PipelineCache(const vki::LogicalDevice &logicalDevice,
+                           const vki::PhysicalDevice &physicalDevice,
+                           const std::span<const uint8_t> &initialData = {});
+    PipelineCache(const PipelineCache &other) = delete;
+    PipelineCache &operator=(const PipelineCache &other) = delete;
+    ~PipelineCache();
+
+    // Checks the header against the device's vendor, device and cache UUID.
+    static bool isCompatible(const vki::PhysicalDevice &physicalDevice,
+                             const std::span<const uint8_t> &data);
+
+    VkPipelineCache getVkPipelineCache() const;
+    std::vector<uint8_t> getData() const;
+    // Folds caches filled on other threads into this one.
+    void merge(const std::span<const VkPipelineCache> &sources);
+};
+};  // namespace vki
@@ -2,6 +2,8 @@
 
 #include <vulkan/vulkan_core.h>
 
+#include <type_traits>
+
 namespace vki {
 class LogicalDevice;
 class PipelineLayout {
@@ -16,4 +18,19 @@ public:
                             const VkPipelineLayoutCreateInfo &createInfo);
     ~PipelineLayout();
 };
+
+// A non-owning view of a pipeline layout, which copies only the handle.
+class PipelineLayoutRef {
+    VkPipelineLayout vkPipelineLayout = VK_NULL_HANDLE;
+
+public:
+    PipelineLayoutRef() = default;
+    PipelineLayoutRef(const vki::PipelineLayout &pipelineLayout)
+        : vkPipelineLayout{ pipelineLayout.getVkPipelineLayout() } {};
+    PipelineLayoutRef(const vki::PipelineLayout &&pipelineLayout) = delete;
+    inline VkPipelineLayout getVkPipelineLayout() const {
+        return vkPipelineLayout;
+    };
+};
+static_assert(std::is_trivially_copyable_v<PipelineLayoutRef>);
 };  // namespace vki
@@ -0,0 +1,32 @@
+#include "./query_pool.hpp"
+
+#include <vulkan/vulkan_core.h>
+
+#include <cstdint>
+#include <span>
+
+#include "vulkan_app/vki/base.hpp"
+#include "vulkan_app/vki/logical_device.hpp"
+
+vki::QueryPool::QueryPool(const vki::LogicalDevice &logicalDevice,
+                          const VkQueryPoolCreateInfo &createInfo)
+    : device{ logicalDevice.getVkDevice() } {
+    VkResult result =
+        vkCreateQueryPool(device, &createInfo, nullptr, &queryPool);
+    vki::assertSuccess(result, "vkCreateQueryPool");
+};
+
+bool vki::QueryPool::getResults(const uint32_t &firstQuery,
+                                const std::span<uint64_t> &results) const {
+    VkResult result = vkGetQueryPoolResults(
+        device, queryPool, firstQuery, static_cast<uint32_t>(results.size()),
+        results.size_bytes(), results.data(), sizeof(uint64_t),
+        VK_QUERY_RESULT_64_BIT);
+    if (result == VK_NOT_READY) return false;
+    vki::assertSuccess(result, "vkGetQueryPoolResults");
+    return true;
+};
+
+vki::QueryPool::~QueryPool() {
+    vkDestroyQueryPool(device, queryPool, nullptr);
+};
@@ -0,0 +1,26 @@
+#pragma once
+
+#include <vulkan/vulkan_core.h>
+
+#include <cstdint>
+#include <span>
+
+namespace vki {
+class LogicalDevice;
+class QueryPool {
+    VkQueryPool queryPool;
+    VkDevice device;
+
+public:
+    explicit QueryPool(const vki::LogicalDevice &logicalDevice,
+                       const VkQueryPoolCreateInfo &createInfo);
+    QueryPool(const QueryPool &) = delete;
+    QueryPool(const QueryPool &&) = delete;
+    inline const VkQueryPool getVkQueryPool() const { return queryPool; };
+    // One 64-bit result per query, starting at firstQuery. Returns false
+    // without waiting if any of them is not available yet.
+    bool getResults(const uint32_t &firstQuery,
+                    const std::span<uint64_t> &results) const;
+    ~QueryPool();
+};
+};  // namespace vki
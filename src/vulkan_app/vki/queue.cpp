@@ -2,29 +2,36 @@
 
 #include <vulkan/vulkan_core.h>
 
+#include <cstdint>
 #include <optional>
-#include <ranges>
-#include <vector>
+#include <span>
 
 #include "./base.hpp"
 #include "./fence.hpp"
+#include "vulkan_app/vki/static_vector.hpp"
 #include "vulkan_app/vki/structs.hpp"
 
 void vki::GraphicsQueueMixin::submit(
-    const std::vector<vki::SubmitInfo> &infoArray,
+    const std::span<const vki::SubmitInfo> &infoArray,
     const std::optional<const vki::Fence *> &fence) const {
-    const auto &finalInfo = infoArray |
-                            std::views::transform([](const auto &info) {
-                                return info.getVkSubmitInfo();
-                            }) |
-                            std::ranges::to<std::vector>();
+    StaticVector<VkSubmitInfo, maxSubmitInfos> finalInfo;
+    for (const auto &info : infoArray) {
+        finalInfo.push_back(info.getVkSubmitInfo());
+    };
     VkResult result = vkQueueSubmit(
-        getVkQueue(), finalInfo.size(), finalInfo.data(),
+        getVkQueue(), static_cast<uint32_t>(finalInfo.size()),
+        finalInfo.data(),
         fence.transform([](const auto &f) { return f->getVkFence(); })
             .value_or(nullptr));
     vki::assertSuccess(result, "vkQueueSubmit");
 };
 
+void vki::GraphicsQueueMixin::submit(
+    const vki::SubmitInfo &submitInfo,
+    const std::optional<const vki::Fence *> &fence) const {
+    submit(std::span(&submitInfo, 1), fence);
+};
+
 void vki::PresentQueueMixin::present(
     const vki::PresentInfo &presentInfo) const {
     const auto &finalInfo = presentInfo.getVkPresentInfo();
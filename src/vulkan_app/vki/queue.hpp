@@ -2,9 +2,10 @@
 
 #include <vulkan/vulkan_core.h>
 
+#include <cstddef>
 #include <optional>
+#include <span>
 #include <type_traits>
-#include <vector>
 
 #include "./fence.hpp"
 #include "vulkan_app/vki/queue_family.hpp"
@@ -22,7 +23,11 @@ public:
 
 class GraphicsQueueMixin : public BaseQueue {
 public:
-    void submit(const std::vector<vki::SubmitInfo> &submitInfos,
+    static constexpr std::size_t maxSubmitInfos = 8;
+
+    void submit(const std::span<const vki::SubmitInfo> &submitInfos,
+                const std::optional<const vki::Fence *> &fence) const;
+    void submit(const vki::SubmitInfo &submitInfo,
                 const std::optional<const vki::Fence *> &fence) const;
 };
 
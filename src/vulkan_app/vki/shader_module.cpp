@@ -3,18 +3,18 @@
 #include <vulkan/vulkan_core.h>
 
 #include <cstdint>
-#include <vector>
+#include <span>
 
 #include "vulkan_app/vki/base.hpp"
 #include "vulkan_app/vki/logical_device.hpp"
 
 vki::ShaderModule::ShaderModule(const vki::LogicalDevice &logicalDevice,
-                                const std::vector<char> &code)
+                                const std::span<const uint32_t> &code)
     : device{ logicalDevice.getVkDevice() } {
     VkShaderModuleCreateInfo createInfo = {
         .sType = VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO,
-        .codeSize = code.size(),
-        .pCode = reinterpret_cast<const uint32_t *>(code.data()),
+        .codeSize = code.size_bytes(),
+        .pCode = code.data(),
     };
     VkResult result = vkCreateShaderModule(
         logicalDevice.getVkDevice(), &createInfo, nullptr, &vkShaderModule);
@@ -2,7 +2,8 @@
 
 #include <vulkan/vulkan_core.h>
 
-#include <vector>
+#include <cstdint>
+#include <span>
 
 namespace vki {
 class LogicalDevice;
@@ -13,7 +14,7 @@ class ShaderModule {
 public:
     VkShaderModule getVkShaderModule() const;
     explicit ShaderModule(const vki::LogicalDevice &logicalDevice,
-                          const std::vector<char> &code);
+                          const std::span<const uint32_t> &code);
     ~ShaderModule();
 };
 };  // namespace vki
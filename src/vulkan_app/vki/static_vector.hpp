@@ -0,0 +1,47 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <format>
+#include <initializer_list>
+#include <span>
+#include <stdexcept>
+
+namespace vki {
+// A vector of at most Capacity items stored inline, for the short arrays
+// passed to Vulkan commands, so that building them never allocates.
+template <typename T, std::size_t Capacity>
+class StaticVector {
+    std::array<T, Capacity> items{};
+    std::size_t count = 0;
+
+public:
+    StaticVector() = default;
+    StaticVector(std::initializer_list<T> initialItems) {
+        for (const auto &item : initialItems) {
+            push_back(item);
+        };
+    };
+
+    void push_back(const T &item) {
+        if (count == Capacity) {
+            throw std::length_error(
+                std::format("StaticVector holds at most {} items", Capacity));
+        };
+        items[count++] = item;
+    };
+    std::size_t size() const { return count; };
+    bool empty() const { return count == 0; };
+    T *data() { return items.data(); };
+    const T *data() const { return items.data(); };
+    T *begin() { return items.data(); };
+    const T *begin() const { return items.data(); };
+    T *end() { return items.data() + count; };
+    const T *end() const { return items.data() + count; };
+    T &operator[](const std::size_t &index) { return items[index]; };
+    const T &operator[](const std::size_t &index) const {
+        return items[index];
+    };
+    operator std::span<const T>() const { return { items.data(), count }; };
+};
+};  // namespace vki
@@ -3,21 +3,16 @@
 #include <vulkan/vulkan_core.h>
 
 #include <cstdint>
-#include <ranges>
-#include <utility>
-#include <vector>
 
 vki::PresentInfo::PresentInfo(const PresentInfoInputData &&data)
-    : waitSemaphores{ data.waitSemaphores |
-                      std::views::transform([](const auto &semaphore) {
-                          return semaphore->getVkSemaphore();
-                      }) |
-                      std::ranges::to<std::vector>() },
-      swapchains{ data.swapchains | std::views::transform([](const auto &s) {
-                      return s->getVkSwapchain();
-                  }) |
-                  std::ranges::to<std::vector>() },
-      imageIndices{ std::move(data.imageIndices) } {};
+    : imageIndices{ data.imageIndices } {
+    for (const auto &semaphore : data.waitSemaphores) {
+        waitSemaphores.push_back(semaphore->getVkSemaphore());
+    };
+    for (const auto &swapchain : data.swapchains) {
+        swapchains.push_back(swapchain->getVkSwapchain());
+    };
+};
 
 const VkPresentInfoKHR vki::PresentInfo::getVkPresentInfo() const {
     return { .sType = VK_STRUCTURE_TYPE_PRESENT_INFO_KHR,
@@ -29,22 +24,17 @@ const VkPresentInfoKHR vki::PresentInfo::getVkPresentInfo() const {
 };
 
 vki::SubmitInfo::SubmitInfo(const SubmitInfoInputData &&data)
-    : waitSemaphores{ data.waitSemaphores |
-                      std::views::transform([](const auto &semaphore) {
-                          return semaphore->getVkSemaphore();
-                      }) |
-                      std::ranges::to<std::vector>() },
-      signalSemaphores{ data.signalSemaphores |
-                        std::views::transform([](const auto &semaphore) {
-                            return semaphore->getVkSemaphore();
-                        }) |
-                        std::ranges::to<std::vector>() },
-      commandBuffers{ data.commandBuffers |
-                      std::views::transform([](const auto &b) {
-                          return b->getVkCommandBuffer();
-                      }) |
-                      std::ranges::to<std::vector>() },
-      waitStages{ std::move(data.waitStages) } {};
+    : waitStages{ data.waitStages } {
+    for (const auto &semaphore : data.waitSemaphores) {
+        waitSemaphores.push_back(semaphore->getVkSemaphore());
+    };
+    for (const auto &semaphore : data.signalSemaphores) {
+        signalSemaphores.push_back(semaphore->getVkSemaphore());
+    };
+    for (const auto &commandBuffer : data.commandBuffers) {
+        commandBuffers.push_back(commandBuffer->getVkCommandBuffer());
+    };
+};
 
 const VkSubmitInfo vki::SubmitInfo::getVkSubmitInfo() const {
     return { .sType = VK_STRUCTURE_TYPE_SUBMIT_INFO,
@@ -57,4 +47,3 @@ const VkSubmitInfo vki::SubmitInfo::getVkSubmitInfo() const {
                  static_cast<uint32_t>(signalSemaphores.size()),
              .pSignalSemaphores = signalSemaphores.data() };
 };
-
@@ -3,43 +3,50 @@
 #include <vulkan/vulkan_core.h>
 
 #include <array>
+#include <cstddef>
 #include <cstdint>
 #include <unordered_set>
-#include <vector>
 
 #include "vulkan_app/vki/command_buffer.hpp"
 #include "vulkan_app/vki/queue_family.hpp"
 #include "vulkan_app/vki/semaphore.hpp"
+#include "vulkan_app/vki/static_vector.hpp"
 #include "vulkan_app/vki/swapchain.hpp"
 namespace vki {
 
+inline constexpr std::size_t maxSubmitSemaphores = 4;
+inline constexpr std::size_t maxSubmitCommandBuffers = 4;
+inline constexpr std::size_t maxPresentSwapchains = 4;
+
 struct SubmitInfoInputData {
-    std::vector<const vki::Semaphore *> waitSemaphores;
-    std::vector<const vki::Semaphore *> signalSemaphores;
-    std::vector<const vki::CommandBuffer *> commandBuffers;
-    std::vector<VkPipelineStageFlags> waitStages;
+    StaticVector<const vki::Semaphore *, maxSubmitSemaphores> waitSemaphores;
+    StaticVector<const vki::Semaphore *, maxSubmitSemaphores>
+        signalSemaphores;
+    StaticVector<const vki::CommandBuffer *, maxSubmitCommandBuffers>
+        commandBuffers;
+    StaticVector<VkPipelineStageFlags, maxSubmitSemaphores> waitStages;
 };
 
 struct SubmitInfo {
-    std::vector<VkPipelineStageFlags> waitStages;
-    std::vector<VkSemaphore> waitSemaphores;
-    std::vector<VkSemaphore> signalSemaphores;
-    std::vector<VkCommandBuffer> commandBuffers;
+    StaticVector<VkPipelineStageFlags, maxSubmitSemaphores> waitStages;
+    StaticVector<VkSemaphore, maxSubmitSemaphores> waitSemaphores;
+    StaticVector<VkSemaphore, maxSubmitSemaphores> signalSemaphores;
+    StaticVector<VkCommandBuffer, maxSubmitCommandBuffers> commandBuffers;
 
     explicit SubmitInfo(const SubmitInfoInputData &&data);
     const VkSubmitInfo getVkSubmitInfo() const;
 };
 
 struct PresentInfoInputData {
-    std::vector<const vki::Semaphore *> waitSemaphores;
-    std::vector<const vki::Swapchain *> swapchains;
-    std::vector<uint32_t> imageIndices;
+    StaticVector<const vki::Semaphore *, maxSubmitSemaphores> waitSemaphores;
+    StaticVector<const vki::Swapchain *, maxPresentSwapchains> swapchains;
+    StaticVector<uint32_t, maxPresentSwapchains> imageIndices;
 };
 
 struct PresentInfo {
-    std::vector<VkSemaphore> waitSemaphores;
-    std::vector<VkSwapchainKHR> swapchains;
-    std::vector<uint32_t> imageIndices;
+    StaticVector<VkSemaphore, maxSubmitSemaphores> waitSemaphores;
+    StaticVector<VkSwapchainKHR, maxPresentSwapchains> swapchains;
+    StaticVector<uint32_t, maxPresentSwapchains> imageIndices;
 
     explicit PresentInfo(const PresentInfoInputData &&data);
     const VkPresentInfoKHR getVkPresentInfo() const;
@@ -77,11 +77,12 @@ vki::Swapchain::Swapchain(const vki::LogicalDevice &logicalDevice,
     result = vkGetSwapchainImagesKHR(logicalDevice.getVkDevice(), vkSwapchain,
                                      &imagesCount, nullptr);
     assertSuccess(result, "vkGetSwapchainImagesKHR");
-    std::vector<VkImage> images(imagesCount);
+    swapChainImages.resize(imagesCount);
     result = vkGetSwapchainImagesKHR(logicalDevice.getVkDevice(), vkSwapchain,
-                                     &imagesCount, images.data());
+                                     &imagesCount, swapChainImages.data());
     assertSuccess(result, "vkGetSwapchainImagesKHR");
-    createImageViews(logicalDevice, vkCreateInfo.imageFormat, images);
+    createImageViews(logicalDevice, vkCreateInfo.imageFormat,
+                     swapChainImages);
 };
 
 void vki::Swapchain::createImageViews(const vki::LogicalDevice &logicalDevice,
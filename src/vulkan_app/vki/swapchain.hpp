@@ -80,6 +80,7 @@ class Swapchain {
                           const std::vector<VkImage> &images);
 
 public:
+    std::vector<VkImage> swapChainImages;
     std::vector<vki::ImageView> swapChainImageViews;
     explicit Swapchain(const vki::LogicalDevice &logicalDevice,
                        const vki::SwapchainCreateInfo &createInfo);
@@ -0,0 +1,187 @@
+// clang-format off
+#define ELPP_STL_LOGGING
+#include "easylogging++.h"
+#include "app.hpp"
+// clang-format on
+
+#include <vulkan/vulkan_core.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <exception>
+#include <iostream>
+#include <new>
+#include <span>
+#include <string_view>
+
+#include "vulkan_app/app/frame_arena.hpp"
+#include "vulkan_app/vki/static_vector.hpp"
+#include "vulkan_app/vki/structs.hpp"
+
+INITIALIZE_EASYLOGGINGPP
+
+// Checks that recording and submitting a frame stops allocating once it
+// has warmed up, by counting every global operator new on the thread that
+// draws.
+
+namespace {
+// Tells CTest that the test could not run.
+constexpr int skipCode = 77;
+constexpr uint32_t warmUpFrames = 32;
+constexpr uint32_t measuredFrames = 64;
+
+thread_local std::size_t allocationCount = 0;
+
+template <typename Func>
+std::size_t countAllocations(Func &&func) {
+    const auto before = allocationCount;
+    func();
+    return allocationCount - before;
+};
+
+bool expectNoAllocations(const std::string_view &name,
+                         const std::size_t &count) {
+    if (count != 0) {
+        std::cerr << name << ": " << count << " allocations" << std::endl;
+        return false;
+    };
+    std::cout << name << ": no allocations" << std::endl;
+    return true;
+};
+
+bool checkFrameArena() {
+    FrameArena arena(64);
+    const auto &frame = [&]() {
+        arena.reset();
+        arena.allocate<VkImageMemoryBarrier2>(4);
+        arena.allocate<uint32_t>(100);
+    };
+    // The first frame overflows the block, which the next reset grows.
+    frame();
+    frame();
+    return expectNoAllocations("FrameArena", countAllocations([&]() {
+                                   for (uint32_t i = 0; i < measuredFrames;
+                                        i++) {
+                                       frame();
+                                   };
+                               }));
+};
+
+bool checkStaticVector() {
+    return expectNoAllocations("StaticVector", countAllocations([]() {
+                                   vki::StaticVector<uint32_t, 8> items = {
+                                       1, 2, 3
+                                   };
+                                   items.push_back(4);
+                                   const std::span<const uint32_t> view =
+                                       items;
+                                   if (view.size() != 4) std::abort();
+                               }));
+};
+
+// Semaphores, command buffers and swapchains need a device, so the
+// draw-frame test covers those.
+bool checkSubmitAndPresentInfo() {
+    return expectNoAllocations(
+        "SubmitInfo and PresentInfo", countAllocations([]() {
+            const vki::SubmitInfo submitInfo(
+                { .waitStages = {
+                      VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT } });
+            const vki::PresentInfo presentInfo({ .imageIndices = { 0 } });
+            submitInfo.getVkSubmitInfo();
+            presentInfo.getVkPresentInfo();
+        }));
+};
+
+// drawFrame records the render graph's barriers into the frame arena,
+// builds the submit and present infos, and records streamed texture uploads
+// and occlusion culling.
+int checkDrawFrame() {
+    uint32_t drawnFrames = 0;
+    std::size_t before = 0;
+    std::size_t allocations = 0;
+    const AppOptions options = {
+        // The validation layer allocates on the drawing thread.
+        .enableValidation = false,
+        .frameLimit = warmUpFrames + measuredFrames,
+        .beforeDrawFrame = [&]() { before = allocationCount; },
+        .afterDrawFrame =
+            [&]() {
+                if (drawnFrames++ >= warmUpFrames) {
+                    allocations += allocationCount - before;
+                };
+            },
+    };
+    try {
+        run_app(options);
+    } catch (const std::exception &error) {
+        if (drawnFrames == 0) {
+            std::cout << "Skipped, no frame was drawn: " << error.what()
+                      << std::endl;
+            return skipCode;
+        };
+        throw;
+    };
+    if (drawnFrames < warmUpFrames + measuredFrames) {
+        std::cout << "Skipped, the window closed after " << drawnFrames
+                  << " frames" << std::endl;
+        return skipCode;
+    };
+    return expectNoAllocations("drawFrame", allocations) ? EXIT_SUCCESS
+                                                         : EXIT_FAILURE;
+};
+};  // namespace
+
+void *operator new(std::size_t size) {
+    allocationCount++;
+    if (void *pointer = std::malloc(size == 0 ? 1 : size)) {
+        return pointer;
+    };
+    throw std::bad_alloc();
+};
+
+void *operator new(std::size_t size, std::align_val_t alignment) {
+    allocationCount++;
+    const auto &align = static_cast<std::size_t>(alignment);
+    // aligned_alloc takes whole multiples of the alignment.
+    const auto &alignedSize = (size + align - 1) / align * align;
+    if (void *pointer = std::aligned_alloc(align, alignedSize == 0
+                                                      ? align
+                                                      : alignedSize)) {
+        return pointer;
+    };
+    throw std::bad_alloc();
+};
+
+void operator delete(void *pointer) noexcept { std::free(pointer); };
+
+void operator delete(void *pointer, std::size_t) noexcept {
+    std::free(pointer);
+};
+
+void operator delete(void *pointer, std::align_val_t) noexcept {
+    std::free(pointer);
+};
+
+void operator delete(void *pointer, std::size_t, std::align_val_t) noexcept {
+    std::free(pointer);
+};
+
+int main(int argc, char **argv) {
+    const std::string_view mode = argc > 1 ? argv[1] : "";
+    if (mode == "host") {
+        // Every check runs, so that one failure does not hide another.
+        const bool isArenaFree = checkFrameArena();
+        const bool isStaticVectorFree = checkStaticVector();
+        const bool isSubmitFree = checkSubmitAndPresentInfo();
+        return isArenaFree && isStaticVectorFree && isSubmitFree
+                   ? EXIT_SUCCESS
+                   : EXIT_FAILURE;
+    };
+    if (mode == "draw-frame") {
+        return checkDrawFrame();
+    };
+    std::cerr << "Usage: " << argv[0] << " host|draw-frame" << std::endl;
+    return EXIT_FAILURE;
+};
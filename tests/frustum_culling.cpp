@@ -0,0 +1,119 @@
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <span>
+#include <vector>
+
+#include "glm/ext/vector_float3.hpp"
+#include "glm/ext/vector_float4.hpp"
+#include "glm/geometric.hpp"
+#include "vulkan_app/app/bounds.hpp"
+#include "vulkan_app/app/frustum_culler.hpp"
+
+// Checks that the frustum culler keeps exactly the shapes whose spheres and
+// boxes are both inside the frustum, and that it culls 100k shapes in under
+// a millisecond. Unoptimized builds only report the time.
+
+namespace {
+constexpr uint32_t shapeCount = 100'000;
+constexpr uint32_t timedRuns = 50;
+constexpr double budgetMilliseconds = 1.0;
+
+// Boxes stretched along one axis, so that their spheres reach well past
+// them, scattered around a camera at the origin.
+ShapeBounds createShapes() {
+    std::mt19937 random(1);
+    std::uniform_real_distribution<float> position(-120.0f, 120.0f);
+    std::uniform_real_distribution<float> size(0.1f, 1.0f);
+    std::uniform_int_distribution<int> axis(0, 2);
+    ShapeBounds bounds;
+    for (uint32_t i = 0; i < shapeCount; i++) {
+        const glm::vec3 center = { position(random), position(random),
+                                   position(random) };
+        glm::vec3 halfExtent = glm::vec3(size(random));
+        halfExtent[axis(random)] *= 8.0f;
+        const AABB box = { .min = center - halfExtent,
+                           .max = center + halfExtent };
+        bounds.push({ .center = center, .radius = glm::length(halfExtent) },
+                    box);
+    };
+    return bounds;
+};
+
+// A 90 degree view down -z from the origin, between 0.1 and 100.
+Frustum createFrustum() {
+    const float diagonal = 1.0f / std::sqrt(2.0f);
+    return { .planes = {
+                 glm::vec4(diagonal, 0.0f, -diagonal, 0.0f),
+                 glm::vec4(-diagonal, 0.0f, -diagonal, 0.0f),
+                 glm::vec4(0.0f, diagonal, -diagonal, 0.0f),
+                 glm::vec4(0.0f, -diagonal, -diagonal, 0.0f),
+                 glm::vec4(0.0f, 0.0f, -1.0f, -0.1f),
+                 glm::vec4(0.0f, 0.0f, 1.0f, 100.0f),
+             } };
+};
+
+bool isVisible(const ShapeBounds &bounds, const Frustum &frustum,
+               const uint32_t &shape) {
+    const auto &sphere = bounds.getSphere(shape);
+    const auto &box = bounds.getAABB(shape);
+    for (const auto &plane : frustum.planes) {
+        const glm::vec3 normal = glm::vec3(plane);
+        if (glm::dot(normal, sphere.center) + plane.w < -sphere.radius) {
+            return false;
+        };
+        const glm::vec3 positive = {
+            plane.x >= 0.0f ? box.max.x : box.min.x,
+            plane.y >= 0.0f ? box.max.y : box.min.y,
+            plane.z >= 0.0f ? box.max.z : box.min.z,
+        };
+        if (glm::dot(normal, positive) + plane.w < 0.0f) return false;
+    };
+    return true;
+};
+
+bool checkVisibleShapes(const ShapeBounds &bounds, const Frustum &frustum,
+                        const std::span<const uint32_t> &visible) {
+    std::vector<uint32_t> expected;
+    for (uint32_t shape = 0; shape < shapeCount; shape++) {
+        if (isVisible(bounds, frustum, shape)) expected.push_back(shape);
+    };
+    if (!std::equal(visible.begin(), visible.end(), expected.begin(),
+                    expected.end())) {
+        std::cerr << "Culled " << visible.size() << " visible shapes, expected "
+                  << expected.size() << std::endl;
+        return false;
+    };
+    std::cout << visible.size() << " of " << shapeCount
+              << " shapes are visible" << std::endl;
+    return true;
+};
+};  // namespace
+
+int main() {
+    const auto &bounds = createShapes();
+    const auto &frustum = createFrustum();
+    FrustumCuller culler;
+    if (!checkVisibleShapes(bounds, frustum, culler.cull(bounds, frustum))) {
+        return EXIT_FAILURE;
+    };
+    auto fastest = std::chrono::steady_clock::duration::max();
+    for (uint32_t run = 0; run < timedRuns; run++) {
+        const auto &start = std::chrono::steady_clock::now();
+        culler.cull(bounds, frustum);
+        fastest = std::min(fastest, std::chrono::steady_clock::now() - start);
+    };
+    const double milliseconds =
+        std::chrono::duration<double, std::milli>(fastest).count();
+    std::cout << "Culled " << shapeCount << " shapes in " << milliseconds
+              << " ms" << std::endl;
+#ifdef NDEBUG
+    return milliseconds < budgetMilliseconds ? EXIT_SUCCESS : EXIT_FAILURE;
+#else
+    return EXIT_SUCCESS;
+#endif
+};
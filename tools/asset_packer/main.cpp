@@ -0,0 +1,53 @@
+#include <cstdint>
+#include <exception>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "vulkan_app/app/asset_pack.hpp"
+
+namespace {
+std::vector<uint8_t> readFile(const std::filesystem::path &path) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file) {
+        throw std::runtime_error("Failed to open " + path.string());
+    };
+    return std::vector<uint8_t>(std::istreambuf_iterator<char>(file), {});
+};
+
+void writeFile(const std::filesystem::path &path,
+               const std::vector<uint8_t> &data) {
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    file.write(reinterpret_cast<const char *>(data.data()), data.size());
+    if (!file) {
+        throw std::runtime_error("Failed to write " + path.string());
+    };
+};
+};  // namespace
+
+// Assets are named after their file name.
+int main(int argc, char **argv) {
+    if (argc < 2) {
+        std::cerr << "Usage: asset_packer <output.pack> [inputs...]"
+                  << std::endl;
+        return 1;
+    };
+    try {
+        std::vector<AssetPackInput> assets;
+        for (int i = 2; i < argc; i++) {
+            const std::filesystem::path path = argv[i];
+            assets.push_back({ .name = path.filename().string(),
+                               .data = readFile(path) });
+        };
+        writeFile(argv[1], write_asset_pack(std::move(assets)));
+    } catch (const std::exception &error) {
+        std::cerr << error.what() << std::endl;
+        return 1;
+    };
+    return 0;
+};
@@ -0,0 +1,260 @@
+#include "./bc_encoder.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <utility>
+#include <vector>
+
+namespace {
+using Color = std::array<float, 4>;
+
+constexpr std::array<uint32_t, 16> bc7Weights = {
+    0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64
+};
+
+class BitWriter {
+    std::array<uint8_t, 16> bytes{};
+    unsigned int position = 0;
+
+public:
+    void write(const uint32_t &value, const unsigned int &bitCount) {
+        for (unsigned int i = 0; i < bitCount; i++) {
+            bytes[position >> 3] |= ((value >> i) & 1) << (position & 7);
+            position++;
+        };
+    };
+
+    inline const std::array<uint8_t, 16> &getBytes() const { return bytes; };
+};
+
+Color pixelAt(const PixelBlock &pixels, const unsigned int &index) {
+    return { static_cast<float>(pixels[index * 4]),
+             static_cast<float>(pixels[index * 4 + 1]),
+             static_cast<float>(pixels[index * 4 + 2]),
+             static_cast<float>(pixels[index * 4 + 3]) };
+};
+
+// Fits a line through the block colors and returns its extreme points, so
+// the endpoints span the direction of greatest variance.
+std::pair<Color, Color> principalEndpoints(const PixelBlock &pixels,
+                                           const unsigned int &channels) {
+    Color mean = {};
+    for (unsigned int i = 0; i < 16; i++) {
+        const auto &pixel = pixelAt(pixels, i);
+        for (unsigned int c = 0; c < channels; c++) mean[c] += pixel[c] / 16;
+    };
+    std::array<std::array<float, 4>, 4> covariance = {};
+    for (unsigned int i = 0; i < 16; i++) {
+        const auto &pixel = pixelAt(pixels, i);
+        for (unsigned int a = 0; a < channels; a++) {
+            for (unsigned int b = 0; b < channels; b++) {
+                covariance[a][b] += (pixel[a] - mean[a]) * (pixel[b] - mean[b]);
+            };
+        };
+    };
+    Color axis = { 1.0f, 1.0f, 1.0f, 1.0f };
+    for (unsigned int iteration = 0; iteration < 8; iteration++) {
+        Color next = {};
+        for (unsigned int a = 0; a < channels; a++) {
+            for (unsigned int b = 0; b < channels; b++) {
+                next[a] += covariance[a][b] * axis[b];
+            };
+        };
+        float length = 0.0f;
+        for (unsigned int c = 0; c < channels; c++) length += next[c] * next[c];
+        if (length <= 0.0f) break;
+        length = std::sqrt(length);
+        for (unsigned int c = 0; c < channels; c++) axis[c] = next[c] / length;
+    };
+    float minProjection = std::numeric_limits<float>::max();
+    float maxProjection = std::numeric_limits<float>::lowest();
+    for (unsigned int i = 0; i < 16; i++) {
+        const auto &pixel = pixelAt(pixels, i);
+        float projection = 0.0f;
+        for (unsigned int c = 0; c < channels; c++) {
+            projection += (pixel[c] - mean[c]) * axis[c];
+        };
+        minProjection = std::min(minProjection, projection);
+        maxProjection = std::max(maxProjection, projection);
+    };
+    Color low = {};
+    Color high = {};
+    for (unsigned int c = 0; c < channels; c++) {
+        low[c] = std::clamp(mean[c] + minProjection * axis[c], 0.0f, 255.0f);
+        high[c] = std::clamp(mean[c] + maxProjection * axis[c], 0.0f, 255.0f);
+    };
+    return { low, high };
+};
+
+template <std::size_t N>
+unsigned int nearestIndex(const std::array<Color, N> &palette,
+                          const Color &pixel, const unsigned int &channels) {
+    unsigned int best = 0;
+    float bestError = std::numeric_limits<float>::max();
+    for (unsigned int i = 0; i < N; i++) {
+        float error = 0.0f;
+        for (unsigned int c = 0; c < channels; c++) {
+            const float difference = palette[i][c] - pixel[c];
+            error += difference * difference;
+        };
+        if (error < bestError) {
+            bestError = error;
+            best = i;
+        };
+    };
+    return best;
+};
+
+uint16_t toRGB565(const Color &color) {
+    const auto &quantize = [](const float &value, const unsigned int &max) {
+        return static_cast<uint16_t>(std::lround(value * max / 255.0f));
+    };
+    return (quantize(color[0], 31) << 11) | (quantize(color[1], 63) << 5) |
+           quantize(color[2], 31);
+};
+
+Color fromRGB565(const uint16_t &packed) {
+    const unsigned int r = (packed >> 11) & 31;
+    const unsigned int g = (packed >> 5) & 63;
+    const unsigned int b = packed & 31;
+    return { static_cast<float>((r << 3) | (r >> 2)),
+             static_cast<float>((g << 2) | (g >> 4)),
+             static_cast<float>((b << 3) | (b >> 2)), 255.0f };
+};
+
+// Picks the 7-bit endpoint and shared p-bit closest to the color.
+std::pair<std::array<uint32_t, 4>, uint32_t> quantizeBC7Endpoint(
+    const Color &color) {
+    std::array<uint32_t, 4> bestEndpoint = {};
+    uint32_t bestPBit = 0;
+    float bestError = std::numeric_limits<float>::max();
+    for (uint32_t pBit = 0; pBit < 2; pBit++) {
+        std::array<uint32_t, 4> endpoint;
+        float error = 0.0f;
+        for (unsigned int c = 0; c < 4; c++) {
+            endpoint[c] = static_cast<uint32_t>(
+                std::clamp(std::lround((color[c] - pBit) / 2.0f), 0l, 127l));
+            const float difference =
+                static_cast<float>((endpoint[c] << 1) | pBit) - color[c];
+            error += difference * difference;
+        };
+        if (error < bestError) {
+            bestError = error;
+            bestEndpoint = endpoint;
+            bestPBit = pBit;
+        };
+    };
+    return { bestEndpoint, bestPBit };
+};
+
+template <typename BlockEncoder>
+std::vector<uint8_t> encodeImage(const std::vector<uint8_t> &rgba,
+                                 const uint32_t &width,
+                                 const uint32_t &height,
+                                 const BlockEncoder &encodeBlock) {
+    const uint32_t blocksX = (width + 3) / 4;
+    const uint32_t blocksY = (height + 3) / 4;
+    std::vector<uint8_t> out;
+    for (uint32_t blockY = 0; blockY < blocksY; blockY++) {
+        for (uint32_t blockX = 0; blockX < blocksX; blockX++) {
+            PixelBlock pixels;
+            for (uint32_t y = 0; y < 4; y++) {
+                for (uint32_t x = 0; x < 4; x++) {
+                    const uint32_t sourceX =
+                        std::min(blockX * 4 + x, width - 1);
+                    const uint32_t sourceY =
+                        std::min(blockY * 4 + y, height - 1);
+                    const auto &source =
+                        rgba.begin() + (sourceY * width + sourceX) * 4;
+                    std::copy(source, source + 4,
+                              pixels.begin() + (y * 4 + x) * 4);
+                };
+            };
+            const auto &block = encodeBlock(pixels);
+            out.insert(out.end(), block.begin(), block.end());
+        };
+    };
+    return out;
+};
+};  // namespace
+
+std::array<uint8_t, 8> encode_bc1_block(const PixelBlock &pixels) {
+    const auto &[low, high] = principalEndpoints(pixels, 3);
+    uint16_t color0 = toRGB565(high);
+    uint16_t color1 = toRGB565(low);
+    // Four-color mode requires color0 > color1.
+    if (color0 < color1) std::swap(color0, color1);
+    uint32_t indices = 0;
+    if (color0 != color1) {
+        const auto &endpoint0 = fromRGB565(color0);
+        const auto &endpoint1 = fromRGB565(color1);
+        std::array<Color, 4> palette = { endpoint0, endpoint1 };
+        for (unsigned int c = 0; c < 3; c++) {
+            palette[2][c] = (2 * endpoint0[c] + endpoint1[c]) / 3;
+            palette[3][c] = (endpoint0[c] + 2 * endpoint1[c]) / 3;
+        };
+        for (unsigned int i = 0; i < 16; i++) {
+            indices |= nearestIndex(palette, pixelAt(pixels, i), 3) << (i * 2);
+        };
+    };
+    return { static_cast<uint8_t>(color0),
+             static_cast<uint8_t>(color0 >> 8),
+             static_cast<uint8_t>(color1),
+             static_cast<uint8_t>(color1 >> 8),
+             static_cast<uint8_t>(indices),
+             static_cast<uint8_t>(indices >> 8),
+             static_cast<uint8_t>(indices >> 16),
+             static_cast<uint8_t>(indices >> 24) };
+};
+
+std::array<uint8_t, 16> encode_bc7_block(const PixelBlock &pixels) {
+    const auto &[low, high] = principalEndpoints(pixels, 4);
+    auto [endpoint0, pBit0] = quantizeBC7Endpoint(low);
+    auto [endpoint1, pBit1] = quantizeBC7Endpoint(high);
+    std::array<Color, 16> palette;
+    for (unsigned int i = 0; i < 16; i++) {
+        for (unsigned int c = 0; c < 4; c++) {
+            const uint32_t value0 = (endpoint0[c] << 1) | pBit0;
+            const uint32_t value1 = (endpoint1[c] << 1) | pBit1;
+            palette[i][c] = static_cast<float>(
+                ((64 - bc7Weights[i]) * value0 + bc7Weights[i] * value1 + 32) >>
+                6);
+        };
+    };
+    std::array<uint32_t, 16> indices;
+    for (unsigned int i = 0; i < 16; i++) {
+        indices[i] = nearestIndex(palette, pixelAt(pixels, i), 4);
+    };
+    // The first index is stored without its top bit, so it must be below 8.
+    if (indices[0] >= 8) {
+        std::swap(endpoint0, endpoint1);
+        std::swap(pBit0, pBit1);
+        for (auto &index : indices) index = 15 - index;
+    };
+    BitWriter writer;
+    writer.write(1 << 6, 7);
+    for (unsigned int c = 0; c < 4; c++) {
+        writer.write(endpoint0[c], 7);
+        writer.write(endpoint1[c], 7);
+    };
+    writer.write(pBit0, 1);
+    writer.write(pBit1, 1);
+    writer.write(indices[0], 3);
+    for (unsigned int i = 1; i < 16; i++) writer.write(indices[i], 4);
+    return writer.getBytes();
+};
+
+std::vector<uint8_t> encode_bc1_image(const std::vector<uint8_t> &rgba,
+                                      const uint32_t &width,
+                                      const uint32_t &height) {
+    return encodeImage(rgba, width, height, encode_bc1_block);
+};
+
+std::vector<uint8_t> encode_bc7_image(const std::vector<uint8_t> &rgba,
+                                      const uint32_t &width,
+                                      const uint32_t &height) {
+    return encodeImage(rgba, width, height, encode_bc7_block);
+};
@@ -0,0 +1,24 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <vector>
+
+// Sixteen RGBA pixels of a 4x4 block in row-major order.
+using PixelBlock = std::array<uint8_t, 64>;
+
+// Opaque BC1 in four-color mode, 8 bytes per block.
+std::array<uint8_t, 8> encode_bc1_block(const PixelBlock &pixels);
+
+// BC7 mode 6 (single subset RGBA with 4-bit indices), 16 bytes per block.
+std::array<uint8_t, 16> encode_bc7_block(const PixelBlock &pixels);
+
+// Encodes a tightly packed RGBA image, replicating the edge pixels into
+// blocks that overhang the image.
+std::vector<uint8_t> encode_bc1_image(const std::vector<uint8_t> &rgba,
+                                      const uint32_t &width,
+                                      const uint32_t &height);
+
+std::vector<uint8_t> encode_bc7_image(const std::vector<uint8_t> &rgba,
+                                      const uint32_t &width,
+                                      const uint32_t &height);
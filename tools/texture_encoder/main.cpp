@@ -0,0 +1,82 @@
+#include <vulkan/vulkan_core.h>
+
+#include <cstdint>
+#include <exception>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "./bc_encoder.hpp"
+#include "vulkan_app/app/image_loaders.hpp"
+#include "vulkan_app/app/ktx2.hpp"
+#include "vulkan_app/app/mip_chain.hpp"
+
+namespace {
+std::vector<uint8_t> readFile(const std::filesystem::path &path) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file) {
+        throw std::runtime_error("Failed to open " + path.string());
+    };
+    return std::vector<uint8_t>(std::istreambuf_iterator<char>(file), {});
+};
+
+void writeFile(const std::filesystem::path &path,
+               const std::vector<uint8_t> &data) {
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    file.write(reinterpret_cast<const char *>(data.data()), data.size());
+    if (!file) {
+        throw std::runtime_error("Failed to write " + path.string());
+    };
+};
+
+void encode(const std::filesystem::path &input,
+            const std::filesystem::path &output, const std::string &format) {
+    const auto &encoded = readFile(input);
+    const auto &header = read_image_header(encoded);
+    std::vector<uint8_t> rgba(header.size());
+    decode_image(encoded, rgba.data(), header.rowPitch());
+    const auto &levels =
+        generate_mip_chain(std::move(rgba), header.width, header.height);
+
+    KTX2Image image = { .width = header.width, .height = header.height };
+    std::vector<std::vector<uint8_t>> blocks;
+    blocks.reserve(levels.size());
+    for (const auto &level : levels) {
+        if (format == "bc1") {
+            image.format = VK_FORMAT_BC1_RGB_SRGB_BLOCK;
+            blocks.push_back(
+                encode_bc1_image(level.rgba, level.width, level.height));
+        } else if (format == "bc7") {
+            image.format = VK_FORMAT_BC7_SRGB_BLOCK;
+            blocks.push_back(
+                encode_bc7_image(level.rgba, level.width, level.height));
+        } else {
+            throw std::runtime_error("Unknown format " + format);
+        };
+        image.levels.push_back(blocks.back());
+    };
+    writeFile(output, write_ktx2(image));
+};
+};  // namespace
+
+int main(int argc, char **argv) {
+    if (argc != 4) {
+        std::cerr << "Usage: texture_encoder <input.jpg|input.png> "
+                     "<output.ktx2> <bc1|bc7>"
+                  << std::endl;
+        return 1;
+    };
+    try {
+        encode(argv[1], argv[2], argv[3]);
+    } catch (const std::exception &error) {
+        std::cerr << error.what() << std::endl;
+        return 1;
+    };
+    return 0;
+};